@@ -0,0 +1,8 @@
+#version 300 es
+precision mediump float;
+out vec4 fragColor;
+
+void main()
+{
+    fragColor = vec4(1, 1, 1, 1);
+}
\ No newline at end of file
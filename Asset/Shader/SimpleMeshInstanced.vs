@@ -0,0 +1,16 @@
+#version 300 es
+
+layout(location = 0) in vec4 vertex;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 uv;
+
+//InstanceTransform rows
+layout(location = 8) in vec4 instanceRow0;
+layout(location = 9) in vec4 instanceRow1;
+layout(location = 10) in vec4 instanceRow2;
+
+void main()
+{
+    vec4 position = vec4(vertex.xyz, 1.0);
+    gl_Position = vec4(dot(instanceRow0, position), dot(instanceRow1, position), dot(instanceRow2, position), 1.0);
+}
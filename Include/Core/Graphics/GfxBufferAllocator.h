@@ -0,0 +1,39 @@
+#pragma once
+#include <map>
+#include <cstdint>
+
+/*
+	Offset allocator for sub allocating one GPU buffer
+	Units are up to the caller (vertices, indices, bytes). Best fit, freed ranges
+	merge with their free neighbours so the buffer does not fragment into slivers.
+*/
+class GfxBufferAllocator
+{
+public:
+	static const uint32_t kInvalidOffset = 0xFFFFFFFF;
+
+private:
+	typedef std::map<uint32_t, uint32_t> OffsetMap;		//offset -> size
+	typedef std::multimap<uint32_t, uint32_t> SizeMap;	//size -> offset
+
+private:
+	uint32_t m_size;
+	uint32_t m_freeSize;
+	OffsetMap m_freeByOffset;
+	SizeMap m_freeBySize;
+
+public:
+	GfxBufferAllocator(uint32_t size);
+
+	//kInvalidOffset when no free range is big enough
+	uint32_t Allocate(uint32_t size);
+	void Free(uint32_t offset, uint32_t size);
+
+	uint32_t GetSize(void) const { return m_size; }
+	uint32_t GetFreeSize(void) const { return m_freeSize; }
+	uint32_t GetFreeBlockCount(void) const { return static_cast<uint32_t>(m_freeByOffset.size()); }
+
+private:
+	void AddFreeBlock(uint32_t offset, uint32_t size);
+	void RemoveFreeBlock(OffsetMap::iterator block);
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include "Core\Graphics\GfxResourceTable.h"
 
 /*
 	ͼAPI
@@ -6,6 +7,9 @@
 
 class Mesh;
 class Material;
+class RenderQueue;
+struct InstanceTransform;
+class Shader;
 
 class GfxDevice
 {
@@ -17,5 +21,19 @@ public:
 	//swap double buffer
 	virtual void SwapBuffer(void) = 0;
 
-	virtual void DrawMesh(const Mesh &mesh, const Material& material) = 0;
+	//lod picks the index range, see Mesh::GetLOD
+	virtual void DrawMesh(const Mesh &mesh, const Material& material, int lod) = 0;
+	//one draw of instanceCount copies
+	virtual void DrawMeshInstanced(const Mesh &mesh, const Material& material, const InstanceTransform* instances, int instanceCount, int lod) = 0;
+	//the mesh vertices with other triangles (culled meshlets), the indices are gone after the call
+	virtual void DrawMeshIndexed(const Mesh &mesh, const Material& material, const unsigned int* indices, int indexCount) = 0;
+
+	//sorted packets, the default just calls DrawMesh / DrawMeshInstanced / DrawMeshIndexed for each
+	virtual void DrawRenderQueue(const RenderQueue& queue);
+
+	//the mesh / shader is going away (or gone, on the render thread), only its address keys the resource
+	virtual void ReleaseMesh(const Mesh* mesh, GfxHandle handle) {}
+	virtual void ReleaseShader(const Shader* shader, GfxHandle handle) {}
+	//starts building the shader ahead of its first draw
+	virtual void PrepareShader(const Shader& shader) {}
 };
\ No newline at end of file
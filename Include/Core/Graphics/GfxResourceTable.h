@@ -0,0 +1,152 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/*
+	Generational handle into a GfxResourceTable
+	| generation 12 | index 20 |, the value 0 is never handed out
+*/
+struct GfxHandle
+{
+	static const int kIndexBits = 20;
+	static const uint32_t kIndexMask = (1u << kIndexBits) - 1;
+	static const uint32_t kGenerationMask = (1u << (32 - kIndexBits)) - 1;
+
+	uint32_t m_value;
+
+	GfxHandle(void) : m_value(0) {}
+	GfxHandle(uint32_t index, uint32_t generation) : m_value((generation << kIndexBits) | (index & kIndexMask)) {}
+
+	bool IsValid(void) const { return m_value != 0; }
+	uint32_t GetIndex(void) const { return m_value & kIndexMask; }
+	uint32_t GetGeneration(void) const { return m_value >> kIndexBits; }
+
+	bool operator==(const GfxHandle& other) const { return m_value == other.m_value; }
+	bool operator!=(const GfxHandle& other) const { return m_value != other.m_value; }
+};
+
+/*
+	Render thread frames a mesh / shader / material was drawn in
+	Only the last two are kept, one frame is in flight while the next is recorded
+*/
+struct GfxFrameStamp
+{
+	uint32_t m_frame;
+	uint32_t m_previousFrame;
+
+	GfxFrameStamp(void) : m_frame(0), m_previousFrame(0) {}
+
+	void Mark(uint32_t frame) { if (frame != m_frame) { m_previousFrame = m_frame; m_frame = frame; } }
+	//last frame before this one that used it, 0 for none
+	uint32_t GetFrameBefore(uint32_t frame) const { return m_frame < frame ? m_frame : m_previousFrame; }
+};
+
+/*
+	Dense slot array of device resource records
+	Get is one indexed load plus a generation and owner compare. Removing bumps the
+	slot generation, so stale handles (and handles of another device) miss.
+*/
+template<class T>
+class GfxResourceTable
+{
+private:
+	struct Slot
+	{
+		T m_resource;
+		const void* m_owner;
+		uint32_t m_generation;
+		uint32_t m_nextFree;
+	};
+
+	static const uint32_t kNoSlot = 0xFFFFFFFF;
+
+private:
+	std::vector<Slot> m_slots;
+	uint32_t m_freeHead;
+	uint32_t m_count;
+
+public:
+	GfxResourceTable(void) : m_freeHead(kNoSlot), m_count(0) {}
+
+	GfxHandle Add(const void* owner, const T& resource)
+	{
+		uint32_t index = m_freeHead;
+		if (index != kNoSlot)
+			m_freeHead = m_slots[index].m_nextFree;
+		else
+		{
+			/* Assert(m_slots.size() <= GfxHandle::kIndexMask) */
+			index = static_cast<uint32_t>(m_slots.size());
+			m_slots.push_back(Slot());
+			m_slots[index].m_generation = 1;
+		}
+
+		Slot& slot = m_slots[index];
+		slot.m_resource = resource;
+		slot.m_owner = owner;
+		slot.m_nextFree = kNoSlot;
+		++m_count;
+		return GfxHandle(index, slot.m_generation);
+	}
+
+	T* Get(GfxHandle handle, const void* owner)
+	{
+		const uint32_t index = handle.GetIndex();
+		if (index >= m_slots.size())
+			return nullptr;
+
+		Slot& slot = m_slots[index];
+		if (slot.m_generation != handle.GetGeneration() || slot.m_owner != owner)
+			return nullptr;
+		return &slot.m_resource;
+	}
+
+	//the removed record is copied out so the caller can queue its release
+	bool Remove(GfxHandle handle, const void* owner, T& resource)
+	{
+		T* res = Get(handle, owner);
+		if (res == nullptr)
+			return false;
+
+		const uint32_t index = handle.GetIndex();
+		Slot& slot = m_slots[index];
+		resource = std::move(*res);
+		slot.m_owner = nullptr;
+		//generation 0 would make a handle of value 0 possible
+		slot.m_generation = (slot.m_generation + 1) & GfxHandle::kGenerationMask;
+		if (slot.m_generation == 0)
+			slot.m_generation = 1;
+		slot.m_nextFree = m_freeHead;
+		m_freeHead = index;
+		--m_count;
+		return true;
+	}
+
+	//calls func(resource) for every live record
+	template<class Func>
+	void ForEach(Func func)
+	{
+		for (size_t i = 0; i < m_slots.size(); ++i)
+		{
+			if (m_slots[i].m_owner != nullptr)
+				func(m_slots[i].m_resource);
+		}
+	}
+
+	//slots are kept so handles given out before still miss
+	void Clear(void)
+	{
+		for (size_t i = 0; i < m_slots.size(); ++i)
+		{
+			if (m_slots[i].m_owner != nullptr)
+			{
+				T resource;
+				Remove(GfxHandle(static_cast<uint32_t>(i), m_slots[i].m_generation), m_slots[i].m_owner, resource);
+			}
+		}
+	}
+
+	uint32_t GetCount(void) const { return m_count; }
+};
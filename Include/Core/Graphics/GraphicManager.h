@@ -1,9 +1,17 @@
 #pragma once
 #include "Core\Misc\Singleton.h"
 #include "Core\Graphics\GfxDevice.h"
+#include "Core\Graphics\RenderQueue.h"
 
 class Mesh;
 class Material;
+class Shader;
+class Matrix4x4;
+class MeshletSet;
+class Frustum;
+class Vector3;
+class RenderThread;
+struct RenderThreadStats;
 
 /*
 	ƽӿڷװ
@@ -12,16 +20,71 @@ class GraphicManager : public Singleton<GraphicManager>
 {
 private:
 	GfxDevice* m_gfxDevice;
+	//on the render thread when there is one, every device call then goes through its command list
+	RenderThread* m_renderThread;
+	RenderQueue m_renderQueue;
+	//queue the draws go to, m_renderQueue or the one of the render thread list
+	RenderQueue* m_recordQueue;
+	//LOD error allowed on screen, over the screen height
+	float m_lodScreenError;
+	//DrawMeshlets scratch
+	std::vector<unsigned int> m_meshletIndices;
+	//device records released without a render thread, freed after the draws recorded before them
+	std::vector<std::pair<const Mesh*, GfxHandle> > m_meshReleases;
+	std::vector<std::pair<const Shader*, GfxHandle> > m_shaderReleases;
 
 public:
+	//a pixel at 1080p
+	static const float kDefaultLODScreenError;
+
+	GraphicManager(void) : m_gfxDevice(nullptr), m_renderThread(nullptr), m_recordQueue(&m_renderQueue), m_lodScreenError(kDefaultLODScreenError) {}
+
 	virtual void OnInit();
 	virtual void OnDestroy();
 
 public:
-	void SetGfxDevice(GfxDevice* gfxDevice);
+	//renderThread plays the frames one behind on a thread of their own, changing or deleting a mesh / shader / material
+	//waits for the thread only when the frame it is playing drew with it. Deleting a mesh / shader / material drops its draws not drawn yet (recorded since the
+	//last Flush, or since the last SwapBuffer with the thread), a changed mesh is drawn as it is at the Flush
+	void SetGfxDevice(GfxDevice* gfxDevice, bool renderThread = false);
+	//nullptr without a render thread
+	const RenderThreadStats* GetRenderThreadStats(void) const;
 
 	void Clear(void);
-	void DrawMesh(const Mesh& mesh, const Material& material);
+	//recorded, sorted and drawn on SwapBuffer (or the next Clear)
+	void DrawMesh(const Mesh& mesh, const Material& material, float depth = 0.0F, unsigned int pass = 0);
+	//one draw for every transform, the transforms are copied
+	void DrawMeshInstanced(const Mesh& mesh, const Material& material, const Matrix4x4* transforms, int instanceCount, float depth = 0.0F, unsigned int pass = 0);
+	void DrawMeshInstanced(const Mesh& mesh, const Material& material, const InstanceTransform* instances, int instanceCount, float depth = 0.0F, unsigned int pass = 0);
+
+	//the LOD is picked by screenSize, the bounding sphere diameter over the screen height (Mesh::GetScreenSize)
+	void DrawMeshLOD(const Mesh& mesh, const Material& material, float screenSize, float depth = 0.0F, unsigned int pass = 0);
+	//screenSize of the nearest instance
+	void DrawMeshInstancedLOD(const Mesh& mesh, const Material& material, const InstanceTransform* instances, int instanceCount, float screenSize, float depth = 0.0F, unsigned int pass = 0);
+
+	//only the meshlets in the frustum and facing the camera (mesh space), as one draw
+	void DrawMeshlets(const Mesh& mesh, const MeshletSet& meshlets, const Material& material, const Frustum& frustum, const Vector3& cameraPosition, float depth = 0.0F, unsigned int pass = 0);
+
+	void SetLODScreenError(float screenError) { m_lodScreenError = screenError; }
+	float GetLODScreenError(void) const { return m_lodScreenError; }
 
 	void SwapBuffer(void);
+
+	//draws the recorded meshes now, or hands them to the render thread in order with the clears
+	void Flush(void);
+
+	//call at load time, so the first draw does not wait for the compile
+	void PrepareShader(const Shader& shader);
+
+	//called by Mesh / Shader destructors and Mesh setters, with or without a handle, the render thread may be making one
+	//the device record is freed after the next Flush draws, never in the middle of a frame
+	void ReleaseMesh(const Mesh& mesh, bool destroyed = false);
+	void ReleaseShader(const Shader& shader);
+	//called by the Material destructor, the device keeps nothing of it
+	void ReleaseMaterial(const Material& material);
+
+private:
+	//frame stamps the release waits on, render thread only
+	void MarkDrawn(const Mesh& mesh, const Material& material);
+	void ProcessReleases(void);
 };
@@ -0,0 +1,15 @@
+#pragma once
+
+class Matrix4x4;
+
+/*
+	Per instance transform as streamed to the GPU
+	Top three rows of an affine Matrix4x4, 48 bytes instead of 64.
+	A shader rebuilds the position with dot(row, vec4(position, 1)).
+*/
+struct InstanceTransform
+{
+	float m_rows[3][4];
+};
+
+void PackInstanceTransforms(const Matrix4x4* matrices, int count, InstanceTransform* output);
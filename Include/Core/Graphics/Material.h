@@ -1,4 +1,8 @@
 #pragma once
+#include <cstdint>
+
+#include "Core\Math\Vector4.h"
+#include "Core\Graphics\GfxResourceTable.h"
 
 class Shader;
 class Matrix4x4;
@@ -11,11 +15,23 @@ class Material
 {
 private:
 	const Shader& m_shader;
+	//RGBA in [0, 1], white by default
+	//only SoftwareGfxDevice reads it for now, the SimpleMesh shaders still output white
+	Vector4 m_baseColor;
+	uint32_t m_packedBaseColor;
+	//render thread frames that drew with it
+	mutable GfxFrameStamp m_gfxFrames;
 
 public:
 	Material(const Shader &shader);
+	~Material(void);
 
 	const Shader& GetShader(void) const { return m_shader; }
+	const Vector4& GetBaseColor(void) const { return m_baseColor; }
+	void SetBaseColor(const Vector4& color);
+	//RGBA8, R in the low byte, what RenderQueue keeps of a draw
+	uint32_t GetPackedBaseColor(void) const { return m_packedBaseColor; }
+	GfxFrameStamp& GetGfxFrames(void) const { return m_gfxFrames; }
 
 	//void SetMatrix(String& uniformName, Matrix4x4& matrix);
 	//void SetMatrixArray(String& uniformName, std::vector<Matrix4x4>& matrixArray);
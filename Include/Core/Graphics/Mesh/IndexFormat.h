@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+	Index width of an uploaded mesh
+	Mesh keeps 32 bit indices, a device narrows them to the smallest type that holds
+	the largest (rebased) index when it uploads. SSE2 on x86, scalar elsewhere.
+*/
+
+enum class IndexType { UInt8, UInt16, UInt32 };
+
+constexpr int GetIndexTypeSize(IndexType type)
+{
+	return type == IndexType::UInt8 ? 1 : type == IndexType::UInt16 ? 2 : 4;
+}
+
+//smallest type holding maxIndex
+IndexType GetIndexType(uint32_t maxIndex);
+
+//0 for no indices
+uint32_t FindMaxIndex(const uint32_t* indices, size_t count);
+
+//output[i] = indices[i] + bias in type, false (output undefined) when one does not fit
+bool NarrowIndices(const uint32_t* indices, size_t count, uint32_t bias, IndexType type, void* output);
@@ -1,8 +1,12 @@
 #pragma once
 #include <vector>
 
+#include "Core\Math\Vector2.h"
 #include "Core\Math\Vector3.h"
 #include "Core\Container\String.h"
+#include "Core\Graphics\GfxResourceTable.h"
+
+struct VertexLayoutDesc;
 
 /*
  *	Basic Vertex
@@ -12,7 +16,18 @@ struct Vertex
 {
 	Vector3 m_position;
 	Vector3 m_normal;
-	Vector3 m_texCoord;
+	Vector2 m_texCoord;
+};
+
+/*
+ *	Index range of one level of detail, all levels draw the same vertices
+ *	LOD 0 is the mesh indices, the coarser ones follow them (GetLODIndex)
+ */
+struct MeshLOD
+{
+	unsigned int m_firstIndex;	//into the mesh indices followed by the LOD indices
+	unsigned int m_indexCount;
+	float m_error;				//distance to LOD 0 over the bounding radius
 };
 
 /*
@@ -25,18 +40,33 @@ class Mesh
 public:
 	enum class MeshType { Cube, Plane, Sphere, MeshTypeCount };
 
+	static const int kMaxLODCount = 8;
+
 private:
 	std::vector<Vertex> m_vertices;
 	std::vector<unsigned int> m_indices;
 
-	//attrib description
+	//LOD 1.., LOD 0 is the whole index set
+	std::vector<MeshLOD> m_lods;
+	std::vector<unsigned int> m_lodIndices;
 
+	//attrib description, nullptr is StandardVertexLayout
+	const VertexLayoutDesc* m_vertexLayout;
+
+	//device record, released with the mesh
+	mutable GfxHandle m_gfxHandle;
+	mutable GfxFrameStamp m_gfxFrames;
 
 public:
-	Mesh(void) {};
+	Mesh(void) : m_vertexLayout(nullptr) {};
 	Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
 	Mesh(String meshPath);
 	Mesh(MeshType meshType);
+	//the copy gets its own device record
+	Mesh(const Mesh& other) : m_vertices(other.m_vertices), m_indices(other.m_indices), m_lods(other.m_lods), m_lodIndices(other.m_lodIndices), m_vertexLayout(other.m_vertexLayout) {}
+	~Mesh(void);
+
+	Mesh& operator=(const Mesh& other);
 
 	int GetVertexCount() const;
 	int GetIndexCount() const;
@@ -44,10 +74,39 @@ public:
 	const std::vector<Vertex>& GetVertex() const;
 	const std::vector<unsigned int>& GetIndex() const;
 
-	void SetVertex(std::vector<Vertex> &vertices) { m_vertices = vertices; }
-	void SetIndex(std::vector<unsigned int> &indices) { m_indices = indices; }
+	//data changes drop the uploaded copy and the LODs
+	//released before the change, the render thread may still read the old data
+	void SetVertex(std::vector<Vertex> &vertices) { ReleaseGfxResource(); m_vertices = vertices; ClearLODs(); }
+	void SetIndex(std::vector<unsigned int> &indices) { ReleaseGfxResource(); m_indices = indices; ClearLODs(); }
+
+	//1 without LODs
+	int GetLODCount(void) const { return 1 + (int)m_lods.size(); }
+	MeshLOD GetLOD(int lod) const;
+	const unsigned int* GetLODIndexData(int lod) const;
+	const std::vector<unsigned int>& GetLODIndex(void) const { return m_lodIndices; }
+	//LOD 1.. from fine to coarse, see MeshSimplifier::GenerateLODs
+	void SetLODs(const std::vector<MeshLOD>& lods, const std::vector<unsigned int>& lodIndices);
+	void ClearLODs(void) { m_lods.clear(); m_lodIndices.clear(); }
+
+	//coarsest LOD whose error covers at most maxScreenError of the screen height
+	int SelectLOD(float screenSize, float maxScreenError) const;
+	//bounding sphere diameter over the screen height
+	static float GetScreenSize(float radius, float distance, float tanHalfFovY);
+
+	//format the vertices are uploaded in
+	const VertexLayoutDesc& GetVertexLayout(void) const;
+	void SetVertexLayout(const VertexLayoutDesc& layout) { ReleaseGfxResource(); m_vertexLayout = &layout; }
+
+	GfxHandle GetGfxHandle(void) const { return m_gfxHandle; }
+	void SetGfxHandle(GfxHandle handle) const { m_gfxHandle = handle; }
+	GfxFrameStamp& GetGfxFrames(void) const { return m_gfxFrames; }
+	//destroyed also drops the draws of the mesh still queued
+	void ReleaseGfxResource(bool destroyed = false) const;
+
+	//optimized, with LODs, called by GraphicManager init so none of it runs in static init
+	static void InitBasicMesh(void);
 
 private:
 	static const Mesh* m_basicMesh;
-	static const Mesh* InitBasicMesh(void);
+	static const Mesh& GetBasicMesh(MeshType meshType);
 };
\ No newline at end of file
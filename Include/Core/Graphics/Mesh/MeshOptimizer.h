@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+
+#include "Core\Graphics\Mesh\Mesh.h"
+
+/*
+	Index / vertex order optimization for the GPU, the mesh looks the same after
+
+	1. OptimizeVertexCache	Forsyth's linear speed ordering, triangles reuse the
+							post transform cache of the last ones
+	2. OptimizeOverdraw		keeps the cache order inside clusters, sorts the clusters
+							so the outward facing ones are drawn first
+	3. OptimizeVertexFetch	vertices in first use order, the fetches walk memory forward
+
+	ACMR is transformed vertices per triangle (0.5 is ideal on a grid, 3 the worst),
+	ATVR transformed per used vertex (1 is ideal).
+*/
+class MeshOptimizer
+{
+public:
+	//LRU cache the ordering scores against
+	static const int kCacheSize = 32;
+	//FIFO of AnalyzeVertexCache, closer to what a GPU has
+	static const int kAnalyzeCacheSize = 16;
+
+	struct Stats
+	{
+		float m_acmr;
+		float m_atvr;
+	};
+
+private:
+	MeshOptimizer(void) {}
+
+public:
+	static void OptimizeVertexCache(std::vector<unsigned int>& indices, int vertexCount);
+	//indices must be cache optimized already
+	static void OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices);
+	static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+	static Stats AnalyzeVertexCache(const std::vector<unsigned int>& indices, int vertexCount, int cacheSize = kAnalyzeCacheSize);
+
+	//all three passes, before / after may be nullptr
+	static void Optimize(Mesh& mesh, Stats* before = nullptr, Stats* after = nullptr);
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+
+#include "Core\Graphics\Mesh\Mesh.h"
+
+/*
+	Quadric error metric simplification (Garland, Heckbert)
+	Edges collapse onto one of their two vertices, so a LOD is only a new index list
+	over the vertices of the mesh, every LOD is drawn from the same vertex buffer.
+
+	Vertices sharing their position with another one (uv / normal seams, hard edges)
+	never move and border vertices only slide along the border, the seams stay closed.
+	Errors are distances to the source surface over the bounding radius.
+*/
+class MeshSimplifier
+{
+public:
+	//weight of the border planes against the surface ones
+	static const int kBorderWeight = 10;
+	//a LOD keeping more of the last one's triangles ends the chain
+	static const float kMinLODReduction;
+
+private:
+	MeshSimplifier(void) {}
+
+public:
+	//stops at targetIndexCount or before an error past maxError, returns the error reached
+	static float Simplify(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, size_t targetIndexCount, float maxError, std::vector<unsigned int>& result);
+
+	//LOD i + 1 keeps ratios[i] of the triangles, the LODs are cache optimized, returns the LOD count
+	static int GenerateLODs(Mesh& mesh, const float* ratios, int ratioCount);
+	//halves the triangles down to 1 / 8
+	static int GenerateLODs(Mesh& mesh);
+
+	//around the center of the bounding box
+	static float GetBoundingRadius(const std::vector<Vertex>& vertices);
+};
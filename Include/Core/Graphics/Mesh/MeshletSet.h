@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "Core\Graphics\Mesh\Mesh.h"
+#include "Core\Math\Vector3Stream.h"
+
+class Frustum;
+
+/*
+	Meshlets (clusters) of a mesh
+	The LOD 0 triangles are split into runs of at most kMaxTriangles triangles over
+	kMaxVertices vertices, each with a bounding sphere and a normal cone. Cull drops
+	the meshlets outside the frustum or facing away from the camera, the indices of
+	the rest make a compacted stream for one glDrawElements (GraphicManager::DrawMeshlets).
+
+	Bounds are SoA, so the frustum test runs on the math kernels and the cone test
+	on 4 meshlets a step. The frustum and the camera are in mesh space.
+*/
+
+struct Meshlet
+{
+	uint32_t m_firstIndex;		//into GetIndex
+	uint32_t m_indexCount;
+	uint32_t m_vertexCount;
+};
+
+class MeshletSet
+{
+public:
+	static const int kMaxVertices = 64;
+	static const int kMaxTriangles = 128;
+
+private:
+	std::vector<Meshlet> m_meshlets;
+	//LOD 0 triangles in meshlet order
+	std::vector<unsigned int> m_indices;
+
+	//bounding spheres
+	Vector3Stream m_centers;
+	std::vector<float> m_radii;
+	//normal cones, every triangle normal is within the cone, cutoff 1 never culls
+	Vector3Stream m_coneAxes;
+	std::vector<float> m_coneCutoffs;
+
+	//Cull scratch, a set is culled by one thread at a time
+	mutable std::vector<uint32_t> m_frustumMask;
+	mutable std::vector<uint32_t> m_visible;
+
+public:
+	MeshletSet(void) {}
+	explicit MeshletSet(const Mesh& mesh) { Build(mesh); }
+
+	//the mesh vertices are used as they are, built again when the mesh changes
+	void Build(const Mesh& mesh);
+	void Clear(void);
+
+	size_t GetCount(void) const { return m_meshlets.size(); }
+	const Meshlet& GetMeshlet(size_t index) const { return m_meshlets[index]; }
+	const std::vector<unsigned int>& GetIndex(void) const { return m_indices; }
+	Vector3 GetCenter(size_t index) const { return m_centers.Get(index); }
+	float GetRadius(size_t index) const { return m_radii[index]; }
+
+	//visibleMeshlets has room for GetCount entries, returns the visible count
+	size_t Cull(const Frustum& frustum, const Vector3& cameraPosition, uint32_t* visibleMeshlets) const;
+	//the visible meshlets' indices back to back, returns the visible meshlet count
+	size_t CullIndices(const Frustum& frustum, const Vector3& cameraPosition, std::vector<unsigned int>& indices) const;
+
+private:
+	void ComputeBounds(const std::vector<Vertex>& vertices);
+};
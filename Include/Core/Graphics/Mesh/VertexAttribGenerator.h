@@ -1,33 +0,0 @@
-#pragma once
-#include <vector>
-/*
-	תMesh,ɶӦʶ
-*/
-
-class Mesh;
-
-class VertexAttribGenerator
-{
-private:
-	static int m_attribTypeByteCount[];
-
-public:
-	enum class AttribType { UNSIGHED_BYTE, BYTE, HALF_FLOAT, FLOAT, COUNT };
-
-	class VertexAttribution
-	{
-	public:
-		const AttribType m_attribType;	//type
-		const int m_componentSize;		//component size
-		const int m_size;				//size in byte
-
-		VertexAttribution(int componentSize, AttribType attribType) : m_attribType(attribType), m_componentSize(componentSize), m_size(componentSize * m_attribTypeByteCount[(int)m_attribType]) {}
-	};
-
-private:
-	VertexAttribGenerator(void) {}
-
-public:
-	static void Generate(const Mesh& mesh, std::vector<VertexAttribution> &vas);
-
-};
\ No newline at end of file
@@ -0,0 +1,216 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Core\Graphics\Mesh\Mesh.h"
+#include "Core\Graphics\Mesh\VertexQuantize.h"
+
+/*
+	Compile time vertex formats
+	A layout is a type list of VertexElement, stride, offsets, the arena key and the
+	attribute table are constants, the packer is generated per layout.
+
+		typedef VertexLayout<
+			VertexElement<VertexSemantic::Position, VertexAttribType::FLOAT, 3>,
+			VertexElement<VertexSemantic::TexCoord, VertexAttribType::FLOAT, 2> > PositionUVLayout;
+
+		mesh.SetVertexLayout(PositionUVLayout::GetDesc());
+
+	Each semantic may appear once, it is also the attribute location.
+	The element type picks the conversion, see GetVertexEncoding.
+*/
+
+enum class VertexAttribType { UNSIGNED_BYTE, BYTE, HALF_FLOAT, FLOAT, SHORT, UNSIGNED_SHORT, COUNT };
+
+//attribute location
+enum class VertexSemantic { Position, Normal, TexCoord, COUNT };
+
+//how a packer turns the float source into the attribute
+enum class VertexEncoding { Copy, Half, Snorm16, Unorm16, Octahedral, Unsupported };
+
+constexpr int GetVertexAttribTypeSize(VertexAttribType type)
+{
+	return type == VertexAttribType::FLOAT ? 4 :
+		type == VertexAttribType::HALF_FLOAT || type == VertexAttribType::SHORT || type == VertexAttribType::UNSIGNED_SHORT ? 2 : 1;
+}
+
+//source member of Vertex
+constexpr int GetVertexSemanticOffset(VertexSemantic semantic)
+{
+	return semantic == VertexSemantic::Position ? offsetof(Vertex, m_position) :
+		semantic == VertexSemantic::Normal ? offsetof(Vertex, m_normal) : offsetof(Vertex, m_texCoord);
+}
+
+constexpr int GetVertexSemanticComponents(VertexSemantic semantic)
+{
+	return semantic == VertexSemantic::TexCoord ? 2 : 3;
+}
+
+//a normalized SHORT normal of 2 components is octahedral
+constexpr VertexEncoding GetVertexEncoding(VertexSemantic semantic, VertexAttribType type, int componentCount, bool normalized)
+{
+	return type == VertexAttribType::FLOAT ? VertexEncoding::Copy :
+		type == VertexAttribType::HALF_FLOAT ? VertexEncoding::Half :
+		type == VertexAttribType::SHORT && normalized ? (semantic == VertexSemantic::Normal && componentCount == 2 ? VertexEncoding::Octahedral : VertexEncoding::Snorm16) :
+		type == VertexAttribType::UNSIGNED_SHORT && normalized ? VertexEncoding::Unorm16 : VertexEncoding::Unsupported;
+}
+
+//one attribute as the device sets it up
+struct VertexAttribDesc
+{
+	int m_location;
+	VertexAttribType m_attribType;
+	int m_componentCount;
+	bool m_normalized;
+	int m_offset;			//in the vertex
+};
+
+//runtime handle of a layout, shared by every mesh of it
+struct VertexLayoutDesc
+{
+	const VertexAttribDesc* m_attribs;
+	int m_attribCount;
+	int m_stride;
+	uint64_t m_key;			//equal keys are the same format
+	//interleaves count vertices into count * m_stride bytes
+	void(*m_pack)(const Vertex* vertices, size_t count, void* output);
+};
+
+template<VertexSemantic Semantic, VertexAttribType Type, int ComponentCount, bool Normalized = false>
+struct VertexElement
+{
+	static constexpr VertexSemantic kSemantic = Semantic;
+	static constexpr VertexAttribType kType = Type;
+	static constexpr int kComponentCount = ComponentCount;
+	static constexpr bool kNormalized = Normalized;
+	static constexpr int kSize = ComponentCount * GetVertexAttribTypeSize(Type);
+	static constexpr int kSourceOffset = GetVertexSemanticOffset(Semantic);
+	static constexpr int kSourceComponents = GetVertexSemanticComponents(Semantic);
+	static constexpr VertexEncoding kEncoding = GetVertexEncoding(Semantic, Type, ComponentCount, Normalized);
+	//location 4 | components 4 | normalized 1 | type 3
+	static constexpr uint64_t kKey = ((uint64_t)Semantic << 8) | ((uint64_t)ComponentCount << 4) | ((uint64_t)Normalized << 3) | (uint64_t)Type;
+
+	static_assert(ComponentCount >= 1 && ComponentCount <= 4, "1 to 4 components");
+	static_assert(kEncoding != VertexEncoding::Unsupported, "no packer for this attribute type");
+	static_assert(kEncoding != VertexEncoding::Copy || ComponentCount <= kSourceComponents, "a float copy can't add components");
+};
+
+namespace VertexLayoutDetail
+{
+	template<class... Elements>
+	struct Stride { static constexpr int value = 0; };
+	template<class First, class... Rest>
+	struct Stride<First, Rest...> { static constexpr int value = First::kSize + Stride<Rest...>::value; };
+
+	template<class... Elements>
+	struct Key { static constexpr uint64_t value = 0; };
+	template<class First, class... Rest>
+	struct Key<First, Rest...> { static constexpr uint64_t value = (First::kKey << (12 * sizeof...(Rest))) | Key<Rest...>::value; };
+
+	//offset of Target, the size of everything before it
+	template<class Target, class... Elements>
+	struct Offset;
+	template<class Target, class... Rest>
+	struct Offset<Target, Target, Rest...> { static constexpr int value = 0; };
+	template<class Target, class First, class... Rest>
+	struct Offset<Target, First, Rest...> { static constexpr int value = First::kSize + Offset<Target, Rest...>::value; };
+
+	//the layout is a float prefix of Vertex, one copy of the stride does the whole vertex
+	template<int Position, class... Elements>
+	struct IsVertexPrefix { static constexpr bool value = true; };
+	template<int Position, class First, class... Rest>
+	struct IsVertexPrefix<Position, First, Rest...>
+	{
+		static constexpr bool value = First::kEncoding == VertexEncoding::Copy && First::kSourceOffset == Position && IsVertexPrefix<Position + First::kSize, Rest...>::value;
+	};
+
+	//one attribute of every vertex, the switch is on a constant
+	template<class Element>
+	void PackElement(const Vertex* vertices, size_t count, char* output, int stride)
+	{
+		const char* source = reinterpret_cast<const char*>(vertices) + Element::kSourceOffset;
+		switch (Element::kEncoding)
+		{
+		case VertexEncoding::Copy:
+			for (size_t i = 0; i < count; ++i)
+				memcpy(output + i * stride, source + i * sizeof(Vertex), Element::kSize);
+			break;
+		case VertexEncoding::Half:
+			QuantizeHalf(source, sizeof(Vertex), Element::kSourceComponents, output, stride, Element::kComponentCount, count);
+			break;
+		case VertexEncoding::Snorm16:
+			QuantizeSnorm16(source, sizeof(Vertex), Element::kSourceComponents, output, stride, Element::kComponentCount, count);
+			break;
+		case VertexEncoding::Unorm16:
+			QuantizeUnorm16(source, sizeof(Vertex), Element::kSourceComponents, output, stride, Element::kComponentCount, count);
+			break;
+		case VertexEncoding::Octahedral:
+			QuantizeOctahedral(source, sizeof(Vertex), output, stride, count);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+template<class... Elements>
+struct VertexLayout
+{
+	static constexpr int kAttribCount = sizeof...(Elements);
+	static constexpr int kStride = VertexLayoutDetail::Stride<Elements...>::value;
+	static constexpr uint64_t kKey = VertexLayoutDetail::Key<Elements...>::value;
+	static constexpr bool kIsVertexPrefix = VertexLayoutDetail::IsVertexPrefix<0, Elements...>::value;
+
+	static constexpr VertexAttribDesc kAttribs[] = {
+		{ (int)Elements::kSemantic, Elements::kType, Elements::kComponentCount, Elements::kNormalized, VertexLayoutDetail::Offset<Elements, Elements...>::value }...
+	};
+
+	static_assert(kAttribCount > 0 && kAttribCount <= 5, "the key holds 5 attributes");
+
+	//the compiler unrolls the constant size copies into plain vector moves
+	static void Pack(const Vertex* vertices, size_t count, void* output)
+	{
+		char* out = static_cast<char*>(output);
+		if (kIsVertexPrefix)
+		{
+			if (kStride == sizeof(Vertex))
+			{
+				memcpy(out, vertices, count * sizeof(Vertex));
+				return;
+			}
+			for (size_t i = 0; i < count; ++i, out += kStride)
+				memcpy(out, &vertices[i], kStride);
+			return;
+		}
+
+		//a pass per attribute, so the conversions run over whole streams
+		int expand[] = { (VertexLayoutDetail::PackElement<Elements>(vertices, count, out + VertexLayoutDetail::Offset<Elements, Elements...>::value, kStride), 0)... };
+		(void)expand;
+	}
+
+	static const VertexLayoutDesc& GetDesc(void)
+	{
+		static const VertexLayoutDesc desc = { kAttribs, kAttribCount, kStride, kKey, &Pack };
+		return desc;
+	}
+};
+
+template<class... Elements>
+constexpr VertexAttribDesc VertexLayout<Elements...>::kAttribs[];
+
+//what every mesh uses unless told otherwise, 32 bytes
+typedef VertexLayout<
+	VertexElement<VertexSemantic::Position, VertexAttribType::FLOAT, 3>,
+	VertexElement<VertexSemantic::Normal, VertexAttribType::FLOAT, 3>,
+	VertexElement<VertexSemantic::TexCoord, VertexAttribType::FLOAT, 2> > StandardVertexLayout;
+
+static_assert(StandardVertexLayout::kStride == sizeof(Vertex) && StandardVertexLayout::kIsVertexPrefix, "standard layout is a copy of Vertex");
+
+//half of the standard size: half position (w = 1), octahedral normal, UNORM16 uv in [0, 1]
+typedef VertexLayout<
+	VertexElement<VertexSemantic::Position, VertexAttribType::HALF_FLOAT, 4>,
+	VertexElement<VertexSemantic::Normal, VertexAttribType::SHORT, 2, true>,
+	VertexElement<VertexSemantic::TexCoord, VertexAttribType::UNSIGNED_SHORT, 2, true> > QuantizedVertexLayout;
+
+static_assert(QuantizedVertexLayout::kStride == 16, "quantized layout is 16 bytes");
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+	Float to compact vertex attribute conversion, used by the VertexLayout packers
+	Every function converts count strided values of float components, SSE2 on x86,
+	scalar elsewhere. Components past sourceComponents read as 1 (the w of a position).
+
+	Octahedral normals are two SNORM16, decoded in the vertex shader with
+		vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+		if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * sign(n.xy);
+		n = normalize(n);
+*/
+
+//round to nearest even, overflow is inf
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t value);
+
+void QuantizeHalf(const char* source, size_t sourceStride, int sourceComponents, char* output, size_t outputStride, int componentCount, size_t count);
+//clamped to [-1, 1]
+void QuantizeSnorm16(const char* source, size_t sourceStride, int sourceComponents, char* output, size_t outputStride, int componentCount, size_t count);
+//clamped to [0, 1], repeating texture coordinates need a float layout
+void QuantizeUnorm16(const char* source, size_t sourceStride, int sourceComponents, char* output, size_t outputStride, int componentCount, size_t count);
+//unit vector of 3 floats to 2 SNORM16
+void QuantizeOctahedral(const char* source, size_t sourceStride, char* output, size_t outputStride, size_t count);
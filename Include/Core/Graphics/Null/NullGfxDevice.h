@@ -0,0 +1,105 @@
+#pragma once
+#include <vector>
+
+#include "Core\Graphics\GfxDevice.h"
+#include "Core\Graphics\GfxResourceTable.h"
+#include "Core\Graphics\Mesh\IndexFormat.h"
+
+class Mesh;
+class Shader;
+
+/*
+	Draw statistics
+	Counted by the CPU side of a device, reset per frame by SwapBuffer
+*/
+struct GfxDeviceStats
+{
+	unsigned int m_drawCalls;
+	unsigned int m_triangles;
+	unsigned int m_vertices;			//indices submitted
+	unsigned int m_instances;			//copies drawn by instanced draws
+	unsigned int m_clears;
+
+	unsigned int m_programChanges;		//bound program actually changed
+	unsigned int m_vertexArrayChanges;	//bound vertex array actually changed
+	unsigned int m_redundantBinds;		//binds skipped, already bound
+
+	unsigned int m_meshUploads;
+	unsigned int m_programCreates;
+	unsigned long long m_bytesUploaded;	//vertex + index + instance data
+
+	GfxDeviceStats(void) { Reset(); }
+
+	void Reset(void);
+	void Add(const GfxDeviceStats& other);
+};
+
+/*
+	Null Graphics API
+	No window, context or GPU. Does the same CPU work as ESDevice (vertex packing,
+	buffer copies, resource lookups) so CPU frame cost can be profiled headless.
+*/
+
+class NullGfxDevice : public GfxDevice
+{
+private:
+	struct MeshBuffer
+	{
+		unsigned int m_id;
+		int m_stride;
+		std::vector<char> m_vertexData;
+		IndexType m_indexType;
+		std::vector<char> m_indexData;		//every LOD
+	};
+
+	typedef GfxResourceTable<MeshBuffer> MeshTable;
+	typedef GfxResourceTable<unsigned int> ProgramTable;
+
+private:
+	MeshTable m_meshTable;
+	ProgramTable m_programTable;
+	//released buffers, freed on SwapBuffer like ESDevice
+	std::vector<MeshBuffer> m_releasedMeshes;
+	unsigned int m_nextID;
+
+	unsigned int m_boundProgram;
+	unsigned int m_boundVertexArray;
+	//instance stream, copied like glBufferSubData would
+	std::vector<char> m_instanceData;
+	//DrawMeshIndexed stream, narrowed like ESDevice does
+	std::vector<char> m_dynamicIndexData;
+
+	GfxDeviceStats m_frameStats;
+	GfxDeviceStats m_lastFrameStats;
+	GfxDeviceStats m_totalStats;
+	unsigned int m_frameCount;
+
+public:
+	NullGfxDevice(void) : m_nextID(1), m_boundProgram(0), m_boundVertexArray(0), m_frameCount(0) {}
+
+	virtual void Init();
+	virtual void Destroy();
+	virtual void SwapBuffer();
+	virtual void Clear();
+	virtual void DrawMesh(const Mesh &mesh, const Material& material, int lod);
+	virtual void DrawMeshInstanced(const Mesh &mesh, const Material& material, const InstanceTransform* instances, int instanceCount, int lod);
+	virtual void DrawMeshIndexed(const Mesh &mesh, const Material& material, const unsigned int* indices, int indexCount);
+	virtual void ReleaseMesh(const Mesh* mesh, GfxHandle handle);
+	virtual void ReleaseShader(const Shader* shader, GfxHandle handle);
+
+	//stats of the frame being recorded
+	const GfxDeviceStats& GetFrameStats(void) const { return m_frameStats; }
+	//stats of the last finished frame
+	const GfxDeviceStats& GetLastFrameStats(void) const { return m_lastFrameStats; }
+	//all finished frames
+	const GfxDeviceStats& GetTotalStats(void) const { return m_totalStats; }
+	unsigned int GetFrameCount(void) const { return m_frameCount; }
+
+private:
+	const MeshBuffer& UploadMesh(const Mesh& mesh);
+	unsigned int GetProgram(const Shader& shader);
+	unsigned int CreateShader(const Shader& shader);
+
+	void BindVertexArray(unsigned int id);
+	void UseProgram(unsigned int id);
+};
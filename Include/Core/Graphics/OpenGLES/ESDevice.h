@@ -1,11 +1,20 @@
 #pragma once
-#include <map>
+#include <vector>
 
 #include <EGL\egl.h>
 #include <EGL\eglext.h>
 #include <GLES3\gl3.h>
 
 #include "Core\Graphics\GfxDevice.h"
+#include "Core\Graphics\GfxResourceTable.h"
+#include "Core\Graphics\GfxBufferAllocator.h"
+#include "Core\Graphics\Mesh\VertexLayout.h"
+#include "Core\Graphics\Mesh\IndexFormat.h"
+#include "Core\Graphics\OpenGLES\ESRingBuffer.h"
+#include "Core\Graphics\OpenGLES\ESStateCache.h"
+#include "Core\Graphics\OpenGLES\ESProgramCache.h"
+#include "Core\Graphics\OpenGLES\ESShaderCompiler.h"
+#include "Core\Misc\LinearAllocator.h"
 
 class Mesh;
 class Shader;
@@ -17,10 +26,44 @@ class Shader;
 class ESDevice : public GfxDevice
 {
 private:
-	typedef std::map<const Mesh*, GLuint> VBOMap;
-	typedef std::map<const Mesh*, GLuint> VAOMap;
-	typedef std::map<const Mesh*, GLuint> EBOMap;
-	typedef std::map<const Shader*, GLuint> ShaderMap;
+	//static mesh ranges in an arena, indices are stored rebased by m_baseVertex
+	struct MeshResource
+	{
+		GLuint m_vao;
+		uint32_t m_arena;
+		uint32_t m_baseVertex;
+		uint32_t m_vertexCount;
+		uint32_t m_firstIndex;
+		uint32_t m_indexCount;	//every LOD
+		GLenum m_indexType;
+		uint32_t m_indexSize;
+		size_t m_indexOffset;	//m_firstIndex in bytes
+	};
+
+	//shared vertex / index buffer of one vertex layout, one vao for all its meshes
+	struct MeshArena
+	{
+		uint64_t m_layout;
+		IndexType m_indexType;
+		int m_stride;
+		GLuint m_vbo;
+		GLuint m_ebo;
+		GLuint m_vao;
+		GfxBufferAllocator m_vertexAllocator;	//in vertices
+		GfxBufferAllocator m_indexAllocator;	//in indices
+
+		MeshArena(uint32_t vertexCount, uint32_t indexCount) : m_vertexAllocator(vertexCount), m_indexAllocator(indexCount) {}
+	};
+
+	//m_program is 0 while m_job compiles, and for ever once it failed
+	struct ProgramResource
+	{
+		GLuint m_program;
+		GfxHandle m_job;
+	};
+
+	typedef GfxResourceTable<MeshResource> MeshTable;
+	typedef GfxResourceTable<ProgramResource> ProgramTable;
 
 private:
 	EGLDisplay m_eglDisplay;
@@ -44,24 +87,83 @@ private:
 	static const EGLint m_renderableType = EGL_OPENGL_ES3_BIT_KHR;
 	static const EGLint m_surfaceType = EGL_WINDOW_BIT;
 
-	/*
-		TODO : use ID!
-		TODO : use share vao!
-	*/
-	VBOMap m_meshToVBO;
-	VAOMap m_meshToVAO;
-	EBOMap m_meshToEBO;
-	ShaderMap m_shaderMap;
+	//arena size, bigger meshes get an arena of their own
+	static const uint32_t kArenaVertexCount = 1 << 18;
+	static const uint32_t kArenaIndexCount = 1 << 20;
+	//16 bit arenas end at 65536 vertices, so every rebased index fits
+	static const uint32_t kArena16VertexCount = 1 << 16;
+
+	//InstanceTransform rows, past any mesh attribute
+	static const GLuint kInstanceAttribLocation = 8;
+	//dynamic data of one frame, the ring holds three
+	static const size_t kDynamicFrameSize = 4 * 1024 * 1024;
+	//cpu staging of one frame, grows to the biggest frame seen
+	static const size_t kFrameAllocatorSize = 1024 * 1024;
+
+	//every bind / toggle goes through it
+	ESStateCache m_stateCache;
+
+	MeshTable m_meshTable;
+	ProgramTable m_programTable;
+	ESProgramCache m_programCache;
+	ESShaderCompiler m_shaderCompiler;
+	//drawn with while a program compiles, nullptr skips the draw
+	const Shader* m_fallbackShader;
+	std::vector<MeshArena> m_arenas;
+
+	//instances and uniform blocks
+	ESRingBuffer m_dynamicRing;
+	size_t m_instanceOffset;	//of the last UploadInstances in the ring
+	unsigned int m_instanceGeneration;	//ring generation of m_instanceOffset
+	GLint m_uniformAlignment;
+
+	//mesh packing and index narrowing, reset at SwapBuffer
+	LinearAllocator m_frameAllocator;
+
+	//released ranges and programs, freed after the frame is swapped
+	std::vector<MeshResource> m_releasedMeshes;
+	std::vector<GLuint> m_deletePrograms;
 
 public:
-	ESDevice(EGLNativeWindowType nativeWindowType) { m_nativeWindowType = nativeWindowType; }
+	ESDevice(EGLNativeWindowType nativeWindowType) : m_fallbackShader(nullptr), m_instanceOffset(0), m_instanceGeneration(0), m_uniformAlignment(256), m_frameAllocator(kFrameAllocatorSize, "Frame") { m_nativeWindowType = nativeWindowType; }
 
 	virtual void Init();
 	virtual void Destroy();
 	virtual void SwapBuffer();
 	virtual void Clear();
-	virtual void DrawMesh(const Mesh &mesh, const Material& material);
+	virtual void DrawMesh(const Mesh &mesh, const Material& material, int lod);
+	virtual void DrawMeshInstanced(const Mesh &mesh, const Material& material, const InstanceTransform* instances, int instanceCount, int lod);
+	virtual void DrawMeshIndexed(const Mesh &mesh, const Material& material, const unsigned int* indices, int indexCount);
+	virtual void DrawRenderQueue(const RenderQueue& queue);
+	virtual void ReleaseMesh(const Mesh* mesh, GfxHandle handle);
+	virtual void ReleaseShader(const Shader* shader, GfxHandle handle);
+	virtual void PrepareShader(const Shader& shader);
+
+	//must outlive the device, it is compiled on first need and waited for
+	void SetFallbackShader(const Shader* shader) { m_fallbackShader = shader; }
+
+	//copies a uniform block for the next draws and binds it to bindingPoint
+	bool BindDynamicUniforms(GLuint bindingPoint, const void* data, size_t size);
+
+	const ESRingBuffer& GetDynamicRing(void) const { return m_dynamicRing; }
+	//issued / filtered GL calls for profiling
+	ESStateCache& GetStateCache(void) { return m_stateCache; }
 
 private:
-	GLuint CreateShader(const Shader &shader);
+	//created on first use
+	const MeshResource* GetMeshResource(const Mesh &mesh);
+	//index count of one LOD, indexOffset its bytes into the arena
+	static GLsizei GetLODRange(const MeshResource& meshRes, const Mesh& mesh, int lod, const void*& indexOffset);
+	//-1 while compiling (or the fallback program) and when compiling failed
+	GLuint GetProgram(const Shader &shader, bool wait = false);
+
+	uint32_t CreateArena(const VertexLayoutDesc& layout, IndexType indexType, uint32_t vertexCount, uint32_t indexCount);
+	void ProcessDeletes(void);
+
+	bool UploadInstances(const InstanceTransform* instances, size_t instanceCount);
+	//indices through the dynamic ring, the mesh vao must be bound
+	void DrawDynamicIndices(const MeshResource& meshRes, const unsigned int* indices, size_t indexCount);
+	//points the instance attributes of the bound vao at firstInstance
+	void EnableInstanceAttribs(size_t firstInstance);
+	void DisableInstanceAttribs(void);
 };
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+
+#include <GLES3\gl3.h>
+
+#include "Core\Container\String.h"
+
+class Shader;
+
+/*
+	On disk cache of linked program binaries
+	One file per program, named by a hash of the shader sources and the driver
+	(vendor, renderer, version, supported binary formats). A driver update changes
+	the hash, so stale binaries are never even read. A binary the driver still
+	rejects is recompiled by the caller and overwritten.
+*/
+class ESProgramCache
+{
+private:
+	//file header, followed by the binary
+	struct Header
+	{
+		uint32_t m_magic;
+		uint32_t m_version;
+		uint64_t m_key;
+		uint32_t m_format;
+		uint32_t m_length;
+	};
+
+	static const uint32_t kMagic = 0x4250574B;	//WKPB
+	static const uint32_t kVersion = 1;
+
+private:
+	String m_directory;
+	uint64_t m_driverHash;
+	bool m_enabled;
+
+	unsigned int m_hitCount;
+	unsigned int m_missCount;
+	unsigned int m_rejectCount;
+
+public:
+	ESProgramCache(void) : m_driverHash(0), m_enabled(false), m_hitCount(0), m_missCount(0), m_rejectCount(0) {}
+
+	//needs the current context, disabled when the driver has no binary formats
+	void Init(const String& directory);
+
+	bool IsEnabled(void) const { return m_enabled; }
+
+	//linked program, or 0 to compile from source
+	GLuint Load(const Shader& shader);
+	//program must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+	void Store(const Shader& shader, GLuint program);
+
+	unsigned int GetHitCount(void) const { return m_hitCount; }
+	unsigned int GetMissCount(void) const { return m_missCount; }
+	unsigned int GetRejectCount(void) const { return m_rejectCount; }
+
+private:
+	uint64_t GetKey(const Shader& shader) const;
+	String GetFileName(uint64_t key) const;
+};
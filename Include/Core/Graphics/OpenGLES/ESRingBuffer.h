@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+
+#include <GLES3\gl3.h>
+
+class ESStateCache;
+
+/*
+	Ring buffer for per frame dynamic data (instances, uniform blocks)
+	kFrameCount segments, one per frame in flight. A segment is only written again
+	after the fence placed at the end of its frame has signaled, so writes are mapped
+	with GL_MAP_UNSYNCHRONIZED_BIT and cost one memcpy.
+
+	ES 3.0 has no persistent mapping and no draw may read a mapped buffer, so every
+	Map is paired with an Unmap before the draws that read it.
+*/
+class ESRingBuffer
+{
+public:
+	static const int kFrameCount = 3;
+
+private:
+	ESStateCache* m_stateCache;
+	GLuint m_buffer;
+	size_t m_frameSize;
+	size_t m_alignment;	//largest one of Map, segments start on it
+	int m_frame;
+	size_t m_head;		//offset in the current segment
+	GLsync m_fences[kFrameCount];
+	bool m_mapped;
+
+	unsigned int m_waitCount;	//times a segment was still in flight
+	unsigned int m_growCount;
+	unsigned int m_generation;	//of the buffer object, offsets of an older one are gone
+
+public:
+	ESRingBuffer(void);
+
+	//alignment is the largest Map will be asked for (GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT), a multiple of the others
+	void Init(ESStateCache* stateCache, size_t frameSize, size_t alignment);
+	void Destroy(void);
+
+	//offset is relative to GetBuffer(), the segment grows when it can't hold size,
+	//that is a new buffer object and a new generation, what was written before is lost
+	void* Map(size_t size, size_t alignment, size_t& offset);
+	void Unmap(void);
+
+	//fences the frame, then waits until the next segment is free
+	void EndFrame(void);
+
+	GLuint GetBuffer(void) const { return m_buffer; }
+	size_t GetFrameSize(void) const { return m_frameSize; }
+	unsigned int GetWaitCount(void) const { return m_waitCount; }
+	unsigned int GetGrowCount(void) const { return m_growCount; }
+	unsigned int GetGeneration(void) const { return m_generation; }
+
+private:
+	void CreateBuffer(size_t frameSize);
+	void WaitFence(int frame);
+};
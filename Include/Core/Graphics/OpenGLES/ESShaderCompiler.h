@@ -0,0 +1,127 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <EGL\egl.h>
+#include <GLES3\gl3.h>
+
+#include "Core\Container\String.h"
+#include "Core\Graphics\GfxResourceTable.h"
+
+class Shader;
+
+/*
+	Asynchronous shader compiler
+	Submit starts the compile and link of a program and returns at once, Poll picks
+	up the result later, so a draw never waits for the driver.
+
+	kParallel	GL_KHR_parallel_shader_compile, the driver compiles on its own threads,
+				done is asked with GL_COMPLETION_STATUS_KHR
+	kWorker		a thread with a context sharing objects with the device compiles and
+				links, the program is handed back with a fence
+	kSerial		neither works, Submit compiles in place like before
+*/
+class ESShaderCompiler
+{
+public:
+	enum Mode
+	{
+		kSerial,
+		kParallel,
+		kWorker,
+	};
+
+	enum Status
+	{
+		kPending,
+		kReady,
+		kFailed,
+	};
+
+private:
+	struct Job
+	{
+		String m_path;
+		GLuint m_program;
+		GLuint m_vs;		//kParallel only, until finished
+		GLuint m_fs;
+		Status m_status;
+		String m_error;
+	};
+
+	//to and from the worker, the worker never touches m_jobs
+	struct WorkItem
+	{
+		GfxHandle m_job;
+		String m_vsSource;
+		String m_fsSource;
+		bool m_retrievable;
+	};
+
+	struct WorkResult
+	{
+		GfxHandle m_job;
+		GLuint m_program;	//0 on failure
+		GLsync m_fence;
+		String m_error;
+	};
+
+	typedef GfxResourceTable<Job> JobTable;
+
+private:
+	Mode m_mode;
+	JobTable m_jobs;
+
+	EGLDisplay m_eglDisplay;
+	EGLContext m_workerContext;
+	EGLSurface m_workerSurface;
+	std::thread m_worker;
+	std::mutex m_mutex;
+	std::condition_variable m_wakeCondition;
+	std::condition_variable m_doneCondition;
+	std::vector<WorkItem> m_queue;
+	std::vector<WorkResult> m_results;
+	bool m_workerStarted;
+	bool m_workerFailed;
+	bool m_quit;
+
+	unsigned int m_submitCount;
+	unsigned int m_waitCount;	//programs needed before they were done
+
+public:
+	ESShaderCompiler(void);
+
+	//needs the device context current, shareContext is the device context
+	void Init(EGLDisplay display, EGLConfig config, EGLContext shareContext);
+	//pending programs are deleted
+	void Destroy(void);
+
+	Mode GetMode(void) const { return m_mode; }
+
+	GfxHandle Submit(const Shader& shader, bool retrievable);
+	//program is set once kReady, the job is gone after kReady / kFailed
+	Status Poll(GfxHandle job, GLuint& program);
+	//blocks until the job is done
+	Status Wait(GfxHandle job, GLuint& program);
+	//the program is deleted whenever it is done
+	void Cancel(GfxHandle job);
+
+	unsigned int GetSubmitCount(void) const { return m_submitCount; }
+	unsigned int GetWaitCount(void) const { return m_waitCount; }
+
+private:
+	bool StartWorker(EGLConfig config, EGLContext shareContext);
+	void WorkerLoop(void);
+	void CollectResults(void);
+
+	Status Finish(GfxHandle job, Job& record, GLuint& program);
+
+	//compiles and links in place, returns 0 and fills error on failure
+	static GLuint Compile(const String& vsSource, const String& fsSource, bool retrievable, String& error);
+	static GLuint CreateStage(GLenum type, const String& source);
+	//checks the stages and the link, deletes the stages
+	static GLuint CheckProgram(GLuint program, GLuint vs, GLuint fs, String& error);
+	static void LogProgram(const String& path, GLuint program);
+};
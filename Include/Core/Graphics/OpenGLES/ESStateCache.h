@@ -0,0 +1,81 @@
+#pragma once
+#include <GLES3\gl3.h>
+
+/*
+	Shadow copy of the GL state ESDevice touches
+	Setters skip the GL call when the value is already set. Everything the device
+	binds or toggles goes through here, a raw gl call would leave the copy stale
+	(call Invalidate after third party GL code).
+
+	GL_ELEMENT_ARRAY_BUFFER and vertex attribute arrays belong to the bound vao,
+	they are not cached.
+*/
+class ESStateCache
+{
+public:
+	static const int kTextureUnitCount = 16;
+
+private:
+	enum BufferSlot { kArrayBuffer, kCopyReadBuffer, kCopyWriteBuffer, kUniformBuffer, kPixelPackBuffer, kPixelUnpackBuffer, kBufferSlotCount };
+	enum TextureSlot { kTexture2D, kTextureCube, kTexture3D, kTexture2DArray, kTextureSlotCount };
+
+	//GLuint(-1) / GLenum(0) marks an unknown value, the next set always goes out
+	GLuint m_program;
+	GLuint m_vertexArray;
+	GLuint m_buffers[kBufferSlotCount];
+	GLuint m_textures[kTextureUnitCount][kTextureSlotCount];
+	GLenum m_activeTexture;
+
+	int m_blend;		//-1 unknown
+	GLenum m_blendSrc;
+	GLenum m_blendDst;
+	int m_depthTest;
+	GLenum m_depthFunc;
+	int m_depthMask;
+	int m_cullFace;
+	GLenum m_cullMode;
+	GLfloat m_clearColor[4];
+	bool m_clearColorValid;
+
+	unsigned int m_issuedCount;
+	unsigned int m_filteredCount;
+
+public:
+	ESStateCache(void) { Invalidate(); }
+
+	//GL defaults, right after the context is created
+	void Reset(void);
+	//state unknown, every next set is issued
+	void Invalidate(void);
+
+	void UseProgram(GLuint program);
+	void BindVertexArray(GLuint vertexArray);
+	void BindBuffer(GLenum target, GLuint buffer);
+	//indexed uniform / transform feedback binding, also sets the generic binding
+	void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+	void BindTexture(GLuint unit, GLenum target, GLuint texture);
+
+	void SetBlend(bool enable);
+	void SetBlendFunc(GLenum src, GLenum dst);
+	void SetDepthTest(bool enable);
+	void SetDepthFunc(GLenum func);
+	void SetDepthMask(bool write);
+	void SetCullFace(bool enable);
+	void SetCullMode(GLenum mode);
+	void SetClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+
+	//deleting a bound object rebinds 0 in GL, the copy follows
+	//(a deleted program stays current until unbound, nothing to do)
+	void OnDeleteVertexArray(GLuint vertexArray);
+	void OnDeleteBuffer(GLuint buffer);
+	void OnDeleteTexture(GLuint texture);
+
+	unsigned int GetIssuedCount(void) const { return m_issuedCount; }
+	unsigned int GetFilteredCount(void) const { return m_filteredCount; }
+	void ResetCounters(void) { m_issuedCount = 0; m_filteredCount = 0; }
+
+private:
+	static int GetBufferSlot(GLenum target);
+	static int GetTextureSlot(GLenum target);
+	void SetCapability(GLenum capability, int& current, bool enable);
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+#include "Core\Graphics\InstanceTransform.h"
+
+class Mesh;
+class Material;
+class Shader;
+class Matrix4x4;
+
+/*
+	Render Queue
+	Draws are recorded as packets with a 64 bit sort key and radix sorted once per frame,
+	so the device sees every draw of a program / material / mesh together.
+
+	key : | pass 4 | shader 12 | material 16 | mesh 16 | depth 16 |
+	Ids are dense and handed out on first use since the last Clear, so the maps never outgrow
+	one flush and keep no deleted object. Depth sorts front to back inside equal state.
+*/
+
+struct RenderPacket
+{
+	uint64_t m_key;
+	const Mesh* m_mesh;
+	const Material* m_material;
+	uint32_t m_firstInstance;	//into GetInstances()
+	uint32_t m_instanceCount;	//0 for a plain draw
+	uint32_t m_lod;
+	uint32_t m_firstIndex;		//into GetIndices()
+	uint32_t m_indexCount;		//0 draws the LOD of the mesh
+	uint32_t m_color;			//Material::GetPackedBaseColor() when the draw was recorded
+};
+
+class RenderQueue
+{
+public:
+	static const int kPassBits = 4;
+	static const int kShaderBits = 12;
+	static const int kMaterialBits = 16;
+	static const int kMeshBits = 16;
+	static const int kDepthBits = 16;
+
+	static const int kDepthShift = 0;
+	static const int kMeshShift = kDepthShift + kDepthBits;
+	static const int kMaterialShift = kMeshShift + kMeshBits;
+	static const int kShaderShift = kMaterialShift + kMaterialBits;
+	static const int kPassShift = kShaderShift + kShaderBits;
+
+private:
+	typedef std::unordered_map<const void*, uint32_t> SortIDMap;
+
+private:
+	std::vector<RenderPacket> m_packets;
+	std::vector<RenderPacket> m_sortBuffer;	//radix scratch
+	std::vector<InstanceTransform> m_instances;	//copied, the caller's array may be gone by the flush
+	std::vector<unsigned int> m_indices;		//same for the indices of AddIndexed
+
+	SortIDMap m_shaderIDs;
+	SortIDMap m_materialIDs;
+	SortIDMap m_meshIDs;
+
+public:
+	//depth in [0, 1], pass in [0, 15], lower draws first, the LOD is not part of the key
+	void Add(const Mesh& mesh, const Material& material, float depth = 0.0F, unsigned int pass = 0, int lod = 0);
+	void AddInstanced(const Mesh& mesh, const Material& material, const Matrix4x4* transforms, int instanceCount, float depth = 0.0F, unsigned int pass = 0, int lod = 0);
+	void AddInstanced(const Mesh& mesh, const Material& material, const InstanceTransform* instances, int instanceCount, float depth = 0.0F, unsigned int pass = 0, int lod = 0);
+	//draws the mesh vertices with these triangles instead, the indices are copied
+	void AddIndexed(const Mesh& mesh, const Material& material, const unsigned int* indices, size_t indexCount, float depth = 0.0F, unsigned int pass = 0);
+
+	//stable, equal keys keep submission order
+	void Sort(void);
+	void Clear(void);
+	//drops the packets drawing with the mesh, material or shader, before it goes away
+	void Remove(const void* object);
+
+	bool IsEmpty(void) const { return m_packets.empty(); }
+	size_t GetCount(void) const { return m_packets.size(); }
+	const RenderPacket* GetPackets(void) const { return m_packets.data(); }
+	const InstanceTransform* GetInstances(void) const { return m_instances.data(); }
+	size_t GetInstanceCount(void) const { return m_instances.size(); }
+	const unsigned int* GetIndices(void) const { return m_indices.data(); }
+
+	static uint64_t MakeKey(unsigned int pass, uint32_t shader, uint32_t material, uint32_t mesh, float depth);
+
+private:
+	RenderPacket& AddPacket(const Mesh& mesh, const Material& material, float depth, unsigned int pass, int lod);
+	static uint32_t GetSortID(SortIDMap& ids, const void* object, int bits);
+};
@@ -0,0 +1,152 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+
+#include "Core\Graphics\RenderQueue.h"
+#include "Core\Graphics\GfxResourceTable.h"
+
+class GfxDevice;
+class Mesh;
+class Shader;
+
+enum class RenderCommandType { Clear, DrawQueue, ReleaseMesh, ReleaseShader, PrepareShader };
+
+struct RenderCommand
+{
+	RenderCommandType m_type;
+	uint32_t m_queue;			//DrawQueue, into the list queues
+	const void* m_object;		//mesh / shader, only an owner key for the releases
+	GfxHandle m_handle;
+};
+
+/*
+	Render Command List
+	What the main thread recorded for one frame, played in order by the render thread.
+	Every Flush closes a queue, so draws keep their place around the clears.
+*/
+class RenderCommandList
+{
+	friend class RenderThread;
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+private:
+	std::vector<RenderCommand> m_commands;
+	//kept across frames, with their buffers
+	std::vector<RenderQueue> m_queues;
+	size_t m_queueCount;
+	//ends with SwapBuffer, the last list (Stop) does not and ends the thread
+	bool m_present;
+	bool m_last;
+
+	Clock::time_point m_submitTime;
+	Clock::time_point m_startTime;
+	Clock::time_point m_presentTime;
+
+public:
+	RenderCommandList(void) : m_queues(1), m_queueCount(0), m_present(false), m_last(false) {}
+
+	//queue the draws are recorded into
+	RenderQueue& GetQueue(void) { return m_queues[m_queueCount]; }
+	//records the queue for drawing, returns the next one
+	RenderQueue& CloseQueue(void);
+
+	void Clear(void);
+	void PrepareShader(const Shader& shader);
+	void ReleaseMesh(const Mesh* mesh, GfxHandle handle);
+	void ReleaseShader(const Shader* shader, GfxHandle handle);
+	//drops the prepares of a shader going away before they run
+	void RemoveShader(const Shader* shader);
+	//drops the draws recorded with a mesh / material / shader going away, in every queue of the list
+	void RemoveDraws(const void* object);
+
+private:
+	void AddCommand(RenderCommandType type, const void* object, GfxHandle handle);
+	void Reset(void);
+};
+
+/*
+	Frame latency, in ms
+	Latency runs from Submit on the main thread to the present on the render thread
+*/
+struct RenderThreadStats
+{
+	unsigned int m_frameCount;		//frames presented
+	float m_lastLatency;
+	float m_averageLatency;
+	float m_maxLatency;
+	float m_lastRenderTime;			//render thread busy on the last frame
+	float m_lastWaitTime;			//main thread blocked on the last Submit
+	float m_totalWaitTime;
+
+	RenderThreadStats(void) : m_frameCount(0), m_lastLatency(0.0F), m_averageLatency(0.0F), m_maxLatency(0.0F),
+		m_lastRenderTime(0.0F), m_lastWaitTime(0.0F), m_totalWaitTime(0.0F) {}
+};
+
+/*
+	Render Thread
+	Owns the device, Init / Destroy and every call run on it, so the EGL context is
+	current there only. The main thread records frame N + 1 while frame N is played,
+	the two lists are handed over by the submitted / completed frame counters, the
+	mutex is only taken to sleep when one thread gets a whole frame ahead, and by
+	Signal only when a thread may be asleep.
+*/
+class RenderThread
+{
+private:
+	typedef std::chrono::steady_clock Clock;
+
+private:
+	GfxDevice* m_gfxDevice;
+	std::thread m_thread;
+
+	RenderCommandList m_lists[2];
+	//frame N is in m_lists[N & 1], frame 0 is none
+	std::atomic<uint32_t> m_submittedFrame;
+	std::atomic<uint32_t> m_completedFrame;
+	//main thread copy of m_submittedFrame
+	uint32_t m_recordFrame;
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	//threads in WaitFor past the fast check
+	std::atomic<int> m_sleepers;
+
+	RenderThreadStats m_stats;
+
+public:
+	RenderThread(void) : m_gfxDevice(nullptr), m_submittedFrame(0), m_completedFrame(0), m_recordFrame(0), m_sleepers(0) {}
+	~RenderThread(void) { Stop(); }
+
+	//the device is used by the thread only until Stop returns
+	void Start(GfxDevice* gfxDevice);
+	//plays what is left, destroys the device on the thread and joins it
+	void Stop(void);
+
+	//list of the frame the main thread records
+	RenderCommandList& GetCommandList(void) { return m_lists[(m_recordFrame + 1) & 1]; }
+	//hands the recorded frame over, returns once the frame before it is done
+	void Submit(void);
+	//frame the main thread records, what the draws mark their mesh / material / shader with
+	uint32_t GetRecordFrame(void) const { return m_recordFrame + 1; }
+	//returns once no submitted frame reads the object, at once unless the frame in flight drew with it
+	void WaitReleased(const GfxFrameStamp& frames);
+
+	//updated by Submit, main thread only
+	const RenderThreadStats& GetStats(void) const { return m_stats; }
+
+private:
+	void Publish(bool last);
+	void Run(void);
+	void Execute(RenderCommandList& list);
+
+	void WaitFor(const std::atomic<uint32_t>& counter, uint32_t frame);
+	void Signal(std::atomic<uint32_t>& counter, uint32_t frame);
+	void UpdateStats(const RenderCommandList& list, float waitTime);
+};
@@ -5,6 +5,7 @@
 #include <iostream>
 
 #include "Core\Container\String.h"
+#include "Core\Graphics\GfxResourceTable.h"
 
 /*
 	Shader
@@ -18,6 +19,10 @@ private:
 	String m_vertexShaderSource;
 	String m_fragmentShaderSource;
 
+	//device record, released with the shader
+	mutable GfxHandle m_gfxHandle;
+	mutable GfxFrameStamp m_gfxFrames;
+
 public:
 	/*
 		.vs -> vertex shader
@@ -26,9 +31,15 @@ public:
 		TODO : ShaderLab
 	*/
 	Shader(String shaderPath);
+	Shader(const Shader& other) : m_shaderPath(other.m_shaderPath), m_vertexShaderSource(other.m_vertexShaderSource), m_fragmentShaderSource(other.m_fragmentShaderSource) {}
+	~Shader(void);
 
 public:
 	const String& GetShaderPath(void) const { return m_shaderPath; }
 	const String& GetVertexShaderSource(void) const { return m_vertexShaderSource; };
 	const String& GetFragmentShaderSource(void) const { return m_fragmentShaderSource; };
+
+	GfxHandle GetGfxHandle(void) const { return m_gfxHandle; }
+	void SetGfxHandle(GfxHandle handle) const { m_gfxHandle = handle; }
+	GfxFrameStamp& GetGfxFrames(void) const { return m_gfxFrames; }
 };
\ No newline at end of file
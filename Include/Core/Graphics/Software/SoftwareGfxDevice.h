@@ -0,0 +1,118 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+#include "Core\Graphics\GfxDevice.h"
+
+/*
+	Software Graphics API
+	Tile based CPU rasterizer, renders into memory without a GPU or window.
+
+	DrawMesh transforms and bins the triangles into kTileSize tiles, the tiles
+	are rasterized in parallel on SwapBuffer (or on a Clear after draws).
+	Triangles of a tile keep submission order, so the output does not depend on
+	the thread count.
+
+	GLSL can't run here, every material is drawn like SimpleMesh: the vertex
+	position is used as clip position (w = 1), the fragment color is the flat
+	base color of the material, no texture or lighting.
+	Instanced draws apply the InstanceTransform first, like SimpleMeshInstanced.
+	Depth test is LESS against a [0, 1] depth buffer, no face culling.
+
+	Color is RGBA8 (R in the low byte). Rows are GetPitch() pixels apart.
+*/
+
+class SoftwareGfxDevice : public GfxDevice
+{
+public:
+	static const int kTileSize = 64;
+	static const int kSubPixelBits = 4;
+	//edge functions stay in 32 bits up to this size
+	static const int kMaxSize = 2048;
+
+	static const uint32_t kClearColor = 0xFF0000FF;
+
+private:
+	// setup of one triangle, all values at the center of pixel (m_minX, m_minY)
+	struct Triangle
+	{
+		int m_minX, m_minY, m_maxX, m_maxY;
+		int32_t m_w[3];			//edge functions, top left bias included
+		int32_t m_stepX[3];		//per pixel
+		int32_t m_stepY[3];
+		float m_z, m_zStepX, m_zStepY;
+		uint32_t m_color;
+	};
+
+	struct ScreenVertex
+	{
+		float x, y, z;
+	};
+
+private:
+	int m_width;
+	int m_height;
+	int m_pitch;
+	int m_tileCountX;
+	int m_tileCountY;
+
+	uint32_t* m_colorBuffer;
+	float* m_depthBuffer;
+
+	std::vector<ScreenVertex> m_vertices;	//DrawMesh scratch
+	uint32_t m_drawColor;					//base color of the current draw
+	std::vector<Triangle> m_triangles;
+	std::vector<std::vector<uint32_t> > m_bins;
+	bool m_clearPending;
+
+	//workers, the calling thread rasterizes too
+	int m_threadCount;
+	std::vector<std::thread> m_workers;
+	std::mutex m_mutex;
+	std::condition_variable m_wakeCondition;
+	std::condition_variable m_doneCondition;
+	unsigned int m_generation;
+	int m_busyWorkers;
+	bool m_quit;
+	std::atomic<int> m_nextTile;
+
+public:
+	//threadCount 0 uses every core
+	SoftwareGfxDevice(int width, int height, int threadCount = 0);
+
+	virtual void Init();
+	virtual void Destroy();
+	virtual void SwapBuffer();
+	virtual void Clear();
+	virtual void DrawMesh(const Mesh &mesh, const Material& material, int lod);
+	virtual void DrawMeshInstanced(const Mesh &mesh, const Material& material, const InstanceTransform* instances, int instanceCount, int lod);
+	virtual void DrawMeshIndexed(const Mesh &mesh, const Material& material, const unsigned int* indices, int indexCount);
+	//uses the base colors the packets recorded
+	virtual void DrawRenderQueue(const RenderQueue& queue);
+
+	//rasterizes everything binned so far
+	void Flush(void);
+
+	int GetWidth(void) const { return m_width; }
+	int GetHeight(void) const { return m_height; }
+	int GetPitch(void) const { return m_pitch; }
+	int GetThreadCount(void) const { return m_threadCount; }
+	const uint32_t* GetColorBuffer(void) const { return m_colorBuffer; }
+	const float* GetDepthBuffer(void) const { return m_depthBuffer; }
+
+private:
+	//transform nullptr draws the mesh as is
+	void DrawTransformed(const Mesh& mesh, const unsigned int* indices, unsigned int indexCount, const InstanceTransform* transform);
+	void ClipAndSetup(const ScreenVertex& v0, const ScreenVertex& v1, const ScreenVertex& v2);
+	void SetupTriangle(const ScreenVertex& v0, const ScreenVertex& v1, const ScreenVertex& v2);
+	void BinTriangle(const Triangle& triangle, uint32_t index);
+
+	void WorkerLoop(unsigned int generation);
+	void RasterTiles(void);
+	void RasterTile(int tile);
+	void RasterTriangle(const Triangle& triangle, int x0, int y0, int x1, int y1);
+};
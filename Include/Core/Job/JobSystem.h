@@ -0,0 +1,145 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cstddef>
+
+#include "Core\Misc\Singleton.h"
+
+class WorkStealingQueue;
+class JobCounter;
+
+//processes [begin, end) of whatever data points to
+typedef void(*JobFunction)(void* data, size_t begin, size_t end);
+
+struct Job
+{
+	JobFunction m_function;
+	void* m_data;
+	size_t m_begin;
+	size_t m_end;
+	JobCounter* m_counter;		//set by Run
+
+	Job(void) : m_function(nullptr), m_data(nullptr), m_begin(0), m_end(0), m_counter(nullptr) {}
+	Job(JobFunction function, void* data, size_t begin = 0, size_t end = 0) : m_function(function), m_data(data), m_begin(begin), m_end(end), m_counter(nullptr) {}
+};
+
+/*
+	Jobs left of a Run, zero when all of them are done
+	A job depending on others waits on their counter, the waiting thread runs jobs meanwhile.
+*/
+class JobCounter
+{
+	friend class JobSystem;
+
+private:
+	std::atomic<int> m_count;
+
+public:
+	JobCounter(void) : m_count(0) {}
+
+	bool IsDone(void) const { return m_count.load(std::memory_order_acquire) == 0; }
+	int GetCount(void) const { return m_count.load(std::memory_order_relaxed); }
+
+private:
+	JobCounter(const JobCounter&);
+	JobCounter& operator=(const JobCounter&);
+};
+
+/*
+	Job System
+	A work stealing deque per thread: the thread that called Start (index 0) and the
+	workers. Jobs go to the deque of the thread running Run, idle threads steal the
+	oldest jobs of the others, and sleep once nothing is left anywhere.
+
+	Jobs and counters belong to the caller and live until the counter is done. Threads
+	the system does not know (the render thread) have no deque, their jobs run inline.
+*/
+class JobSystem : public Singleton<JobSystem>
+{
+public:
+	//ParallelFor batches per thread, so a slow batch is made up by stealing the rest
+	static const int kBatchesPerThread = 4;
+	static const int kMaxParallelForJobs = 256;
+	//failed steal rounds before a worker sleeps
+	static const int kSpinCount = 64;
+
+private:
+	std::vector<WorkStealingQueue*> m_queues;
+	std::vector<std::thread> m_workers;
+	std::atomic<bool> m_exit;
+
+	//jobs pushed and not taken, workers sleep while it is 0
+	std::atomic<int> m_queuedJobs;
+	std::atomic<int> m_sleepingWorkers;
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wake;
+
+public:
+	JobSystem(void) : m_exit(false), m_queuedJobs(0), m_sleepingWorkers(0) {}
+
+	virtual void OnInit(void);
+	virtual void OnDestroy(void);
+
+public:
+	//the calling thread becomes thread 0, the workers are 1 to workerCount
+	void Start(int workerCount);
+	//every counter must be done
+	void Stop(void);
+
+	//hardware threads less the calling one
+	static int GetDefaultWorkerCount(void);
+	//workers and the thread that called Start
+	int GetThreadCount(void) const { return static_cast<int>(m_queues.size()); }
+	//0 for the thread that called Start, -1 outside the system
+	static int GetThreadIndex(void);
+
+	//counter goes up by jobCount and down as they finish, the jobs are not copied
+	void Run(Job* jobs, int jobCount, JobCounter& counter);
+	//runs jobs until counter is done
+	void Wait(const JobCounter& counter);
+
+	//body(begin, end) over [0, count) in batches of minBatch or more, returns when all are done
+	template<class Body>
+	void ParallelFor(size_t count, size_t minBatch, const Body& body);
+
+private:
+	void WorkerMain(int threadIndex);
+	Job* FindJob(int threadIndex);
+	void Execute(Job& job);
+	void WakeWorkers(int jobCount);
+
+	template<class Body>
+	static void RunBody(void* data, size_t begin, size_t end) { (*static_cast<const Body*>(data))(begin, end); }
+};
+
+template<class Body>
+void JobSystem::ParallelFor(size_t count, size_t minBatch, const Body& body)
+{
+	if (count == 0)
+		return;
+
+	minBatch = std::max<size_t>(minBatch, 1);
+	const size_t maxJobs = std::min<size_t>(kMaxParallelForJobs, static_cast<size_t>(GetThreadCount()) * kBatchesPerThread);
+	size_t jobCount = std::min(maxJobs, (count + minBatch - 1) / minBatch);
+	if (jobCount <= 1 || GetThreadIndex() < 0)
+	{
+		body(static_cast<size_t>(0), count);
+		return;
+	}
+
+	const size_t batch = (count + jobCount - 1) / jobCount;
+	jobCount = (count + batch - 1) / batch;
+
+	Job jobs[kMaxParallelForJobs];
+	void* data = const_cast<Body*>(&body);
+	for (size_t i = 0; i < jobCount; ++i)
+		jobs[i] = Job(&RunBody<Body>, data, i * batch, std::min(count, (i + 1) * batch));
+
+	JobCounter counter;
+	Run(jobs, static_cast<int>(jobCount), counter);
+	Wait(counter);
+}
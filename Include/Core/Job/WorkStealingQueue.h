@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+struct Job;
+
+/*
+	Chase-Lev work stealing deque (Le, Pop, Cohen, Zappa Nardelli 2013 for the C++11 orderings)
+	The owner thread pushes and pops at the bottom, LIFO so its jobs stay in cache,
+	any other thread steals from the top. Fixed capacity, Push fails when full.
+*/
+class WorkStealingQueue
+{
+public:
+	static const int kCapacity = 4096;
+
+private:
+	static const int64_t kMask = kCapacity - 1;
+
+	//own cache lines, the owner writes bottom while thieves hammer top
+	alignas(64) std::atomic<int64_t> m_top;
+	alignas(64) std::atomic<int64_t> m_bottom;
+	alignas(64) std::atomic<Job*> m_jobs[kCapacity];
+
+public:
+	WorkStealingQueue(void) : m_top(0), m_bottom(0) {}
+
+	//owner only
+	bool Push(Job* job)
+	{
+		const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+		const int64_t top = m_top.load(std::memory_order_acquire);
+		if (bottom - top >= kCapacity)
+			return false;
+
+		//release, a thief that sees the new bottom sees the job written before it
+		m_jobs[bottom & kMask].store(job, std::memory_order_relaxed);
+		m_bottom.store(bottom + 1, std::memory_order_release);
+		return true;
+	}
+
+	//owner only, newest first
+	Job* Pop(void)
+	{
+		const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = m_top.load(std::memory_order_relaxed);
+
+		if (top > bottom)
+		{
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		Job* job = m_jobs[bottom & kMask].load(std::memory_order_relaxed);
+		if (top == bottom)
+		{
+			//the last one, a thief may be taking it too
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				job = nullptr;
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+		return job;
+	}
+
+	//any thread, oldest first, nullptr when empty or another thread won the race
+	Job* Steal(void)
+	{
+		int64_t top = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+		if (top >= bottom)
+			return nullptr;
+
+		Job* job = m_jobs[top & kMask].load(std::memory_order_relaxed);
+		if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+		return job;
+	}
+
+	bool IsEmpty(void) const
+	{
+		return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+	}
+};
@@ -10,4 +10,17 @@ public:
 	static void Log(const String& logStr);
 	static void Warning(const String& warStr);
 	static void Error(const String& errStr);
+
+	//formatted like StringUtil::format, into a stack / scratch buffer instead of a new string
+	template<typename Arg, typename... Args>
+	static void Log(const char* format, const Arg& arg, const Args&... args) { LogFormat(format, fmt::make_format_args(arg, args...)); }
+	template<typename Arg, typename... Args>
+	static void Warning(const char* format, const Arg& arg, const Args&... args) { WarningFormat(format, fmt::make_format_args(arg, args...)); }
+	template<typename Arg, typename... Args>
+	static void Error(const char* format, const Arg& arg, const Args&... args) { ErrorFormat(format, fmt::make_format_args(arg, args...)); }
+
+private:
+	static void LogFormat(fmt::string_view format, fmt::format_args args);
+	static void WarningFormat(fmt::string_view format, fmt::format_args args);
+	static void ErrorFormat(fmt::string_view format, fmt::format_args args);
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <queue>
+#include <vector>
+#include <mutex>
 #include "Core\Misc\Singleton.h"
 #include "Core\Container\String.h"
 #include "Core\Time\Time.h"
@@ -22,9 +23,10 @@ private:
 	Time m_logTime;
 
 public:
-	LogData(const String& logStr, LogType logType);
+	LogData(const char* logStr, size_t length, LogType logType);
 
-	void ReUse(const String& logStr, LogType logType);
+	//keeps the capacity of the string, no allocation once it has seen a line as long
+	void ReUse(const char* logStr, size_t length, LogType logType);
 
 	LogType GetLogType(void) const { return m_logType; }
 	const String& GetLogString(void) const { return m_logStr; }
@@ -40,15 +42,20 @@ public:
 class LogManager : public Singleton<LogManager>
 {
 private:
-	std::queue<const LogData*> m_logBuffer;
-	const int LOG_BUFFER_MAX_SIZE = 100;
+	//ring of the last lines, the oldest is reused
+	std::vector<LogData*> m_logBuffer;
+	size_t m_logNext = 0;
+	static const int LOG_BUFFER_MAX_SIZE = 100;
+	//the render thread logs too
+	std::mutex m_logMutex;
 
 	//ʱʹһ
 	LogHandler *m_logHandler = nullptr;
 
 public:
 	int GetLogBufferCount(void) const { return m_logBuffer.size(); }
-	void Log(const String& logInfo, LogData::LogType logType);
+	void Log(const String& logInfo, LogData::LogType logType) { Log(logInfo.data(), logInfo.size(), logType); }
+	void Log(const char* logInfo, size_t length, LogData::LogType logType);
 
 	void SetLogHandler(LogHandler *logHandler) { m_logHandler = logHandler; }
 
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Vector3.h"
+#include "Vector4.h"
+
+class Matrix4x4;
+class Vector3Stream;
+
+/*
+	Frustum
+	Six planes pulled out of a view-projection matrix (OpenGL clip space,
+	-w <= z <= w). Planes are normalized and point inwards: a point p is
+	inside when Dot(plane.xyz, p) + plane.w >= 0 for every plane.
+*/
+
+class Frustum
+{
+public:
+	enum PlaneIndex
+	{
+		kPlaneLeft,
+		kPlaneRight,
+		kPlaneBottom,
+		kPlaneTop,
+		kPlaneNear,
+		kPlaneFar,
+		kPlaneCount
+	};
+
+private:
+	Vector4 m_planes[kPlaneCount];
+
+public:
+	Frustum() {}
+	explicit Frustum(const Matrix4x4& viewProjection) { Set(viewProjection); }
+
+	void Set(const Matrix4x4& viewProjection);
+
+	const Vector4& GetPlane(int index) const { return m_planes[index]; }
+	const Vector4* GetPlanes() const { return m_planes; }
+
+	//conservative, boxes crossing a frustum corner may pass
+	bool IsVisible(const Vector3& center, const Vector3& extents) const;
+	bool IsVisible(const Vector3& center, float radius) const;
+};
+
+/*
+	Batch culling
+	Bounds are SoA, AABBs as center + extents (half size), spheres as center + radius.
+	visibleMask gets one bit per object (bit i & 31 of word i >> 5), GetCullMaskSize words.
+	visibleIndices gets the indices of the visible objects in order, room for count entries.
+	Either output may be null. Returns the number of visible objects.
+*/
+
+inline size_t GetCullMaskSize(size_t count) { return (count + 31) >> 5; }
+
+size_t CullAABBs(const Frustum& frustum, const Vector3Stream& centers, const Vector3Stream& extents, uint32_t* visibleMask, uint32_t* visibleIndices);
+/// radii has centers.GetCount() elements
+size_t CullSpheres(const Frustum& frustum, const Vector3Stream& centers, const float* radii, uint32_t* visibleMask, uint32_t* visibleIndices);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 
 #ifndef kPI
 	#define kPI 3.14159265358979323846264338327950288419716939937510F
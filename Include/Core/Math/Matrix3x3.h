@@ -117,4 +117,29 @@ inline Matrix3x3 operator*(const Matrix3x3& lhs, const Matrix3x3& rhs)
 	Matrix3x3 temp;
 	MultiplyMatrices3x3(&lhs, &rhs, &temp);
 	return temp;
-}
\ No newline at end of file
+}
+
+inline Vector3 Matrix3x3::MultiplyVector3(const Vector3& v) const
+{
+	Vector3 res;
+	res.X = m_data[0] * v.X + m_data[3] * v.Y + m_data[6] * v.Z;
+	res.Y = m_data[1] * v.X + m_data[4] * v.Y + m_data[7] * v.Z;
+	res.Z = m_data[2] * v.X + m_data[5] * v.Y + m_data[8] * v.Z;
+	return res;
+}
+
+inline void Matrix3x3::MultiplyVector3(const Vector3& v, Vector3& output) const
+{
+	output.X = m_data[0] * v.X + m_data[3] * v.Y + m_data[6] * v.Z;
+	output.Y = m_data[1] * v.X + m_data[4] * v.Y + m_data[7] * v.Z;
+	output.Z = m_data[2] * v.X + m_data[5] * v.Y + m_data[8] * v.Z;
+}
+
+inline Vector3 Matrix3x3::MultiplyVector3Transpose(const Vector3& v) const
+{
+	Vector3 res;
+	res.X = Get(0, 0) * v.X + Get(1, 0) * v.Y + Get(2, 0) * v.Z;
+	res.Y = Get(0, 1) * v.X + Get(1, 1) * v.Y + Get(2, 1) * v.Z;
+	res.Z = Get(0, 2) * v.X + Get(1, 2) * v.Y + Get(2, 2) * v.Z;
+	return res;
+}
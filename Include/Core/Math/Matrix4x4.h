@@ -24,6 +24,13 @@ float ComputeUniformScale(const Matrix4x4& matrix);
 bool InvertMatrix4x4_Full(const float* m, float* out);
 bool InvertMatrix4x4_General3D(const float* m, float* out);
 
+// Closed form inverses for affine matrices (bottom row 0 0 0 1), SIMD dispatched.
+// Rigid: upper 3x3 is a rotation. UniformScale: rotation times a scale.
+// Affine: any invertible 3x3, same result as General3D.
+void InvertMatrix4x4_Rigid(const float* m, float* out);
+void InvertMatrix4x4_UniformScale(const float* m, float* out);
+bool InvertMatrix4x4_Affine(const float* m, float* out);
+
 //column major
 class Matrix4x4
 {
@@ -91,6 +98,15 @@ public:
 		return InvertMatrix4x4_General3D(inM.m_data, outM.m_data);
 	}
 
+	// Picks the cheapest exact inverse: rigid, uniform scale, affine, or Full for projections
+	static bool Invert(const Matrix4x4 &inM, Matrix4x4 &outM);
+
+	Matrix4x4& Invert()
+	{
+		Invert(*this, *this);
+		return *this;
+	}
+
 	Matrix4x4& Transpose();
 
 	Matrix4x4& SetIdentity();
@@ -152,6 +168,7 @@ void TransformPoints3x4(const Matrix4x4 &matrix, const Vector3* input, size_t in
 
 void MultiplyMatrices3x4(const Matrix4x4& lhs, const Matrix4x4& rhs, Matrix4x4& res);
 
+// The 4x4 products below run the best SIMD kernel for this CPU, see Simd\MathKernels.h
 void MultiplyMatrices4x4(const Matrix4x4* __restrict lhs, const Matrix4x4* __restrict rhs, Matrix4x4* __restrict res);
 void CopyMatrix4x4(const float* __restrict lhs, float* __restrict res);
 void TransposeMatrix4x4(const Matrix4x4* __restrict lhs, Matrix4x4* __restrict res);
@@ -159,7 +176,216 @@ void TransposeMatrix4x4(const Matrix4x4* __restrict lhs, Matrix4x4* __restrict r
 // foreach R[i] = A[i] * B[i]
 void MultiplyMatrixArray4x4(const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB,
 	Matrix4x4* __restrict arrayRes, size_t count);
+// foreach R[i] = Invert(A[i]), affine matrices are inverted 4 at a time.
+// input may be the same as output. Returns false if any matrix was singular (its result is zero)
+bool InvertMatrixArray4x4(const Matrix4x4* arrayA, Matrix4x4* arrayRes, size_t count);
 // foreach R[i] = BASE * A[i] * B[i]
 void MultiplyMatrixArrayWithBase4x4(const Matrix4x4* __restrict base,
 	const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB,
-	Matrix4x4* __restrict arrayRes, size_t count);
\ No newline at end of file
+	Matrix4x4* __restrict arrayRes, size_t count);
+
+inline Matrix4x4::Matrix4x4(const Matrix4x4 &other)
+{
+	CopyMatrix4x4(other.GetPtr(), GetPtr());
+}
+
+inline Matrix4x4& Matrix4x4::operator=(const Matrix4x4& m)
+{
+	CopyMatrix4x4(m.GetPtr(), GetPtr());
+	return *this;
+}
+
+inline Vector3 Matrix4x4::GetAxisX() const
+{
+	return Vector3(Get(0, 0), Get(1, 0), Get(2, 0));
+}
+
+inline Vector3 Matrix4x4::GetAxisY() const
+{
+	return Vector3(Get(0, 1), Get(1, 1), Get(2, 1));
+}
+
+inline Vector3 Matrix4x4::GetAxisZ() const
+{
+	return Vector3(Get(0, 2), Get(1, 2), Get(2, 2));
+}
+
+inline Vector3 Matrix4x4::GetAxis(int axis) const
+{
+	return Vector3(Get(0, axis), Get(1, axis), Get(2, axis));
+}
+
+inline Vector3 Matrix4x4::GetPosition() const
+{
+	return Vector3(Get(0, 3), Get(1, 3), Get(2, 3));
+}
+
+inline Vector4 Matrix4x4::GetRow(int row) const
+{
+	return Vector4(Get(row, 0), Get(row, 1), Get(row, 2), Get(row, 3));
+}
+
+inline Vector4 Matrix4x4::GetColumn(int col) const
+{
+	return Vector4(Get(0, col), Get(1, col), Get(2, col), Get(3, col));
+}
+
+inline void Matrix4x4::SetAxisX(const Vector3& v)
+{
+	Get(0, 0) = v.X; Get(1, 0) = v.Y; Get(2, 0) = v.Z;
+}
+
+inline void Matrix4x4::SetAxisY(const Vector3& v)
+{
+	Get(0, 1) = v.X; Get(1, 1) = v.Y; Get(2, 1) = v.Z;
+}
+
+inline void Matrix4x4::SetAxisZ(const Vector3& v)
+{
+	Get(0, 2) = v.X; Get(1, 2) = v.Y; Get(2, 2) = v.Z;
+}
+
+inline void Matrix4x4::SetAxis(int axis, const Vector3& v)
+{
+	Get(0, axis) = v.X; Get(1, axis) = v.Y; Get(2, axis) = v.Z;
+}
+
+inline void Matrix4x4::SetPosition(const Vector3& v)
+{
+	Get(0, 3) = v.X; Get(1, 3) = v.Y; Get(2, 3) = v.Z;
+}
+
+inline void Matrix4x4::SetRow(int row, const Vector4& v)
+{
+	Get(row, 0) = v.X; Get(row, 1) = v.Y; Get(row, 2) = v.Z; Get(row, 3) = v.W;
+}
+
+inline void Matrix4x4::SetColumn(int col, const Vector4& v)
+{
+	Get(0, col) = v.X; Get(1, col) = v.Y; Get(2, col) = v.Z; Get(3, col) = v.W;
+}
+
+inline Vector3 Matrix4x4::MultiplyPoint3(const Vector3& v) const
+{
+	Vector3 res;
+	res.X = m_data[0] * v.X + m_data[4] * v.Y + m_data[8] * v.Z + m_data[12];
+	res.Y = m_data[1] * v.X + m_data[5] * v.Y + m_data[9] * v.Z + m_data[13];
+	res.Z = m_data[2] * v.X + m_data[6] * v.Y + m_data[10] * v.Z + m_data[14];
+	return res;
+}
+
+inline void Matrix4x4::MultiplyPoint3(const Vector3& v, Vector3& output) const
+{
+	output.X = m_data[0] * v.X + m_data[4] * v.Y + m_data[8] * v.Z + m_data[12];
+	output.Y = m_data[1] * v.X + m_data[5] * v.Y + m_data[9] * v.Z + m_data[13];
+	output.Z = m_data[2] * v.X + m_data[6] * v.Y + m_data[10] * v.Z + m_data[14];
+}
+
+inline Vector3 Matrix4x4::MultiplyVector3(const Vector3& v) const
+{
+	Vector3 res;
+	res.X = m_data[0] * v.X + m_data[4] * v.Y + m_data[8] * v.Z;
+	res.Y = m_data[1] * v.X + m_data[5] * v.Y + m_data[9] * v.Z;
+	res.Z = m_data[2] * v.X + m_data[6] * v.Y + m_data[10] * v.Z;
+	return res;
+}
+
+inline void Matrix4x4::MultiplyVector3(const Vector3& v, Vector3& output) const
+{
+	output.X = m_data[0] * v.X + m_data[4] * v.Y + m_data[8] * v.Z;
+	output.Y = m_data[1] * v.X + m_data[5] * v.Y + m_data[9] * v.Z;
+	output.Z = m_data[2] * v.X + m_data[6] * v.Y + m_data[10] * v.Z;
+}
+
+inline bool Matrix4x4::PerspectiveMultiplyPoint3(const Vector3& v, Vector3& output) const
+{
+	Vector3 res;
+	float w;
+	res.X = Get(0, 0) * v.X + Get(0, 1) * v.Y + Get(0, 2) * v.Z + Get(0, 3);
+	res.Y = Get(1, 0) * v.X + Get(1, 1) * v.Y + Get(1, 2) * v.Z + Get(1, 3);
+	res.Z = Get(2, 0) * v.X + Get(2, 1) * v.Y + Get(2, 2) * v.Z + Get(2, 3);
+	w = Get(3, 0) * v.X + Get(3, 1) * v.Y + Get(3, 2) * v.Z + Get(3, 3);
+	if (abs(w) > 1.0e-7f)
+	{
+		float invW = 1.0f / w;
+		output.X = res.X * invW;
+		output.Y = res.Y * invW;
+		output.Z = res.Z * invW;
+		return true;
+	}
+	else
+	{
+		output.X = 0.0f;
+		output.Y = 0.0f;
+		output.Z = 0.0f;
+		return false;
+	}
+}
+
+inline Vector4 Matrix4x4::MultiplyVector4(const Vector4& v) const
+{
+	Vector4 res;
+	MultiplyVector4(v, res);
+	return res;
+}
+
+inline void Matrix4x4::MultiplyVector4(const Vector4& v, Vector4& output) const
+{
+	output.X = m_data[0] * v.X + m_data[4] * v.Y + m_data[8] * v.Z + m_data[12] * v.W;
+	output.Y = m_data[1] * v.X + m_data[5] * v.Y + m_data[9] * v.Z + m_data[13] * v.W;
+	output.Z = m_data[2] * v.X + m_data[6] * v.Y + m_data[10] * v.Z + m_data[14] * v.W;
+	output.W = m_data[3] * v.X + m_data[7] * v.Y + m_data[11] * v.Z + m_data[15] * v.W;
+}
+
+inline bool Matrix4x4::PerspectiveMultiplyVector3(const Vector3& v, Vector3& output) const
+{
+	Vector3 res;
+	float w;
+	res.X = Get(0, 0) * v.X + Get(0, 1) * v.Y + Get(0, 2) * v.Z;
+	res.Y = Get(1, 0) * v.X + Get(1, 1) * v.Y + Get(1, 2) * v.Z;
+	res.Z = Get(2, 0) * v.X + Get(2, 1) * v.Y + Get(2, 2) * v.Z;
+	w = Get(3, 0) * v.X + Get(3, 1) * v.Y + Get(3, 2) * v.Z;
+	if (abs(w) > 1.0e-7f)
+	{
+		float invW = 1.0f / w;
+		output.X = res.X * invW;
+		output.Y = res.Y * invW;
+		output.Z = res.Z * invW;
+		return true;
+	}
+	else
+	{
+		output.X = 0.0f;
+		output.Y = 0.0f;
+		output.Z = 0.0f;
+		return false;
+	}
+}
+
+inline Vector3 Matrix4x4::InverseMultiplyPoint3Affine(const Vector3& inV) const
+{
+	Vector3 v(inV.X - Get(0, 3), inV.Y - Get(1, 3), inV.Z - Get(2, 3));
+	Vector3 res;
+	res.X = Get(0, 0) * v.X + Get(1, 0) * v.Y + Get(2, 0) * v.Z;
+	res.Y = Get(0, 1) * v.X + Get(1, 1) * v.Y + Get(2, 1) * v.Z;
+	res.Z = Get(0, 2) * v.X + Get(1, 2) * v.Y + Get(2, 2) * v.Z;
+	return res;
+}
+
+inline Vector3 Matrix4x4::InverseMultiplyVector3Affine(const Vector3& v) const
+{
+	Vector3 res;
+	res.X = Get(0, 0) * v.X + Get(1, 0) * v.Y + Get(2, 0) * v.Z;
+	res.Y = Get(0, 1) * v.X + Get(1, 1) * v.Y + Get(2, 1) * v.Z;
+	res.Z = Get(0, 2) * v.X + Get(1, 2) * v.Y + Get(2, 2) * v.Z;
+	return res;
+}
+
+inline bool IsFinite(const Matrix4x4& f)
+{
+	return
+		std::isfinite(f.m_data[0]) & std::isfinite(f.m_data[1]) & std::isfinite(f.m_data[2]) &
+		std::isfinite(f.m_data[4]) & std::isfinite(f.m_data[5]) & std::isfinite(f.m_data[6]) &
+		std::isfinite(f.m_data[8]) & std::isfinite(f.m_data[9]) & std::isfinite(f.m_data[10]) &
+		std::isfinite(f.m_data[12]) & std::isfinite(f.m_data[13]) & std::isfinite(f.m_data[14]) & std::isfinite(f.m_data[15]);
+}
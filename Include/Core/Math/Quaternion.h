@@ -157,16 +157,6 @@ inline Quaternionf::Quaternionf(float inX, float inY, float inZ, float inW)
 	w = inW;
 }
 
-template<class TransferFunction> inline
-void Quaternionf::Transfer(TransferFunction& transfer)
-{
-	transfer.AddMetaFlag(kTransferUsingFlowMappingStyle);
-	TRANSFER(x);
-	TRANSFER(y);
-	TRANSFER(z);
-	TRANSFER(w);
-}
-
 inline void Quaternionf::Set(float inX, float inY, float inZ, float inW)
 {
 	x = inX;
@@ -404,5 +394,5 @@ inline Quaternionf NormalizeSafeIfUnnormalized(const Quaternionf& q)
 
 inline bool IsFinite(const Quaternionf& f)
 {
-	return isfinite(f.x) & isfinite(f.y) & isfinite(f.z) & isfinite(f.w);
+	return std::isfinite(f.x) & std::isfinite(f.y) & std::isfinite(f.z) & std::isfinite(f.w);
 }
\ No newline at end of file
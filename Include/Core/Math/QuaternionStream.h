@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include "Quaternion.h"
+#include "Vector3Stream.h"
+
+/*
+	QuaternionStream
+	Structure of arrays Quaternionf storage, same layout rules as Vector3Stream:
+	X, Y, Z and W in separate 32 byte aligned arrays padded to kWidth floats.
+	Padding lanes are scratch.
+*/
+
+class QuaternionStream
+{
+public:
+	static const size_t kWidth = Vector3Stream::kWidth;
+	static const size_t kAlignment = Vector3Stream::kAlignment;
+
+private:
+	float* m_data;				//X array, then Y, Z, W
+	size_t m_count;
+	size_t m_paddedCount;
+	size_t m_capacity;
+
+public:
+	QuaternionStream(void) : m_data(nullptr), m_count(0), m_paddedCount(0), m_capacity(0) {}
+	explicit QuaternionStream(size_t count);
+	QuaternionStream(const QuaternionStream& other);
+	~QuaternionStream(void);
+
+	QuaternionStream& operator=(const QuaternionStream& other);
+
+	//keeps existing elements, new elements are identity, padding is zero
+	//throws std::bad_alloc when out of memory, the stream is left as it was
+	void Resize(size_t count);
+	void Clear(void) { m_count = 0; m_paddedCount = 0; }
+
+	size_t GetCount(void) const { return m_count; }
+	size_t GetPaddedCount(void) const { return m_paddedCount; }
+
+	float* GetX(void) { return m_data; }
+	float* GetY(void) { return m_data + m_capacity; }
+	float* GetZ(void) { return m_data + m_capacity * 2; }
+	float* GetW(void) { return m_data + m_capacity * 3; }
+	const float* GetX(void) const { return m_data; }
+	const float* GetY(void) const { return m_data + m_capacity; }
+	const float* GetZ(void) const { return m_data + m_capacity * 2; }
+	const float* GetW(void) const { return m_data + m_capacity * 3; }
+
+	Quaternionf Get(size_t index) const { return Quaternionf(GetX()[index], GetY()[index], GetZ()[index], GetW()[index]); }
+	void Set(size_t index, const Quaternionf& q) { GetX()[index] = q.x; GetY()[index] = q.y; GetZ()[index] = q.z; GetW()[index] = q.w; }
+
+	// AoS -> SoA, resizes to count. inStride in bytes
+	void Load(const Quaternionf* input, size_t count) { Load(input, sizeof(Quaternionf), count); }
+	void Load(const Quaternionf* input, size_t inStride, size_t count);
+
+	// SoA -> AoS, writes GetCount() elements
+	void Store(Quaternionf* output) const { Store(output, sizeof(Quaternionf)); }
+	void Store(Quaternionf* output, size_t outStride) const;
+};
+
+class Matrix4x4;
+
+/*
+	Batch quaternion functions
+	Slerp is approximated: nlerp with a polynomial correction of t, so every
+	lane runs the same instructions. The result is off from an exact slerp
+	by less than 0.1 degree for any angle, and is always normalized.
+	Output is resized to the input count and may alias an input.
+*/
+
+/// Blends a[i] and b[i] by the same t.
+void Slerp(const QuaternionStream& a, const QuaternionStream& b, float t, QuaternionStream& output);
+/// Blends a[i] and b[i] by t[i], t has a.GetCount() elements.
+void Slerp(const QuaternionStream& a, const QuaternionStream& b, const float* t, QuaternionStream& output);
+/// Like NormalizeSafe(), near zero quaternions become identity.
+void NormalizeSafe(const QuaternionStream& input, QuaternionStream& output);
+
+/// Writes rot.GetCount() matrices, e.g. straight into a skinning palette. pos and scale must have the same count.
+void SetTRS(const Vector3Stream& pos, const QuaternionStream& rot, const Vector3Stream& scale, Matrix4x4* output);
+/// Rotation only matrices, same as QuaternionToMatrix(rot.Get(i), output[i]).
+void QuaternionToMatrix(const QuaternionStream& rot, Matrix4x4* output);
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "SimdConfig.h"
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+/*
+	CullWriter
+	Shared output side of the culling kernels. Kernels hand over the
+	visibility of 4 or 8 consecutive objects as movemask bits, blocks never
+	straddle a 32 bit mask word.
+	Internal linkage, every kernel translation unit gets its own copy built
+	for its instruction set (MathKernelsAVX.cpp is compiled with /arch:AVX).
+*/
+
+namespace
+{
+	struct CullWriter
+	{
+		uint32_t* m_mask;
+		uint32_t* m_indices;
+		uint32_t m_word;
+		size_t m_visible;
+		size_t m_end;			//one past the last lane written
+
+		CullWriter(uint32_t* mask, uint32_t* indices) : m_mask(mask), m_indices(indices), m_word(0), m_visible(0), m_end(0) {}
+
+		SIMD_FORCE_INLINE void Write(uint32_t bits, size_t index, size_t laneCount)
+		{
+			m_end = index + laneCount;
+			if (m_mask)
+			{
+				m_word |= bits << (index & 31);
+				if ((m_end & 31) == 0)
+				{
+					m_mask[index >> 5] = m_word;
+					m_word = 0;
+				}
+			}
+
+			if (m_indices)
+			{
+				while (bits != 0)
+				{
+					m_indices[m_visible++] = static_cast<uint32_t>(index + CountTrailingZeros(bits));
+					bits &= bits - 1;
+				}
+			}
+			else
+			{
+				m_visible += PopCount(bits);
+			}
+		}
+
+		//writes the last partial mask word
+		size_t Finish(void)
+		{
+			if (m_mask && (m_end & 31) != 0)
+				m_mask[m_end >> 5] = m_word;
+			return m_visible;
+		}
+
+		static SIMD_FORCE_INLINE uint32_t CountTrailingZeros(uint32_t bits)
+		{
+	#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward(&index, bits);
+			return index;
+	#else
+			return __builtin_ctz(bits);
+	#endif
+		}
+
+		static SIMD_FORCE_INLINE uint32_t PopCount(uint32_t bits)
+		{
+			bits = bits - ((bits >> 1) & 0x55555555U);
+			bits = (bits & 0x33333333U) + ((bits >> 2) & 0x33333333U);
+			return (((bits + (bits >> 4)) & 0x0F0F0F0FU) * 0x01010101U) >> 24;
+		}
+
+		//bits of the lanes that hold real objects
+		static SIMD_FORCE_INLINE uint32_t LaneMask(size_t index, size_t count, size_t laneCount)
+		{
+			return count - index >= laneCount ? (1U << laneCount) - 1 : (1U << (count - index)) - 1;
+		}
+	};
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "SimdConfig.h"
+
+class Vector3;
+class Vector3Stream;
+class QuaternionStream;
+class Matrix4x4;
+class Vector4;
+
+/*
+	Math Kernels
+	Hot math routines have one implementation per instruction set.
+	gMathKernels holds the ones picked for this CPU, it starts out pointing
+	at the scalar reference versions (constant initialized, so calls made
+	during static init are safe) and is upgraded before main.
+*/
+
+struct MathKernels
+{
+	void (*multiplyMatrices4x4)(const Matrix4x4* lhs, const Matrix4x4* rhs, Matrix4x4* res);
+	void (*multiplyMatrixArray4x4)(const Matrix4x4* arrayA, const Matrix4x4* arrayB, Matrix4x4* arrayRes, size_t count);
+	void (*multiplyMatrixArrayWithBase4x4)(const Matrix4x4* base, const Matrix4x4* arrayA, const Matrix4x4* arrayB, Matrix4x4* arrayRes, size_t count);
+
+	//packed AoS <-> SoA
+	void (*loadVector3Stream)(const Vector3* input, float* x, float* y, float* z, size_t count);
+	void (*storeVector3Stream)(const float* x, const float* y, const float* z, Vector3* output, size_t count);
+	//output already sized, SIMD versions run the padded count
+	void (*transformPointsStream3x3)(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output);
+	void (*transformPointsStream3x4)(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output);
+
+	//t is read at t[i * tStep], tStep 0 blends every pair by *t
+	void (*slerpQuaternionStream)(const QuaternionStream& a, const QuaternionStream& b, const float* t, size_t tStep, QuaternionStream& output);
+	void (*normalizeQuaternionStream)(const QuaternionStream& input, QuaternionStream& output);
+	//writes rot.GetCount() matrices, null pos/scale means zero/one
+	void (*setTRSStream)(const Vector3Stream* pos, const QuaternionStream& rot, const Vector3Stream* scale, Matrix4x4* output);
+
+	//affine inverses, m may be the same as out
+	void (*invertMatrix4x4Rigid)(const float* m, float* out);
+	void (*invertMatrix4x4UniformScale)(const float* m, float* out);
+	bool (*invertMatrix4x4Affine)(const float* m, float* out);
+	bool (*invertMatrixArray4x4Affine)(const Matrix4x4* arrayA, Matrix4x4* arrayRes, size_t count);
+
+	//6 frustum planes, mask and indices may be null, returns the visible count
+	size_t (*cullAABBStream)(const Vector4* planes, const Vector3Stream& centers, const Vector3Stream& extents, uint32_t* mask, uint32_t* indices);
+	size_t (*cullSphereStream)(const Vector4* planes, const Vector3Stream& centers, const float* radii, uint32_t* mask, uint32_t* indices);
+};
+
+extern MathKernels gMathKernels;
+
+//best level the running CPU supports
+SimdLevel GetSupportedSimdLevel(void);
+//level gMathKernels is currently bound to
+SimdLevel GetSimdLevel(void);
+//rebind gMathKernels, falls back to scalar if the CPU can't run the level. Returns the bound level.
+//not thread safe, meant for startup, tests and benchmarks
+SimdLevel SetSimdLevel(SimdLevel level);
+const char* GetSimdLevelName(SimdLevel level);
+
+/*
+	Per instruction set implementations
+	Always callable directly (e.g. from tests), as long as the CPU supports them
+*/
+
+//scalar reference, Matrix4x4.cpp
+void MultiplyMatrices4x4_Scalar(const Matrix4x4* __restrict lhs, const Matrix4x4* __restrict rhs, Matrix4x4* __restrict res);
+void MultiplyMatrixArray4x4_Scalar(const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB, Matrix4x4* __restrict arrayRes, size_t count);
+void MultiplyMatrixArrayWithBase4x4_Scalar(const Matrix4x4* __restrict base, const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB, Matrix4x4* __restrict arrayRes, size_t count);
+void InvertMatrix4x4_Rigid_Scalar(const float* m, float* out);
+void InvertMatrix4x4_UniformScale_Scalar(const float* m, float* out);
+bool InvertMatrix4x4_Affine_Scalar(const float* m, float* out);
+bool InvertMatrixArray4x4Affine_Scalar(const Matrix4x4* arrayA, Matrix4x4* arrayRes, size_t count);
+//Vector3Stream.cpp
+void LoadVector3Stream_Scalar(const Vector3* input, float* x, float* y, float* z, size_t count);
+void StoreVector3Stream_Scalar(const float* x, const float* y, const float* z, Vector3* output, size_t count);
+void TransformPointsStream3x3_Scalar(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output);
+void TransformPointsStream3x4_Scalar(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output);
+//QuaternionStream.cpp
+void SlerpQuaternionStream_Scalar(const QuaternionStream& a, const QuaternionStream& b, const float* t, size_t tStep, QuaternionStream& output);
+void NormalizeQuaternionStream_Scalar(const QuaternionStream& input, QuaternionStream& output);
+void SetTRSStream_Scalar(const Vector3Stream* pos, const QuaternionStream& rot, const Vector3Stream* scale, Matrix4x4* output);
+//Frustum.cpp
+size_t CullAABBStream_Scalar(const Vector4* planes, const Vector3Stream& centers, const Vector3Stream& extents, uint32_t* mask, uint32_t* indices);
+size_t CullSphereStream_Scalar(const Vector4* planes, const Vector3Stream& centers, const float* radii, uint32_t* mask, uint32_t* indices);
+
+#if SIMD_X86
+//Simd/MathKernelsSSE2.cpp
+void MultiplyMatrices4x4_SSE2(const Matrix4x4* __restrict lhs, const Matrix4x4* __restrict rhs, Matrix4x4* __restrict res);
+void MultiplyMatrixArray4x4_SSE2(const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB, Matrix4x4* __restrict arrayRes, size_t count);
+void MultiplyMatrixArrayWithBase4x4_SSE2(const Matrix4x4* __restrict base, const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB, Matrix4x4* __restrict arrayRes, size_t count);
+void LoadVector3Stream_SSE2(const Vector3* input, float* x, float* y, float* z, size_t count);
+void StoreVector3Stream_SSE2(const float* x, const float* y, const float* z, Vector3* output, size_t count);
+void TransformPointsStream3x3_SSE2(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output);
+void TransformPointsStream3x4_SSE2(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output);
+void SlerpQuaternionStream_SSE2(const QuaternionStream& a, const QuaternionStream& b, const float* t, size_t tStep, QuaternionStream& output);
+void NormalizeQuaternionStream_SSE2(const QuaternionStream& input, QuaternionStream& output);
+void SetTRSStream_SSE2(const Vector3Stream* pos, const QuaternionStream& rot, const Vector3Stream* scale, Matrix4x4* output);
+void InvertMatrix4x4_Rigid_SSE2(const float* m, float* out);
+void InvertMatrix4x4_UniformScale_SSE2(const float* m, float* out);
+bool InvertMatrix4x4_Affine_SSE2(const float* m, float* out);
+bool InvertMatrixArray4x4Affine_SSE2(const Matrix4x4* arrayA, Matrix4x4* arrayRes, size_t count);
+size_t CullAABBStream_SSE2(const Vector4* planes, const Vector3Stream& centers, const Vector3Stream& extents, uint32_t* mask, uint32_t* indices);
+size_t CullSphereStream_SSE2(const Vector4* planes, const Vector3Stream& centers, const float* radii, uint32_t* mask, uint32_t* indices);
+
+//Simd/MathKernelsAVXEntry.cpp, bodies in Simd/MathKernelsAVX.cpp
+void MultiplyMatrices4x4_AVX(const Matrix4x4* __restrict lhs, const Matrix4x4* __restrict rhs, Matrix4x4* __restrict res);
+void MultiplyMatrixArray4x4_AVX(const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB, Matrix4x4* __restrict arrayRes, size_t count);
+void MultiplyMatrixArrayWithBase4x4_AVX(const Matrix4x4* __restrict base, const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB, Matrix4x4* __restrict arrayRes, size_t count);
+void TransformPointsStream3x3_AVX(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output);
+void TransformPointsStream3x4_AVX(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output);
+//also used at the FMA level
+void SlerpQuaternionStream_AVX(const QuaternionStream& a, const QuaternionStream& b, const float* t, size_t tStep, QuaternionStream& output);
+void NormalizeQuaternionStream_AVX(const QuaternionStream& input, QuaternionStream& output);
+size_t CullAABBStream_AVX(const Vector4* planes, const Vector3Stream& centers, const Vector3Stream& extents, uint32_t* mask, uint32_t* indices);
+size_t CullSphereStream_AVX(const Vector4* planes, const Vector3Stream& centers, const float* radii, uint32_t* mask, uint32_t* indices);
+
+void MultiplyMatrices4x4_FMA(const Matrix4x4* __restrict lhs, const Matrix4x4* __restrict rhs, Matrix4x4* __restrict res);
+void MultiplyMatrixArray4x4_FMA(const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB, Matrix4x4* __restrict arrayRes, size_t count);
+void MultiplyMatrixArrayWithBase4x4_FMA(const Matrix4x4* __restrict base, const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB, Matrix4x4* __restrict arrayRes, size_t count);
+void TransformPointsStream3x3_FMA(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output);
+void TransformPointsStream3x4_FMA(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output);
+#endif
+
+#if SIMD_NEON
+//Simd/MathKernelsNEON.cpp
+void MultiplyMatrices4x4_NEON(const Matrix4x4* __restrict lhs, const Matrix4x4* __restrict rhs, Matrix4x4* __restrict res);
+void MultiplyMatrixArray4x4_NEON(const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB, Matrix4x4* __restrict arrayRes, size_t count);
+void MultiplyMatrixArrayWithBase4x4_NEON(const Matrix4x4* __restrict base, const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB, Matrix4x4* __restrict arrayRes, size_t count);
+void LoadVector3Stream_NEON(const Vector3* input, float* x, float* y, float* z, size_t count);
+void StoreVector3Stream_NEON(const float* x, const float* y, const float* z, Vector3* output, size_t count);
+void TransformPointsStream3x3_NEON(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output);
+void TransformPointsStream3x4_NEON(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output);
+void SlerpQuaternionStream_NEON(const QuaternionStream& a, const QuaternionStream& b, const float* t, size_t tStep, QuaternionStream& output);
+void NormalizeQuaternionStream_NEON(const QuaternionStream& input, QuaternionStream& output);
+void SetTRSStream_NEON(const Vector3Stream* pos, const QuaternionStream& rot, const Vector3Stream* scale, Matrix4x4* output);
+void InvertMatrix4x4_Rigid_NEON(const float* m, float* out);
+void InvertMatrix4x4_UniformScale_NEON(const float* m, float* out);
+bool InvertMatrix4x4_Affine_NEON(const float* m, float* out);
+bool InvertMatrixArray4x4Affine_NEON(const Matrix4x4* arrayA, Matrix4x4* arrayRes, size_t count);
+size_t CullAABBStream_NEON(const Vector4* planes, const Vector3Stream& centers, const Vector3Stream& extents, uint32_t* mask, uint32_t* indices);
+size_t CullSphereStream_NEON(const Vector4* planes, const Vector3Stream& centers, const float* radii, uint32_t* mask, uint32_t* indices);
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "SimdConfig.h"
+
+/*
+	AVX kernel bodies on plain float arrays
+	MathKernelsAVX.cpp is built with /arch:AVX on MSVC, so any inline function from a
+	shared header compiled there would be VEX encoded, and the linker may keep that copy
+	for SSE2 callers too. That file includes only this header, CullWriter.h (internal
+	linkage) and the intrinsics. The _AVX / _FMA entries declared in MathKernels.h live
+	in MathKernelsAVXEntry.cpp, they unpack their arguments and call these.
+*/
+
+#if SIMD_X86
+
+namespace AVXKernels
+{
+	//same as Frustum::kPlaneCount, planes are { X, Y, Z, W } float quads
+	static const int kPlaneCount = 6;
+
+	//arrays of a Vector3Stream / QuaternionStream, 32 byte aligned, w unused for Vector3Stream
+	struct StreamIn
+	{
+		const float* x;
+		const float* y;
+		const float* z;
+		const float* w;
+	};
+
+	struct StreamOut
+	{
+		float* x;
+		float* y;
+		float* z;
+		float* w;
+	};
+
+	//matrices are 16 floats column major, arrays are tightly packed
+	void MultiplyMatrices4x4_AVX(const float* __restrict lhs, const float* __restrict rhs, float* __restrict res);
+	void MultiplyMatrixArray4x4_AVX(const float* __restrict arrayA, const float* __restrict arrayB, float* __restrict arrayRes, size_t count);
+	void MultiplyMatrixArrayWithBase4x4_AVX(const float* __restrict base, const float* __restrict arrayA, const float* __restrict arrayB, float* __restrict arrayRes, size_t count);
+	void MultiplyMatrices4x4_FMA(const float* __restrict lhs, const float* __restrict rhs, float* __restrict res);
+	void MultiplyMatrixArray4x4_FMA(const float* __restrict arrayA, const float* __restrict arrayB, float* __restrict arrayRes, size_t count);
+	void MultiplyMatrixArrayWithBase4x4_FMA(const float* __restrict base, const float* __restrict arrayA, const float* __restrict arrayB, float* __restrict arrayRes, size_t count);
+
+	//paddedCount is a multiple of 8
+	void TransformPointsStream_AVX(const float* matrix, bool translate, const StreamIn& input, const StreamOut& output, size_t paddedCount);
+	void TransformPointsStream_FMA(const float* matrix, bool translate, const StreamIn& input, const StreamOut& output, size_t paddedCount);
+
+	void SlerpQuaternionStream_AVX(const StreamIn& a, const StreamIn& b, const float* t, size_t tStep, const StreamOut& output, size_t count, size_t paddedCount, float epsilon);
+	void NormalizeQuaternionStream_AVX(const StreamIn& input, const StreamOut& output, size_t paddedCount, float epsilon);
+
+	size_t CullAABBStream_AVX(const float* planes, const StreamIn& centers, const StreamIn& extents, size_t count, uint32_t* mask, uint32_t* indices);
+	size_t CullSphereStream_AVX(const float* planes, const StreamIn& centers, const float* radii, size_t count, uint32_t* mask, uint32_t* indices);
+}
+
+#endif
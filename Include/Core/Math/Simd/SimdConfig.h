@@ -0,0 +1,47 @@
+#pragma once
+
+/*
+	SIMD Config
+	Which instruction sets can be compiled for the current target.
+	The one actually used is picked at startup, see MathKernels.h
+*/
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define SIMD_X86 1
+	#define SIMD_NEON 0
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+	#define SIMD_X86 0
+	#define SIMD_NEON 1
+#else
+	#define SIMD_X86 0
+	#define SIMD_NEON 0
+#endif
+
+// AVX/FMA kernels live next to SSE2 code in an x86 build, so they are
+// enabled per function on gcc/clang. MSVC emits any intrinsic without a
+// switch, the AVX translation units get /arch:AVX for VEX encoding.
+// Those must not compile inline code of shared headers, see MathKernelsAVX.h.
+#if defined(_MSC_VER) && !defined(__clang__)
+	#define SIMD_TARGET_AVX
+	#define SIMD_TARGET_FMA
+	#define SIMD_ALIGN(bytes) __declspec(align(bytes))
+	#define SIMD_FORCE_INLINE __forceinline
+#else
+	#define SIMD_TARGET_AVX __attribute__((target("avx")))
+	#define SIMD_TARGET_FMA __attribute__((target("avx,fma")))
+	#define SIMD_ALIGN(bytes) __attribute__((aligned(bytes)))
+	#define SIMD_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+//how many matrices ahead the array kernels prefetch
+#define SIMD_PREFETCH_DISTANCE 8
+
+enum SimdLevel
+{
+	kSimdScalar,
+	kSimdSSE2,
+	kSimdAVX,
+	kSimdFMA,		//AVX + FMA3
+	kSimdNEON,
+	kSimdLevelCount
+};
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Core\Misc\EnumFlags.h"
+#include "Core/Misc/EnumFlags.h"
 
 enum TransformType
 {
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include "Vector3.h"
+
+/*
+	Vector3Stream
+	Structure of arrays Vector3 storage for batch kernels.
+	X, Y and Z live in separate arrays, each 32 byte aligned and padded to
+	a multiple of kWidth floats, so kernels can run whole AVX registers
+	without a scalar tail. Padding lanes are scratch: Resize zeroes them,
+	kernels may write anything there.
+*/
+
+class Vector3Stream
+{
+public:
+	static const size_t kWidth = 8;			//floats per AVX register
+	static const size_t kAlignment = 32;
+
+private:
+	float* m_data;				//X array, then Y, then Z
+	size_t m_count;
+	size_t m_paddedCount;
+	size_t m_capacity;			//padded count the allocation can hold
+
+public:
+	Vector3Stream(void) : m_data(nullptr), m_count(0), m_paddedCount(0), m_capacity(0) {}
+	explicit Vector3Stream(size_t count);
+	Vector3Stream(const Vector3Stream& other);
+	~Vector3Stream(void);
+
+	Vector3Stream& operator=(const Vector3Stream& other);
+
+	//keeps existing elements, new elements and padding are zero
+	//throws std::bad_alloc when out of memory, the stream is left as it was
+	void Resize(size_t count);
+	void Clear(void) { m_count = 0; m_paddedCount = 0; }
+
+	size_t GetCount(void) const { return m_count; }
+	size_t GetPaddedCount(void) const { return m_paddedCount; }
+
+	float* GetX(void) { return m_data; }
+	float* GetY(void) { return m_data + m_capacity; }
+	float* GetZ(void) { return m_data + m_capacity * 2; }
+	const float* GetX(void) const { return m_data; }
+	const float* GetY(void) const { return m_data + m_capacity; }
+	const float* GetZ(void) const { return m_data + m_capacity * 2; }
+
+	Vector3 Get(size_t index) const { return Vector3(GetX()[index], GetY()[index], GetZ()[index]); }
+	void Set(size_t index, const Vector3& v) { GetX()[index] = v.X; GetY()[index] = v.Y; GetZ()[index] = v.Z; }
+
+	// AoS -> SoA, resizes to count. inStride in bytes, e.g. sizeof(Vertex) to pull positions out of a vertex array
+	void Load(const Vector3* input, size_t count) { Load(input, sizeof(Vector3), count); }
+	void Load(const Vector3* input, size_t inStride, size_t count);
+
+	// SoA -> AoS, writes GetCount() elements
+	void Store(Vector3* output) const { Store(output, sizeof(Vector3)); }
+	void Store(Vector3* output, size_t outStride) const;
+};
+
+class Matrix4x4;
+
+/// Transforms a whole stream, output is resized to the input count. input may be the same as output.
+void TransformPoints3x3(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output);
+void TransformPoints3x4(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output);
@@ -55,3 +55,33 @@ inline Vector4 operator*(const Vector4& lhs, const Vector4& rhs) { return Vector
 inline Vector4 operator*(const Vector4& inV, const float s) { return Vector4(inV.X * s, inV.Y * s, inV.Z * s, inV.W * s); }
 inline Vector4 operator+(const Vector4& lhs, const Vector4& rhs) { return Vector4(lhs.X + rhs.X, lhs.Y + rhs.Y, lhs.Z + rhs.Z, lhs.W + rhs.W); }
 inline Vector4 operator-(const Vector4& lhs, const Vector4& rhs) { return Vector4(lhs.X - rhs.X, lhs.Y - rhs.Y, lhs.Z - rhs.Z, lhs.W - rhs.W); }
+
+inline float Vector4::Dot(const Vector4 & lhs, const Vector4 & rhs)
+{
+	return lhs.X * rhs.X + lhs.Y * rhs.Y + lhs.Z * rhs.Z + lhs.W * rhs.W;
+}
+
+inline float Vector4::SqrMagnitude(const Vector4 & inV)
+{
+	return Dot(inV, inV);
+}
+
+inline float Vector4::Magnitude(const Vector4 & inV)
+{
+	return sqrt(Dot(inV, inV));
+}
+
+inline bool Vector4::IsFinite(const Vector4 & f)
+{
+	return std::isfinite(f.X) & std::isfinite(f.Y) & std::isfinite(f.Z) && std::isfinite(f.W);
+}
+
+inline bool Vector4::CompareApproximately(const Vector4 & inV0, const Vector4 & inV1, const float inMaxDist)
+{
+	return SqrMagnitude(inV1 - inV0) <= inMaxDist * inMaxDist;
+}
+
+inline Vector4 Vector4::Lerp(const Vector4 & from, const Vector4 & to, float t)
+{
+	return to * t + from * (1.0F - t);
+}
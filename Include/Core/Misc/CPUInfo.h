@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Core/Misc/EnumFlags.h"
+
+/*
+	CPU feature detection
+	Queried once, the result is cached for the lifetime of the process
+*/
+
+enum CPUFeature
+{
+	kCPUFeatureNone = 0,
+	kCPUFeatureSSE2 = 1 << 0,
+	kCPUFeatureSSE41 = 1 << 1,
+	kCPUFeatureAVX = 1 << 2,		//only set when the OS saves the YMM state
+	kCPUFeatureAVX2 = 1 << 3,
+	kCPUFeatureFMA = 1 << 4,
+	kCPUFeatureNEON = 1 << 5
+};
+ENUM_FLAGS(CPUFeature);
+
+CPUFeature GetCPUFeatures(void);
+
+inline bool HasCPUFeature(CPUFeature feature) { return HasAllFlags(GetCPUFeatures(), feature); }
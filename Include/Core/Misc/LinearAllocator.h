@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/*
+	Linear Allocator
+	Bump allocation out of one block, nothing is freed on its own: Reset frees it all,
+	Rewind everything after a marker. Requests past the block go to the heap until the
+	next Reset, which grows the block to the high-water mark, so a steady workload
+	stops touching the heap after its first frame. One thread at a time.
+*/
+class LinearAllocator
+{
+public:
+	static const size_t kDefaultAlignment = 16;
+
+	struct Marker
+	{
+		size_t m_offset;
+		size_t m_overflowCount;
+		size_t m_overflowBytes;
+	};
+
+private:
+	const char* m_name;
+	char* m_block;			//made on the first Allocate
+	size_t m_capacity;
+	size_t m_offset;
+
+	//heap blocks past the block, freed by Reset / Rewind
+	std::vector<void*> m_overflow;
+	size_t m_overflowBytes;
+	size_t m_overflowTotal;	//every overflow so far
+
+	//most bytes in use at once, since the last Reset and ever
+	size_t m_peak;
+	size_t m_highWater;
+
+public:
+	explicit LinearAllocator(size_t capacity, const char* name = "");
+	~LinearAllocator(void);
+
+	void* Allocate(size_t size, size_t alignment = kDefaultAlignment);
+	template<class T>
+	T* Allocate(size_t count) { return static_cast<T*>(Allocate(count * sizeof(T), alignof(T) > kDefaultAlignment ? alignof(T) : kDefaultAlignment)); }
+
+	void Reset(void);
+	Marker GetMarker(void) const;
+	void Rewind(const Marker& marker);
+
+	const char* GetName(void) const { return m_name; }
+	size_t GetUsed(void) const { return m_offset + m_overflowBytes; }
+	size_t GetCapacity(void) const { return m_capacity; }
+	size_t GetHighWater(void) const { return m_highWater; }
+	size_t GetOverflowCount(void) const { return m_overflowTotal; }
+
+private:
+	LinearAllocator(const LinearAllocator&);
+	LinearAllocator& operator=(const LinearAllocator&);
+};
+
+/*
+	STL allocator over a LinearAllocator, deallocate does nothing
+	The container must be gone before the allocator is reset / rewound.
+*/
+template<class T>
+class LinearStlAllocator
+{
+	template<class U> friend class LinearStlAllocator;
+
+public:
+	typedef T value_type;
+
+private:
+	LinearAllocator* m_allocator;
+
+public:
+	explicit LinearStlAllocator(LinearAllocator& allocator) : m_allocator(&allocator) {}
+	template<class U>
+	LinearStlAllocator(const LinearStlAllocator<U>& other) : m_allocator(other.m_allocator) {}
+
+	T* allocate(size_t count) { return m_allocator->Allocate<T>(count); }
+	void deallocate(T*, size_t) {}
+
+	template<class U>
+	struct rebind { typedef LinearStlAllocator<U> other; };
+
+	template<class U>
+	bool operator==(const LinearStlAllocator<U>& other) const { return m_allocator == other.m_allocator; }
+	template<class U>
+	bool operator!=(const LinearStlAllocator<U>& other) const { return m_allocator != other.m_allocator; }
+};
+
+/*
+	Scratch stack of the calling thread
+	Temp memory for the length of a scope, scopes nest and unwind in order.
+	Every thread gets its own stack on first use.
+*/
+class ScratchScope
+{
+public:
+	static const size_t kStackSize = 256 << 10;
+
+private:
+	LinearAllocator& m_allocator;
+	LinearAllocator::Marker m_marker;
+
+public:
+	ScratchScope(void);
+	~ScratchScope(void);
+
+	LinearAllocator& GetAllocator(void) { return m_allocator; }
+	void* Allocate(size_t size, size_t alignment = LinearAllocator::kDefaultAlignment) { return m_allocator.Allocate(size, alignment); }
+	template<class T>
+	T* Allocate(size_t count) { return m_allocator.Allocate<T>(count); }
+
+	//highest high-water mark of every thread's stack
+	static size_t GetHighWater(void);
+
+private:
+	ScratchScope(const ScratchScope&);
+	ScratchScope& operator=(const ScratchScope&);
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+
+#if defined(_MSC_VER)
+	#include <malloc.h>
+#endif
+
+/*
+	Aligned heap memory
+	alignment must be a power of two and a multiple of sizeof(void*)
+*/
+
+inline void* AlignedMalloc(size_t size, size_t alignment)
+{
+#if defined(_MSC_VER)
+	return _aligned_malloc(size, alignment);
+#else
+	void* p = nullptr;
+	if (posix_memalign(&p, alignment, size) != 0)
+		return nullptr;
+	return p;
+#endif
+}
+
+inline void AlignedFree(void* p)
+{
+#if defined(_MSC_VER)
+	_aligned_free(p);
+#else
+	free(p);
+#endif
+}
+
+// rounds value up to a multiple of alignment (power of two)
+inline size_t AlignSize(size_t value, size_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
@@ -1,6 +1,22 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+
 template<class T>
 inline T* Stride(T* p, size_t offset)
 {
 	return reinterpret_cast<T*>((char*)p + offset);
+}
+
+//FNV-1a, pass the last result as seed to hash several buffers as one
+inline uint64_t HashFNV1a64(const void* data, size_t size, uint64_t seed = 14695981039346656037ULL)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
 }
\ No newline at end of file
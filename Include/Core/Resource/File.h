@@ -1,4 +1,6 @@
 #pragma once
+#include <vector>
+
 #include "Core\Container\String.h"
 #include "Core\Log\Debug.h"
 
@@ -10,4 +12,10 @@ class Resource
 {
 public:
 	static int ReadTextFile(String fileName, String& fileContent);
+
+	//-1 when the file can't be opened, no error is logged (cache files may be missing)
+	static int ReadBinaryFile(String fileName, std::vector<char>& fileContent);
+	static bool WriteBinaryFile(String fileName, const void* data, size_t size);
+	//true when the directory exists afterwards
+	static bool MakeDirectory(String directory);
 };
\ No newline at end of file
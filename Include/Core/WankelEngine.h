@@ -28,5 +28,6 @@ public:
 	virtual void OnUpdate();
 
 protected:
+	virtual void OnLogInit(void) {}	//Platform log handler, before anything else logs
 	void AfterInit(void);	//After derived engine init all success
 };
@@ -11,4 +11,7 @@ public:
 	virtual void OnInit();
 	virtual void OnDestroy();
 	virtual void OnUpdate();
+
+protected:
+	virtual void OnLogInit();
 };
\ No newline at end of file
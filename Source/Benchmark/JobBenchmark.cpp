@@ -0,0 +1,328 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "Core\Job\JobSystem.h"
+
+/*
+	JobBenchmark
+	Runs the same workloads on the job system with 1 to N threads and reports the
+	best sample time, the speedup over one thread and the efficiency (speedup / threads).
+
+	WankelJobBench [--json file] [--threads max] [--filter text] [--quick]
+*/
+
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	struct Options
+	{
+		const char* jsonPath;
+		const char* filter;
+		int maxThreads;
+		double minTime;			//seconds per sample
+		int samples;
+
+		Options(void) : jsonPath(nullptr), filter(nullptr), maxThreads(0), minTime(0.05), samples(5) {}
+	};
+
+	struct Result
+	{
+		std::string name;
+		int threads;
+		double msPerRun;
+		double speedup;
+		double efficiency;
+	};
+
+	// keeps the optimizer from dropping the measured work
+	volatile float gSink;
+
+	/* Runner */
+
+	class Runner
+	{
+	private:
+		const Options& m_options;
+		std::vector<Result> m_results;
+
+	public:
+		explicit Runner(const Options& options) : m_options(options) {}
+
+		const std::vector<Result>& GetResults(void) const { return m_results; }
+
+		bool IsEnabled(const char* name) const
+		{
+			return m_options.filter == nullptr || strstr(name, m_options.filter) != nullptr;
+		}
+
+		// body() is one run of the workload
+		template<class Body>
+		void Run(const char* name, int threads, Body body)
+		{
+			size_t repeat = 1;
+			for (;;)
+			{
+				const Clock::time_point start = Clock::now();
+				for (size_t r = 0; r < repeat; ++r)
+					body();
+				const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+				if (seconds >= m_options.minTime || repeat >= (size_t(1) << 24))
+					break;
+				repeat *= seconds > 0.0 ? std::max<size_t>(2, static_cast<size_t>(m_options.minTime / seconds)) : 16;
+			}
+
+			double best = 1e30;
+			for (int s = 0; s < m_options.samples; ++s)
+			{
+				const Clock::time_point start = Clock::now();
+				for (size_t r = 0; r < repeat; ++r)
+					body();
+				best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+			}
+
+			Result result;
+			result.name = name;
+			result.threads = threads;
+			result.msPerRun = best * 1e3 / repeat;
+			// the 1 thread run of the same workload is the base
+			result.speedup = 1.0;
+			for (size_t i = 0; i < m_results.size(); ++i)
+			{
+				if (m_results[i].name == name && m_results[i].threads == 1)
+					result.speedup = m_results[i].msPerRun / result.msPerRun;
+			}
+			result.efficiency = result.speedup / threads;
+			m_results.push_back(result);
+
+			printf("%-24s %3d threads %10.4f ms %7.2fx %6.1f%%\n", name, threads, result.msPerRun, result.speedup, result.efficiency * 100.0);
+		}
+	};
+
+	/* Workloads */
+
+	// scheduling cost alone, jobs doing nothing
+	void RunEmptyJobs(Runner& runner, int threads)
+	{
+		const int kJobCount = 256;
+		std::vector<Job> jobs(kJobCount);
+		for (int i = 0; i < kJobCount; ++i)
+			jobs[i] = Job([](void*, size_t, size_t) {}, nullptr);
+
+		if (runner.IsEnabled("EmptyJobs"))
+			runner.Run("EmptyJobs", threads, [&]()
+			{
+				JobCounter counter;
+				JobSystem::Instance()->Run(jobs.data(), kJobCount, counter);
+				JobSystem::Instance()->Wait(counter);
+			});
+	}
+
+	// arithmetic bound, every element the same cost
+	void RunCompute(Runner& runner, int threads)
+	{
+		const size_t kCount = 1 << 16;
+		std::vector<float> input(kCount), out(kCount);
+		for (size_t i = 0; i < kCount; ++i)
+			input[i] = rand() / static_cast<float>(RAND_MAX);
+
+		if (runner.IsEnabled("ParallelFor.Compute"))
+			runner.Run("ParallelFor.Compute", threads, [&]()
+			{
+				JobSystem::Instance()->ParallelFor(kCount, 256, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; ++i)
+					{
+						float x = input[i];
+						for (int k = 0; k < 16; ++k)
+							x = sqrtf(x * x + 1.0F) * 0.5F + sinf(x) * 0.25F;
+						out[i] = x;
+					}
+				});
+			});
+	}
+
+	// memory bound, 48 MB read and written per run
+	void RunStream(Runner& runner, int threads)
+	{
+		const size_t kCount = 4 << 20;
+		std::vector<float> x(kCount * 3), out(kCount * 3);
+		for (size_t i = 0; i < x.size(); ++i)
+			x[i] = rand() / static_cast<float>(RAND_MAX);
+
+		if (runner.IsEnabled("ParallelFor.Stream"))
+			runner.Run("ParallelFor.Stream", threads, [&]()
+			{
+				JobSystem::Instance()->ParallelFor(kCount, 4096, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; ++i)
+					{
+						const float* p = &x[i * 3];
+						out[i * 3] = p[0] * 0.8F - p[1] * 0.6F + 1.0F;
+						out[i * 3 + 1] = p[0] * 0.6F + p[1] * 0.8F + 2.0F;
+						out[i * 3 + 2] = p[2] + 3.0F;
+					}
+				});
+			});
+	}
+
+	// cost grows along the range, the threads done first steal from the rest
+	void RunImbalanced(Runner& runner, int threads)
+	{
+		const size_t kCount = 4096;
+		std::vector<float> out(kCount);
+
+		if (runner.IsEnabled("ParallelFor.Imbalanced"))
+			runner.Run("ParallelFor.Imbalanced", threads, [&]()
+			{
+				JobSystem::Instance()->ParallelFor(kCount, 16, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; ++i)
+					{
+						float x = static_cast<float>(i);
+						for (size_t k = 0; k < i / 16; ++k)
+							x = sqrtf(x + 1.0F);
+						out[i] = x;
+					}
+				});
+				gSink = out[kCount - 1];
+			});
+	}
+
+	// jobs running jobs and waiting on them, 8 ^ 3 leaves
+	struct NestedTask
+	{
+		int depth;
+		float result;
+	};
+
+	void RunNestedTask(void* data, size_t, size_t)
+	{
+		NestedTask& task = *static_cast<NestedTask*>(data);
+		if (task.depth == 0)
+		{
+			float x = 1.0F;
+			for (int k = 0; k < 2000; ++k)
+				x = sqrtf(x + 1.0F);
+			task.result = x;
+			return;
+		}
+
+		const int kFanOut = 8;
+		NestedTask children[kFanOut];
+		Job jobs[kFanOut];
+		for (int i = 0; i < kFanOut; ++i)
+		{
+			children[i].depth = task.depth - 1;
+			jobs[i] = Job(&RunNestedTask, &children[i]);
+		}
+
+		JobCounter counter;
+		JobSystem::Instance()->Run(jobs, kFanOut, counter);
+		JobSystem::Instance()->Wait(counter);
+
+		task.result = 0.0F;
+		for (int i = 0; i < kFanOut; ++i)
+			task.result += children[i].result;
+	}
+
+	void RunNested(Runner& runner, int threads)
+	{
+		if (runner.IsEnabled("Nested"))
+			runner.Run("Nested", threads, [&]()
+			{
+				NestedTask root = { 3, 0.0F };
+				RunNestedTask(&root, 0, 0);
+				gSink = root.result;
+			});
+	}
+
+	/* Output */
+
+	bool WriteJson(const char* path, const std::vector<Result>& results)
+	{
+		FILE* file = fopen(path, "w");
+		if (file == nullptr)
+			return false;
+
+		fprintf(file, "{\n\t\"benchmarks\": [\n");
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const Result& r = results[i];
+			fprintf(file, "\t\t{ \"name\": \"%s\", \"threads\": %d, \"msPerRun\": %.5f, \"speedup\": %.3f, \"efficiency\": %.3f }%s\n",
+				r.name.c_str(), r.threads, r.msPerRun, r.speedup, r.efficiency, i + 1 < results.size() ? "," : "");
+		}
+		fprintf(file, "\t]\n}\n");
+		fclose(file);
+		return true;
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const char* arg = argv[i];
+			const bool hasValue = i + 1 < argc;
+			if (strcmp(arg, "--json") == 0 && hasValue)
+				options.jsonPath = argv[++i];
+			else if (strcmp(arg, "--filter") == 0 && hasValue)
+				options.filter = argv[++i];
+			else if (strcmp(arg, "--threads") == 0 && hasValue)
+			{
+				options.maxThreads = atoi(argv[++i]);
+				if (options.maxThreads <= 0)
+					return false;
+			}
+			else if (strcmp(arg, "--quick") == 0)
+			{
+				options.minTime = 0.01;
+				options.samples = 2;
+			}
+			else
+				return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		printf("usage: %s [--json file] [--threads max] [--filter text] [--quick]\n", argv[0]);
+		return 1;
+	}
+	if (options.maxThreads == 0)
+		options.maxThreads = JobSystem::GetDefaultWorkerCount() + 1;
+
+	srand(1234);
+	Runner runner(options);
+
+	JobSystem::Init();
+	for (int threads = 1; threads <= options.maxThreads; ++threads)
+	{
+		JobSystem::Instance()->Stop();
+		JobSystem::Instance()->Start(threads - 1);
+
+		RunEmptyJobs(runner, threads);
+		RunCompute(runner, threads);
+		RunStream(runner, threads);
+		RunImbalanced(runner, threads);
+		RunNested(runner, threads);
+	}
+	JobSystem::Destroy();
+
+	if (options.jsonPath && !WriteJson(options.jsonPath, runner.GetResults()))
+	{
+		printf("can't write %s\n", options.jsonPath);
+		return 1;
+	}
+	return 0;
+}
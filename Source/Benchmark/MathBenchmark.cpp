@@ -0,0 +1,451 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "Core/Math/Matrix3x3.h"
+#include "Core/Math/Matrix4x4.h"
+#include "Core/Math/Quaternion.h"
+#include "Core/Math/MathTrick.h"
+#include "Core/Math/Vector3Stream.h"
+#include "Core/Math/QuaternionStream.h"
+#include "Core/Math/Simd/MathKernels.h"
+
+/*
+	MathBenchmark
+	Times the hot math functions over working sets from L1 resident to DRAM bound.
+	Every benchmark runs a whole array per sample, the best sample is reported as
+	ns/op (one op = one element) and throughput in ops/s and bytes/s.
+
+	WankelMathBench [--json file] [--level name|all] [--filter text] [--quick]
+*/
+
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	// working set in bytes, input + output of one benchmark
+	const size_t kWorkingSets[] = { 16 << 10, 256 << 10, 4 << 20, 64 << 20 };
+	const char* const kWorkingSetNames[] = { "L1", "L2", "L3", "DRAM" };
+	const size_t kWorkingSetCount = sizeof(kWorkingSets) / sizeof(kWorkingSets[0]);
+
+	struct Options
+	{
+		const char* jsonPath;
+		const char* filter;
+		int level;				//-1 best, kSimdLevelCount all
+		double minTime;			//seconds per sample
+		int samples;
+
+		Options(void) : jsonPath(nullptr), filter(nullptr), level(-1), minTime(0.02), samples(5) {}
+	};
+
+	struct Result
+	{
+		std::string name;
+		const char* level;
+		const char* workingSet;
+		size_t bytes;
+		size_t count;
+		double nsPerOp;
+		double opsPerSec;
+		double bytesPerSec;
+	};
+
+	// keeps the optimizer from dropping the measured work
+	volatile float gSink;
+
+	float Random(void) { return rand() / static_cast<float>(RAND_MAX) * 2.0F - 1.0F; }
+	Vector3 RandomVector3(void) { return Vector3(Random(), Random(), Random()); }
+	Quaternionf RandomQuaternion(void) { return NormalizeSafe(Quaternionf(Random(), Random(), Random(), Random())); }
+
+	void RandomAffine(Matrix4x4& m)
+	{
+		m.SetTRS(RandomVector3() * 10.0F, RandomQuaternion(), Vector3(1.0F + Random() * 0.5F, 1.0F, 1.0F));
+	}
+
+	/* Runner */
+
+	class Runner
+	{
+	private:
+		const Options& m_options;
+		std::vector<Result> m_results;
+		const char* m_level;
+
+	public:
+		explicit Runner(const Options& options) : m_options(options), m_level("") {}
+
+		void SetLevel(const char* level) { m_level = level; }
+		const std::vector<Result>& GetResults(void) const { return m_results; }
+
+		bool IsEnabled(const char* name) const
+		{
+			return m_options.filter == nullptr || strstr(name, m_options.filter) != nullptr;
+		}
+
+		// body(count) processes count elements once
+		template<class Body>
+		void Run(const char* name, size_t workingSet, size_t bytesPerOp, Body body)
+		{
+			const size_t count = workingSet / bytesPerOp;
+
+			// grow the repeat count until a sample is long enough to time
+			size_t repeat = 1;
+			for (;;)
+			{
+				const Clock::time_point start = Clock::now();
+				for (size_t r = 0; r < repeat; ++r)
+					body(count);
+				const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+				if (seconds >= m_options.minTime || repeat >= (size_t(1) << 30))
+					break;
+				repeat *= seconds > 0.0 ? std::max<size_t>(2, static_cast<size_t>(m_options.minTime / seconds)) : 16;
+			}
+
+			double best = 1e30;
+			for (int s = 0; s < m_options.samples; ++s)
+			{
+				const Clock::time_point start = Clock::now();
+				for (size_t r = 0; r < repeat; ++r)
+					body(count);
+				best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+			}
+
+			size_t setIndex = 0;
+			while (setIndex + 1 < kWorkingSetCount && kWorkingSets[setIndex] != workingSet)
+				++setIndex;
+
+			Result result;
+			result.name = name;
+			result.level = m_level;
+			result.workingSet = kWorkingSetNames[setIndex];
+			result.bytes = count * bytesPerOp;
+			result.count = count;
+			const double ops = static_cast<double>(count) * repeat;
+			result.nsPerOp = best * 1e9 / ops;
+			result.opsPerSec = ops / best;
+			result.bytesPerSec = result.opsPerSec * bytesPerOp;
+			m_results.push_back(result);
+
+			printf("%-34s %-8s %-5s %10zu %10.3f ns/op %10.2f Mop/s %9.2f GB/s\n",
+				name, m_level, result.workingSet, count, result.nsPerOp, result.opsPerSec * 1e-6, result.bytesPerSec * 1e-9);
+		}
+	};
+
+	/* Benchmarks, every array is sized for the working set */
+
+	void RunVector3(Runner& runner, size_t workingSet)
+	{
+		const size_t maxCount = workingSet / sizeof(Vector3);
+		std::vector<Vector3> a(maxCount), b(maxCount), out(maxCount);
+		for (size_t i = 0; i < maxCount; ++i)
+		{
+			a[i] = RandomVector3();
+			b[i] = RandomVector3();
+		}
+
+		if (runner.IsEnabled("Vector3::Normalize"))
+			runner.Run("Vector3::Normalize", workingSet, sizeof(Vector3) * 2, [&](size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					out[i] = Vector3::Normalize(a[i]);
+			});
+		if (runner.IsEnabled("Vector3::NormalizeFast"))
+			runner.Run("Vector3::NormalizeFast", workingSet, sizeof(Vector3) * 2, [&](size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					out[i] = Vector3::NormalizeFast(a[i]);
+			});
+		if (runner.IsEnabled("Vector3::Cross"))
+			runner.Run("Vector3::Cross", workingSet, sizeof(Vector3) * 3, [&](size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					out[i] = Vector3::Cross(a[i], b[i]);
+			});
+		if (runner.IsEnabled("Vector3::Dot"))
+			runner.Run("Vector3::Dot", workingSet, sizeof(Vector3) * 2, [&](size_t count)
+			{
+				float sum = 0.0F;
+				for (size_t i = 0; i < count; ++i)
+					sum += Vector3::Dot(a[i], b[i]);
+				gSink = sum;
+			});
+	}
+
+	void RunMathTrick(Runner& runner, size_t workingSet)
+	{
+		const size_t maxCount = workingSet / (sizeof(float) * 2);
+		std::vector<float> input(maxCount), out(maxCount);
+		for (size_t i = 0; i < maxCount; ++i)
+			input[i] = 0.01F + fabsf(Random()) * 100.0F;
+
+		if (runner.IsEnabled("InvSqrt"))
+			runner.Run("InvSqrt", workingSet, sizeof(float) * 2, [&](size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					out[i] = InvSqrt(input[i]);
+			});
+		if (runner.IsEnabled("FastInvSqrt"))
+			runner.Run("FastInvSqrt", workingSet, sizeof(float) * 2, [&](size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					out[i] = FastInvSqrt(input[i]);
+			});
+		if (runner.IsEnabled("FastestInvSqrt"))
+			runner.Run("FastestInvSqrt", workingSet, sizeof(float) * 2, [&](size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					out[i] = FastestInvSqrt(input[i]);
+			});
+	}
+
+	void RunMatrix3x3(Runner& runner, size_t workingSet)
+	{
+		const size_t maxCount = workingSet / (sizeof(Matrix3x3) * 2);
+		std::vector<Matrix3x3> a(maxCount), out(maxCount);
+		Matrix3x3 rhs;
+		EulerToMatrix(RandomVector3(), rhs);
+		for (size_t i = 0; i < maxCount; ++i)
+			EulerToMatrix(RandomVector3(), a[i]);
+
+		if (runner.IsEnabled("MultiplyMatrices3x3"))
+			runner.Run("MultiplyMatrices3x3", workingSet, sizeof(Matrix3x3) * 2, [&](size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					MultiplyMatrices3x3(&a[i], &rhs, &out[i]);
+			});
+	}
+
+	void RunMatrix4x4(Runner& runner, size_t workingSet)
+	{
+		const size_t maxCount = workingSet / (sizeof(Matrix4x4) * 2) + 1;
+		std::vector<Matrix4x4> a(maxCount), b(maxCount), out(maxCount);
+		for (size_t i = 0; i < maxCount; ++i)
+		{
+			RandomAffine(a[i]);
+			RandomAffine(b[i]);
+		}
+
+		if (runner.IsEnabled("MultiplyMatrices4x4"))
+			runner.Run("MultiplyMatrices4x4", workingSet, sizeof(Matrix4x4) * 3, [&](size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					MultiplyMatrices4x4(&a[i], &b[i], &out[i]);
+			});
+		if (runner.IsEnabled("MultiplyMatrixArray4x4"))
+			runner.Run("MultiplyMatrixArray4x4", workingSet, sizeof(Matrix4x4) * 3, [&](size_t count)
+			{
+				MultiplyMatrixArray4x4(a.data(), b.data(), out.data(), count);
+			});
+		if (runner.IsEnabled("MultiplyMatrixArrayWithBase4x4"))
+			runner.Run("MultiplyMatrixArrayWithBase4x4", workingSet, sizeof(Matrix4x4) * 2, [&](size_t count)
+			{
+				MultiplyMatrixArrayWithBase4x4(&b[0], a.data(), b.data() + 1, out.data(), count);
+			});
+		if (runner.IsEnabled("Matrix4x4::Invert"))
+			runner.Run("Matrix4x4::Invert", workingSet, sizeof(Matrix4x4) * 2, [&](size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					Matrix4x4::Invert(a[i], out[i]);
+			});
+		if (runner.IsEnabled("Matrix4x4::Invert_Full"))
+			runner.Run("Matrix4x4::Invert_Full", workingSet, sizeof(Matrix4x4) * 2, [&](size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					Matrix4x4::Invert_Full(a[i], out[i]);
+			});
+		if (runner.IsEnabled("InvertMatrixArray4x4"))
+			runner.Run("InvertMatrixArray4x4", workingSet, sizeof(Matrix4x4) * 2, [&](size_t count)
+			{
+				InvertMatrixArray4x4(a.data(), out.data(), count);
+			});
+	}
+
+	void RunTransformPoints(Runner& runner, size_t workingSet)
+	{
+		const size_t maxCount = workingSet / (sizeof(Vector3) * 2);
+		std::vector<Vector3> input(maxCount), out(maxCount);
+		for (size_t i = 0; i < maxCount; ++i)
+			input[i] = RandomVector3();
+		Matrix4x4 matrix;
+		RandomAffine(matrix);
+
+		Vector3Stream streamIn, streamOut;
+		streamIn.Load(input.data(), maxCount);
+		streamOut.Resize(maxCount);
+
+		if (runner.IsEnabled("TransformPoints3x3"))
+			runner.Run("TransformPoints3x3", workingSet, sizeof(Vector3) * 2, [&](size_t count)
+			{
+				TransformPoints3x3(matrix, input.data(), out.data(), static_cast<int>(count));
+			});
+		if (runner.IsEnabled("TransformPoints3x4"))
+			runner.Run("TransformPoints3x4", workingSet, sizeof(Vector3) * 2, [&](size_t count)
+			{
+				TransformPoints3x4(matrix, input.data(), out.data(), static_cast<int>(count));
+			});
+		// stream versions always run the whole stream, which is sized to the same count
+		if (runner.IsEnabled("Vector3Stream::TransformPoints3x4"))
+			runner.Run("Vector3Stream::TransformPoints3x4", workingSet, sizeof(Vector3) * 2, [&](size_t)
+			{
+				TransformPoints3x4(matrix, streamIn, streamOut);
+			});
+	}
+
+	void RunQuaternion(Runner& runner, size_t workingSet)
+	{
+		const size_t maxCount = workingSet / (sizeof(Quaternionf) * 3);
+		std::vector<Quaternionf> a(maxCount), b(maxCount), out(maxCount);
+		std::vector<Matrix4x4> matrices(workingSet / (sizeof(Quaternionf) + sizeof(Matrix4x4)));
+		for (size_t i = 0; i < maxCount; ++i)
+		{
+			a[i] = RandomQuaternion();
+			b[i] = RandomQuaternion();
+		}
+
+		if (runner.IsEnabled("Slerp"))
+			runner.Run("Slerp", workingSet, sizeof(Quaternionf) * 3, [&](size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					out[i] = Slerp(a[i], b[i], 0.3F);
+			});
+		if (runner.IsEnabled("Quaternionf::operator*"))
+			runner.Run("Quaternionf::operator*", workingSet, sizeof(Quaternionf) * 3, [&](size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					out[i] = a[i] * b[i];
+			});
+		if (runner.IsEnabled("RotateVectorByQuat"))
+			runner.Run("RotateVectorByQuat", workingSet, sizeof(Quaternionf) * 3, [&](size_t count)
+			{
+				float sum = 0.0F;
+				for (size_t i = 0; i < count; ++i)
+					sum += RotateVectorByQuat(a[i], Vector3(b[i].x, b[i].y, b[i].z)).X;
+				gSink = sum;
+			});
+		if (runner.IsEnabled("QuaternionToMatrix"))
+			runner.Run("QuaternionToMatrix", workingSet, sizeof(Quaternionf) + sizeof(Matrix4x4), [&](size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					QuaternionToMatrix(a[i], matrices[i]);
+			});
+
+		QuaternionStream streamA, streamB, streamOut;
+		streamA.Load(a.data(), maxCount);
+		streamB.Load(b.data(), maxCount);
+		streamOut.Resize(maxCount);
+		if (runner.IsEnabled("QuaternionStream::Slerp"))
+			runner.Run("QuaternionStream::Slerp", workingSet, sizeof(Quaternionf) * 3, [&](size_t)
+			{
+				Slerp(streamA, streamB, 0.3F, streamOut);
+			});
+	}
+
+	/* Output */
+
+	bool WriteJson(const char* path, const std::vector<Result>& results)
+	{
+		FILE* file = fopen(path, "w");
+		if (file == nullptr)
+			return false;
+
+		fprintf(file, "{\n\t\"benchmarks\": [\n");
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const Result& r = results[i];
+			fprintf(file, "\t\t{ \"name\": \"%s\", \"simd\": \"%s\", \"workingSet\": \"%s\", \"bytes\": %zu, \"count\": %zu, "
+				"\"nsPerOp\": %.4f, \"opsPerSec\": %.1f, \"bytesPerSec\": %.1f }%s\n",
+				r.name.c_str(), r.level, r.workingSet, r.bytes, r.count, r.nsPerOp, r.opsPerSec, r.bytesPerSec,
+				i + 1 < results.size() ? "," : "");
+		}
+		fprintf(file, "\t]\n}\n");
+		fclose(file);
+		return true;
+	}
+
+	int FindLevel(const char* name)
+	{
+		if (strcmp(name, "all") == 0)
+			return kSimdLevelCount;
+		for (int level = 0; level < kSimdLevelCount; ++level)
+		{
+			if (strcmp(name, GetSimdLevelName(static_cast<SimdLevel>(level))) == 0)
+				return level;
+		}
+		return -2;
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const char* arg = argv[i];
+			const bool hasValue = i + 1 < argc;
+			if (strcmp(arg, "--json") == 0 && hasValue)
+				options.jsonPath = argv[++i];
+			else if (strcmp(arg, "--filter") == 0 && hasValue)
+				options.filter = argv[++i];
+			else if (strcmp(arg, "--level") == 0 && hasValue)
+			{
+				options.level = FindLevel(argv[++i]);
+				if (options.level == -2)
+					return false;
+			}
+			else if (strcmp(arg, "--quick") == 0)
+			{
+				options.minTime = 0.005;
+				options.samples = 2;
+			}
+			else
+				return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		printf("usage: %s [--json file] [--level Scalar|SSE2|AVX|AVX+FMA|NEON|all] [--filter text] [--quick]\n", argv[0]);
+		return 1;
+	}
+
+	srand(1234);
+	Runner runner(options);
+
+	const SimdLevel bestLevel = GetSupportedSimdLevel();
+	const int firstLevel = options.level == kSimdLevelCount ? 0 : (options.level < 0 ? bestLevel : options.level);
+	const int lastLevel = options.level == kSimdLevelCount ? kSimdLevelCount - 1 : firstLevel;
+
+	for (int level = firstLevel; level <= lastLevel; ++level)
+	{
+		if (SetSimdLevel(static_cast<SimdLevel>(level)) != level)
+			continue;
+		runner.SetLevel(GetSimdLevelName(static_cast<SimdLevel>(level)));
+
+		for (size_t s = 0; s < kWorkingSetCount; ++s)
+		{
+			RunVector3(runner, kWorkingSets[s]);
+			RunMathTrick(runner, kWorkingSets[s]);
+			RunMatrix3x3(runner, kWorkingSets[s]);
+			RunMatrix4x4(runner, kWorkingSets[s]);
+			RunTransformPoints(runner, kWorkingSets[s]);
+			RunQuaternion(runner, kWorkingSets[s]);
+		}
+	}
+	SetSimdLevel(bestLevel);
+
+	if (options.jsonPath && !WriteJson(options.jsonPath, runner.GetResults()))
+	{
+		printf("can't write %s\n", options.jsonPath);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,82 @@
+#include "Core\Graphics\GfxBufferAllocator.h"
+
+GfxBufferAllocator::GfxBufferAllocator(uint32_t size) : m_size(size), m_freeSize(0)
+{
+	if (size > 0)
+		AddFreeBlock(0, size);
+}
+
+uint32_t GfxBufferAllocator::Allocate(uint32_t size)
+{
+	if (size == 0)
+		return kInvalidOffset;
+
+	//smallest block that fits
+	SizeMap::iterator fit = m_freeBySize.lower_bound(size);
+	if (fit == m_freeBySize.end())
+		return kInvalidOffset;
+
+	const uint32_t blockSize = fit->first;
+	const uint32_t offset = fit->second;
+	RemoveFreeBlock(m_freeByOffset.find(offset));
+
+	if (blockSize > size)
+		AddFreeBlock(offset + size, blockSize - size);
+	return offset;
+}
+
+void GfxBufferAllocator::Free(uint32_t offset, uint32_t size)
+{
+	/* Assert(offset + size <= m_size) */
+	if (size == 0)
+		return;
+
+	//merge with the block after
+	OffsetMap::iterator next = m_freeByOffset.lower_bound(offset);
+	if (next != m_freeByOffset.end() && next->first == offset + size)
+	{
+		size += next->second;
+		RemoveFreeBlock(next);
+	}
+
+	//merge with the block before
+	OffsetMap::iterator previous = m_freeByOffset.lower_bound(offset);
+	if (previous != m_freeByOffset.begin())
+	{
+		--previous;
+		if (previous->first + previous->second == offset)
+		{
+			offset = previous->first;
+			size += previous->second;
+			RemoveFreeBlock(previous);
+		}
+	}
+
+	AddFreeBlock(offset, size);
+}
+
+void GfxBufferAllocator::AddFreeBlock(uint32_t offset, uint32_t size)
+{
+	m_freeByOffset[offset] = size;
+	m_freeBySize.insert(SizeMap::value_type(size, offset));
+	m_freeSize += size;
+}
+
+void GfxBufferAllocator::RemoveFreeBlock(OffsetMap::iterator block)
+{
+	const uint32_t offset = block->first;
+	const uint32_t size = block->second;
+
+	std::pair<SizeMap::iterator, SizeMap::iterator> range = m_freeBySize.equal_range(size);
+	for (SizeMap::iterator it = range.first; it != range.second; ++it)
+	{
+		if (it->second == offset)
+		{
+			m_freeBySize.erase(it);
+			break;
+		}
+	}
+
+	m_freeByOffset.erase(block);
+	m_freeSize -= size;
+}
@@ -0,0 +1,17 @@
+#include "Core\Graphics\GfxDevice.h"
+#include "Core\Graphics\RenderQueue.h"
+
+void GfxDevice::DrawRenderQueue(const RenderQueue & queue)
+{
+	const RenderPacket* packets = queue.GetPackets();
+	for (size_t i = 0; i < queue.GetCount(); ++i)
+	{
+		const RenderPacket& packet = packets[i];
+		if (packet.m_indexCount > 0)
+			DrawMeshIndexed(*packet.m_mesh, *packet.m_material, queue.GetIndices() + packet.m_firstIndex, packet.m_indexCount);
+		else if (packet.m_instanceCount > 0)
+			DrawMeshInstanced(*packet.m_mesh, *packet.m_material, queue.GetInstances() + packet.m_firstInstance, packet.m_instanceCount, packet.m_lod);
+		else
+			DrawMesh(*packet.m_mesh, *packet.m_material, packet.m_lod);
+	}
+}
@@ -1,34 +1,219 @@
 #include "Core\Graphics\GraphicManager.h"
+#include "Core\Graphics\Mesh\Mesh.h"
+#include "Core\Graphics\Mesh\MeshletSet.h"
+#include "Core\Graphics\Material.h"
+#include "Core\Graphics\Shader.h"
+#include "Core\Graphics\RenderThread.h"
+
+const float GraphicManager::kDefaultLODScreenError = 1.0F / 1080.0F;
 
 void GraphicManager::OnInit()
 {
-	//do nothing ?
+	//built here and not in static init, a basic mesh calls back into the manager
+	Mesh::InitBasicMesh();
 }
 
 void GraphicManager::OnDestroy()
 {
-	m_gfxDevice->Destroy();
+	if (m_renderThread != nullptr)
+	{
+		//the device is destroyed on its thread
+		Flush();
+		m_renderThread->Stop();
+		delete m_renderThread;
+		m_renderThread = nullptr;
+		m_recordQueue = &m_renderQueue;
+	}
+	else
+	{
+		ProcessReleases();
+		m_gfxDevice->Destroy();
+	}
 }
 
-void GraphicManager::SetGfxDevice(GfxDevice * gfxDevice)
+void GraphicManager::SetGfxDevice(GfxDevice * gfxDevice, bool renderThread)
 {
 	if (m_gfxDevice == nullptr && gfxDevice != nullptr)
 		m_gfxDevice = gfxDevice;
 
-	m_gfxDevice->Init();
+	if (renderThread)
+	{
+		m_renderThread = new RenderThread();
+		m_renderThread->Start(m_gfxDevice);
+		m_recordQueue = &m_renderThread->GetCommandList().GetQueue();
+	}
+	else
+		m_gfxDevice->Init();
+}
+
+const RenderThreadStats * GraphicManager::GetRenderThreadStats(void) const
+{
+	return m_renderThread != nullptr ? &m_renderThread->GetStats() : nullptr;
 }
 
 void GraphicManager::Clear(void)
 {
-	m_gfxDevice->Clear();
+	//draws recorded before the clear still land
+	Flush();
+	if (m_renderThread != nullptr)
+		m_renderThread->GetCommandList().Clear();
+	else
+		m_gfxDevice->Clear();
 }
 
-void GraphicManager::DrawMesh(const Mesh & mesh, const Material & material)
+void GraphicManager::DrawMesh(const Mesh & mesh, const Material & material, float depth, unsigned int pass)
 {
-	m_gfxDevice->DrawMesh(mesh, material);
+	MarkDrawn(mesh, material);
+	m_recordQueue->Add(mesh, material, depth, pass);
+}
+
+void GraphicManager::DrawMeshInstanced(const Mesh & mesh, const Material & material, const Matrix4x4 * transforms, int instanceCount, float depth, unsigned int pass)
+{
+	MarkDrawn(mesh, material);
+	m_recordQueue->AddInstanced(mesh, material, transforms, instanceCount, depth, pass);
+}
+
+void GraphicManager::DrawMeshInstanced(const Mesh & mesh, const Material & material, const InstanceTransform * instances, int instanceCount, float depth, unsigned int pass)
+{
+	MarkDrawn(mesh, material);
+	m_recordQueue->AddInstanced(mesh, material, instances, instanceCount, depth, pass);
+}
+
+void GraphicManager::DrawMeshLOD(const Mesh & mesh, const Material & material, float screenSize, float depth, unsigned int pass)
+{
+	MarkDrawn(mesh, material);
+	m_recordQueue->Add(mesh, material, depth, pass, mesh.SelectLOD(screenSize, m_lodScreenError));
+}
+
+void GraphicManager::DrawMeshInstancedLOD(const Mesh & mesh, const Material & material, const InstanceTransform * instances, int instanceCount, float screenSize, float depth, unsigned int pass)
+{
+	MarkDrawn(mesh, material);
+	m_recordQueue->AddInstanced(mesh, material, instances, instanceCount, depth, pass, mesh.SelectLOD(screenSize, m_lodScreenError));
+}
+
+void GraphicManager::DrawMeshlets(const Mesh & mesh, const MeshletSet & meshlets, const Material & material, const Frustum & frustum, const Vector3 & cameraPosition, float depth, unsigned int pass)
+{
+	MarkDrawn(mesh, material);
+	const size_t visible = meshlets.CullIndices(frustum, cameraPosition, m_meshletIndices);
+	//all of it in view, the uploaded indices do the same without a copy
+	if (visible == meshlets.GetCount())
+		m_recordQueue->Add(mesh, material, depth, pass);
+	else if (visible > 0)
+		m_recordQueue->AddIndexed(mesh, material, m_meshletIndices.data(), m_meshletIndices.size(), depth, pass);
 }
 
 void GraphicManager::SwapBuffer(void)
 {
-	m_gfxDevice->SwapBuffer();
+	Flush();
+	if (m_renderThread != nullptr)
+	{
+		m_renderThread->Submit();
+		m_recordQueue = &m_renderThread->GetCommandList().GetQueue();
+	}
+	else
+		m_gfxDevice->SwapBuffer();
+}
+
+void GraphicManager::Flush(void)
+{
+	//sorted on the render thread
+	if (m_renderThread != nullptr)
+	{
+		if (!m_recordQueue->IsEmpty())
+			m_recordQueue = &m_renderThread->GetCommandList().CloseQueue();
+		return;
+	}
+
+	if (!m_renderQueue.IsEmpty())
+	{
+		m_renderQueue.Sort();
+		m_gfxDevice->DrawRenderQueue(m_renderQueue);
+		m_renderQueue.Clear();
+	}
+	ProcessReleases();
+}
+
+void GraphicManager::PrepareShader(const Shader & shader)
+{
+	if (m_renderThread != nullptr)
+	{
+		shader.GetGfxFrames().Mark(m_renderThread->GetRecordFrame());
+		m_renderThread->GetCommandList().PrepareShader(shader);
+	}
+	else if (m_gfxDevice != nullptr)
+		m_gfxDevice->PrepareShader(shader);
+}
+
+void GraphicManager::ReleaseMesh(const Mesh & mesh, bool destroyed)
+{
+	if (m_renderThread != nullptr)
+	{
+		//the frame in flight may still read it, and upload it, so the handle is only known after
+		//waits only when that frame drew it, the release plays after the draws of this one
+		m_renderThread->WaitReleased(mesh.GetGfxFrames());
+		//a changed mesh is still there when the list plays, and uploaded again
+		if (destroyed)
+			m_renderThread->GetCommandList().RemoveDraws(&mesh);
+		if (mesh.GetGfxHandle().IsValid())
+			m_renderThread->GetCommandList().ReleaseMesh(&mesh, mesh.GetGfxHandle());
+	}
+	else if (m_gfxDevice != nullptr)
+	{
+		//the queue only keeps a pointer, a changed mesh is uploaded again by its draws
+		if (destroyed)
+			m_renderQueue.Remove(&mesh);
+		if (mesh.GetGfxHandle().IsValid())
+			m_meshReleases.push_back(std::make_pair(&mesh, mesh.GetGfxHandle()));
+	}
+}
+
+void GraphicManager::ReleaseShader(const Shader & shader)
+{
+	if (m_renderThread != nullptr)
+	{
+		m_renderThread->WaitReleased(shader.GetGfxFrames());
+		m_renderThread->GetCommandList().RemoveShader(&shader);
+		m_renderThread->GetCommandList().RemoveDraws(&shader);
+		if (shader.GetGfxHandle().IsValid())
+			m_renderThread->GetCommandList().ReleaseShader(&shader, shader.GetGfxHandle());
+	}
+	else if (m_gfxDevice != nullptr)
+	{
+		m_renderQueue.Remove(&shader);
+		if (shader.GetGfxHandle().IsValid())
+			m_shaderReleases.push_back(std::make_pair(&shader, shader.GetGfxHandle()));
+	}
+}
+
+void GraphicManager::ReleaseMaterial(const Material & material)
+{
+	if (m_renderThread != nullptr)
+	{
+		m_renderThread->WaitReleased(material.GetGfxFrames());
+		m_renderThread->GetCommandList().RemoveDraws(&material);
+	}
+	else
+		m_renderQueue.Remove(&material);
+}
+
+void GraphicManager::MarkDrawn(const Mesh & mesh, const Material & material)
+{
+	if (m_renderThread == nullptr)
+		return;
+
+	const uint32_t frame = m_renderThread->GetRecordFrame();
+	mesh.GetGfxFrames().Mark(frame);
+	material.GetGfxFrames().Mark(frame);
+	material.GetShader().GetGfxFrames().Mark(frame);
+}
+
+void GraphicManager::ProcessReleases(void)
+{
+	//the pointers are only owner keys, the objects may be gone
+	for (size_t i = 0; i < m_meshReleases.size(); ++i)
+		m_gfxDevice->ReleaseMesh(m_meshReleases[i].first, m_meshReleases[i].second);
+	for (size_t i = 0; i < m_shaderReleases.size(); ++i)
+		m_gfxDevice->ReleaseShader(m_shaderReleases[i].first, m_shaderReleases[i].second);
+	m_meshReleases.clear();
+	m_shaderReleases.clear();
 }
\ No newline at end of file
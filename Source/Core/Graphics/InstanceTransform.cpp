@@ -0,0 +1,15 @@
+#include "Core\Graphics\InstanceTransform.h"
+#include "Core\Math\Matrix4x4.h"
+
+void PackInstanceTransforms(const Matrix4x4* matrices, int count, InstanceTransform* output)
+{
+	//column major in, rows out
+	for (int i = 0; i < count; ++i)
+	{
+		const float* m = matrices[i].m_data;
+		float* rows = output[i].m_rows[0];
+		rows[0] = m[0];	rows[1] = m[4];	rows[2] = m[8];		rows[3] = m[12];
+		rows[4] = m[1];	rows[5] = m[5];	rows[6] = m[9];		rows[7] = m[13];
+		rows[8] = m[2];	rows[9] = m[6];	rows[10] = m[10];	rows[11] = m[14];
+	}
+}
@@ -1,6 +1,32 @@
+#include <algorithm>
+
 #include "Core\Graphics\Material.h"
+#include "Core\Graphics\GraphicManager.h"
+
+namespace
+{
+	inline uint32_t PackChannel(float value, int shift)
+	{
+		const float clamped = std::min(std::max(value, 0.0F), 1.0F);
+		return static_cast<uint32_t>(clamped * 255.0F + 0.5F) << shift;
+	}
+}
 
-Material::Material(const Shader &shader) : m_shader(shader)
+Material::Material(const Shader &shader) : m_shader(shader), m_baseColor(1.0F, 1.0F, 1.0F, 1.0F), m_packedBaseColor(0xFFFFFFFF)
 {
 
+}
+
+void Material::SetBaseColor(const Vector4 & color)
+{
+	m_baseColor = color;
+	m_packedBaseColor = PackChannel(color.X, 0) | PackChannel(color.Y, 8) | PackChannel(color.Z, 16) | PackChannel(color.W, 24);
+}
+
+Material::~Material(void)
+{
+	//queued draws point at it
+	GraphicManager* graphicManager = GraphicManager::Instance();
+	if (graphicManager != nullptr)
+		graphicManager->ReleaseMaterial(*this);
 }
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include <cstring>
+#include <algorithm>
+
+#include "Core\Graphics\Mesh\IndexFormat.h"
+#include "Core\Math\Simd\SimdConfig.h"
+
+#if SIMD_X86
+#include <emmintrin.h>
+#endif
+
+IndexType GetIndexType(uint32_t maxIndex)
+{
+	if (maxIndex <= 0xFF)
+		return IndexType::UInt8;
+	if (maxIndex <= 0xFFFF)
+		return IndexType::UInt16;
+	return IndexType::UInt32;
+}
+
+uint32_t FindMaxIndex(const uint32_t * indices, size_t count)
+{
+	size_t i = 0;
+	uint32_t res = 0;
+#if SIMD_X86
+	//SSE2 compares signed only, flipping the sign bit orders unsigned values
+	const __m128i flip = _mm_set1_epi32(0x80000000);
+	__m128i maxValue = flip;
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128i value = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i)), flip);
+		const __m128i isGreater = _mm_cmpgt_epi32(value, maxValue);
+		maxValue = _mm_or_si128(_mm_and_si128(isGreater, value), _mm_andnot_si128(isGreater, maxValue));
+	}
+
+	SIMD_ALIGN(16) uint32_t lanes[4];
+	_mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_xor_si128(maxValue, flip));
+	res = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#endif
+	for (; i < count; ++i)
+		res = std::max(res, indices[i]);
+	return res;
+}
+
+bool NarrowIndices(const uint32_t * indices, size_t count, uint32_t bias, IndexType type, void * output)
+{
+	//bits that must stay clear, checked once at the end
+	const uint32_t overflowMask = type == IndexType::UInt8 ? 0xFFFFFF00 : type == IndexType::UInt16 ? 0xFFFF0000 : 0;
+	uint32_t overflow = 0;
+	size_t i = 0;
+
+#if SIMD_X86
+	const __m128i biasValue = _mm_set1_epi32(bias);
+	__m128i overflowValue = _mm_setzero_si128();
+	if (type == IndexType::UInt32)
+	{
+		uint32_t* res = static_cast<uint32_t*>(output);
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i value = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i)), biasValue);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(res + i), value);
+		}
+	}
+	else
+	{
+		//packs saturate signed, values are shifted into the signed range and back
+		const __m128i shift = _mm_set1_epi32(0x8000);
+		const __m128i unshift = _mm_set1_epi16((short)0x8000);
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m128i value0 = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i)), biasValue);
+			const __m128i value1 = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i + 4)), biasValue);
+			overflowValue = _mm_or_si128(overflowValue, _mm_or_si128(value0, value1));
+
+			__m128i packed = _mm_packs_epi32(_mm_sub_epi32(value0, shift), _mm_sub_epi32(value1, shift));
+			packed = _mm_xor_si128(packed, unshift);
+			if (type == IndexType::UInt16)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(static_cast<uint16_t*>(output) + i), packed);
+			else
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(static_cast<uint8_t*>(output) + i), _mm_packus_epi16(packed, packed));
+		}
+	}
+
+	SIMD_ALIGN(16) uint32_t lanes[4];
+	_mm_store_si128(reinterpret_cast<__m128i*>(lanes), overflowValue);
+	overflow = lanes[0] | lanes[1] | lanes[2] | lanes[3];
+#endif
+
+	for (; i < count; ++i)
+	{
+		const uint32_t value = indices[i] + bias;
+		overflow |= value;
+		if (type == IndexType::UInt32)
+			static_cast<uint32_t*>(output)[i] = value;
+		else if (type == IndexType::UInt16)
+			static_cast<uint16_t*>(output)[i] = static_cast<uint16_t>(value);
+		else
+			static_cast<uint8_t*>(output)[i] = static_cast<uint8_t>(value);
+	}
+
+	return (overflow & overflowMask) == 0;
+}
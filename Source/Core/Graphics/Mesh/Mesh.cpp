@@ -1,18 +1,55 @@
+#include <limits>
+
 #include "Core\Graphics\Mesh\Mesh.h"
+#include "Core\Graphics\Mesh\VertexLayout.h"
+#include "Core\Graphics\Mesh\MeshOptimizer.h"
+#include "Core\Graphics\Mesh\MeshSimplifier.h"
 #include "Core\Math\MathTrick.h"
+#include "Core\Graphics\GraphicManager.h"
+#include "Core\Log\Debug.h"
 
-Mesh::Mesh(String meshPath) 
+Mesh::Mesh(String meshPath) : m_vertexLayout(nullptr)
 {
 	//load mesh by path
 	//need share ???
 }
 
-Mesh::Mesh(MeshType meshType) : m_vertices(m_basicMesh[(int)meshType].GetVertex()), m_indices(m_basicMesh[(int)meshType].GetIndex())
+Mesh::Mesh(MeshType meshType) : m_vertices(GetBasicMesh(meshType).m_vertices), m_indices(GetBasicMesh(meshType).m_indices),
+	m_lods(GetBasicMesh(meshType).m_lods), m_lodIndices(GetBasicMesh(meshType).m_lodIndices), m_vertexLayout(nullptr)
 {
 	//No share
 }
 
-Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) : m_vertices(vertices), m_indices(indices) {}
+Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) : m_vertices(vertices), m_indices(indices), m_vertexLayout(nullptr) {}
+
+Mesh::~Mesh(void)
+{
+	ReleaseGfxResource(true);
+}
+
+Mesh & Mesh::operator=(const Mesh & other)
+{
+	if (this != &other)
+	{
+		ReleaseGfxResource();
+		m_vertices = other.m_vertices;
+		m_indices = other.m_indices;
+		m_lods = other.m_lods;
+		m_lodIndices = other.m_lodIndices;
+		m_vertexLayout = other.m_vertexLayout;
+	}
+	return *this;
+}
+
+void Mesh::ReleaseGfxResource(bool destroyed) const
+{
+	//no manager left at shutdown, the device is gone with its resources
+	//without a handle too, the render thread may be uploading the mesh
+	GraphicManager* graphicManager = GraphicManager::Instance();
+	if (graphicManager != nullptr)
+		graphicManager->ReleaseMesh(*this, destroyed);
+	m_gfxHandle = GfxHandle();
+}
 
 int Mesh::GetVertexCount() const
 {
@@ -34,8 +71,68 @@ const std::vector<unsigned int>& Mesh::GetIndex() const
 	return m_indices;
 }
 
-const Mesh* Mesh::InitBasicMesh(void)
+MeshLOD Mesh::GetLOD(int lod) const
+{
+	if (lod > 0 && lod <= (int)m_lods.size())
+		return m_lods[lod - 1];
+
+	MeshLOD res;
+	res.m_firstIndex = 0;
+	res.m_indexCount = m_indices.size();
+	res.m_error = 0.0F;
+	return res;
+}
+
+const unsigned int * Mesh::GetLODIndexData(int lod) const
 {
+	if (lod > 0 && lod <= (int)m_lods.size())
+		return m_lodIndices.data() + (m_lods[lod - 1].m_firstIndex - m_indices.size());
+	return m_indices.data();
+}
+
+void Mesh::SetLODs(const std::vector<MeshLOD>& lods, const std::vector<unsigned int>& lodIndices)
+{
+	/* Assert(lods.size() < kMaxLODCount) */
+	ReleaseGfxResource();
+	m_lods = lods;
+	m_lodIndices = lodIndices;
+}
+
+int Mesh::SelectLOD(float screenSize, float maxScreenError) const
+{
+	//the radius covers half of the screen size
+	for (int i = (int)m_lods.size(); i > 0; --i)
+		if (m_lods[i - 1].m_error * screenSize * 0.5F <= maxScreenError)
+			return i;
+	return 0;
+}
+
+float Mesh::GetScreenSize(float radius, float distance, float tanHalfFovY)
+{
+	//inside the bounds, nothing is coarse enough
+	if (distance <= radius || tanHalfFovY <= 0.0F)
+		return std::numeric_limits<float>::max();
+	return radius / (distance * tanHalfFovY);
+}
+
+const VertexLayoutDesc & Mesh::GetVertexLayout(void) const
+{
+	return m_vertexLayout != nullptr ? *m_vertexLayout : StandardVertexLayout::GetDesc();
+}
+
+const Mesh & Mesh::GetBasicMesh(MeshType meshType)
+{
+	//a Mesh made before GraphicManager init
+	if (m_basicMesh == nullptr)
+		InitBasicMesh();
+	return m_basicMesh[(int)meshType];
+}
+
+void Mesh::InitBasicMesh(void)
+{
+	if (m_basicMesh != nullptr)
+		return;
+
 	//Init Basic Mesh
 	Mesh *basicMeshes = new Mesh[(int)Mesh::MeshType::MeshTypeCount];
 
@@ -199,7 +296,18 @@ const Mesh* Mesh::InitBasicMesh(void)
 	basicMeshes[(int)Mesh::MeshType::Sphere].SetVertex(sphereVertex);
 	basicMeshes[(int)Mesh::MeshType::Sphere].SetIndex(sphereIndex);
 
-	return basicMeshes;
+	static const char* meshNames[] = { "Cube", "Plane", "Sphere" };
+	for (int i = 0; i < (int)Mesh::MeshType::MeshTypeCount; ++i)
+	{
+		MeshOptimizer::Stats before, after;
+		MeshOptimizer::Optimize(basicMeshes[i], &before, &after);
+		Debug::Log("Basic Mesh {0} ACMR {1:.3f} -> {2:.3f}, ATVR {3:.3f} -> {4:.3f}", meshNames[i], before.m_acmr, after.m_acmr, before.m_atvr, after.m_atvr);
+	}
+
+	//cube and plane are too small to lose anything
+	MeshSimplifier::GenerateLODs(basicMeshes[(int)Mesh::MeshType::Sphere]);
+
+	m_basicMesh = basicMeshes;
 }
 
-const Mesh* Mesh::m_basicMesh = Mesh::InitBasicMesh();
\ No newline at end of file
+const Mesh* Mesh::m_basicMesh = nullptr;
\ No newline at end of file
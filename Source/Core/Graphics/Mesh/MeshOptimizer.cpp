@@ -0,0 +1,356 @@
+#include <cmath>
+#include <algorithm>
+
+#include "Core\Graphics\Mesh\MeshOptimizer.h"
+
+namespace
+{
+	const float kCacheDecayPower = 1.5F;
+	const float kLastTriangleScore = 0.75F;
+	const float kValenceBoostScale = 2.0F;
+	const float kValenceBoostPower = 0.5F;
+	const int kValenceTableSize = 32;
+
+	struct ScoreTable
+	{
+		float m_cache[MeshOptimizer::kCacheSize];
+		float m_valence[kValenceTableSize];
+
+		ScoreTable(void)
+		{
+			for (int i = 0; i < MeshOptimizer::kCacheSize; ++i)
+			{
+				//the last triangle's vertices get a flat score, so it is not simply repeated
+				if (i < 3)
+					m_cache[i] = kLastTriangleScore;
+				else
+					m_cache[i] = std::pow(1.0F - (i - 3) / float(MeshOptimizer::kCacheSize - 3), kCacheDecayPower);
+			}
+			for (int i = 0; i < kValenceTableSize; ++i)
+				m_valence[i] = i == 0 ? 0.0F : kValenceBoostScale * std::pow(float(i), -kValenceBoostPower);
+		}
+
+		//few triangles left scores high, finishes off lone vertices early
+		float GetVertexScore(int cachePosition, int remaining) const
+		{
+			if (remaining == 0)
+				return -1.0F;
+
+			float score = cachePosition >= 0 ? m_cache[cachePosition] : 0.0F;
+			score += remaining < kValenceTableSize ? m_valence[remaining] : kValenceBoostScale * std::pow(float(remaining), -kValenceBoostPower);
+			return score;
+		}
+	};
+
+	const ScoreTable& GetScoreTable(void)
+	{
+		static const ScoreTable table;
+		return table;
+	}
+
+	struct Cluster
+	{
+		size_t m_firstTriangle;
+		size_t m_triangleCount;
+		float m_sortKey;
+	};
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, int vertexCount)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0 || vertexCount <= 0)
+		return;
+
+	const ScoreTable& scoreTable = GetScoreTable();
+
+	//per vertex list of the triangles not emitted yet, m_remaining long
+	std::vector<int> remaining(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; ++i)
+		++remaining[indices[i]];
+
+	std::vector<size_t> offsets(vertexCount + 1, 0);
+	for (int v = 0; v < vertexCount; ++v)
+		offsets[v + 1] = offsets[v] + remaining[v];
+
+	std::vector<unsigned int> adjacency(triangleCount * 3);
+	std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+	for (size_t t = 0; t < triangleCount; ++t)
+	{
+		for (int k = 0; k < 3; ++k)
+			adjacency[cursor[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (int v = 0; v < vertexCount; ++v)
+		vertexScore[v] = scoreTable.GetVertexScore(-1, remaining[v]);
+
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<char> emitted(triangleCount, 0);
+	for (size_t t = 0; t < triangleCount; ++t)
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+	//3 more than the cache, the vertices pushed out by the last triangle
+	unsigned int cache[kCacheSize + 3];
+	unsigned int newCache[kCacheSize + 3];
+	int cacheCount = 0;
+
+	std::vector<unsigned int> output;
+	output.reserve(triangleCount * 3);
+
+	size_t best = std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin();
+	size_t nextUnemitted = 0;
+
+	for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+	{
+		if (best == triangleCount)
+		{
+			//nothing in the cache touches a triangle left, go on in input order
+			while (emitted[nextUnemitted])
+				++nextUnemitted;
+			best = nextUnemitted;
+		}
+
+		const unsigned int* triangle = &indices[best * 3];
+		output.insert(output.end(), triangle, triangle + 3);
+		emitted[best] = 1;
+
+		//LRU, the triangle's vertices move to the front
+		int newCacheCount = 0;
+		for (int k = 0; k < 3; ++k)
+			newCache[newCacheCount++] = triangle[k];
+		for (int i = 0; i < cacheCount; ++i)
+		{
+			const unsigned int v = cache[i];
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+				newCache[newCacheCount++] = v;
+		}
+
+		for (int k = 0; k < 3; ++k)
+		{
+			const unsigned int v = triangle[k];
+			unsigned int* list = &adjacency[offsets[v]];
+			for (int i = 0; i < remaining[v]; ++i)
+			{
+				if (list[i] == best)
+				{
+					list[i] = list[remaining[v] - 1];
+					break;
+				}
+			}
+			--remaining[v];
+		}
+
+		//rescore what moved, including the vertices that just fell out
+		for (int i = 0; i < newCacheCount; ++i)
+		{
+			const unsigned int v = newCache[i];
+			cachePosition[v] = i < kCacheSize ? i : -1;
+
+			const float score = scoreTable.GetVertexScore(cachePosition[v], remaining[v]);
+			const float delta = score - vertexScore[v];
+			vertexScore[v] = score;
+
+			const unsigned int* list = &adjacency[offsets[v]];
+			for (int j = 0; j < remaining[v]; ++j)
+				triangleScore[list[j]] += delta;
+		}
+
+		cacheCount = std::min(newCacheCount, (int)kCacheSize);
+		std::copy(newCache, newCache + cacheCount, cache);
+
+		//the next triangle is one of the cached vertices
+		best = triangleCount;
+		float bestScore = -1.0F;
+		for (int i = 0; i < cacheCount; ++i)
+		{
+			const unsigned int v = cache[i];
+			const unsigned int* list = &adjacency[offsets[v]];
+			for (int j = 0; j < remaining[v]; ++j)
+			{
+				if (triangleScore[list[j]] > bestScore)
+				{
+					bestScore = triangleScore[list[j]];
+					best = list[j];
+				}
+			}
+		}
+	}
+
+	indices.swap(output);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+		return;
+
+	//a cluster ends where a triangle misses on all 3 vertices, the cache order
+	//restarts there anyway, so moving clusters costs almost no cache hits
+	std::vector<Cluster> clusters;
+	std::vector<unsigned int> cacheTime(vertices.size(), 0);
+	unsigned int time = kAnalyzeCacheSize + 1;
+	for (size_t t = 0; t < triangleCount; ++t)
+	{
+		int misses = 0;
+		for (int k = 0; k < 3; ++k)
+		{
+			const unsigned int v = indices[t * 3 + k];
+			if (time - cacheTime[v] > kAnalyzeCacheSize)
+			{
+				cacheTime[v] = time++;
+				++misses;
+			}
+		}
+
+		if (t == 0 || misses == 3)
+		{
+			Cluster cluster = { t, 0, 0.0F };
+			clusters.push_back(cluster);
+		}
+		++clusters.back().m_triangleCount;
+	}
+
+	//area weighted centroid and normal of each cluster and the mesh
+	std::vector<float> centroids(clusters.size() * 3);
+	std::vector<float> normals(clusters.size() * 3);
+	float meshCentroid[3] = { 0.0F, 0.0F, 0.0F };
+	float meshArea = 0.0F;
+	for (size_t c = 0; c < clusters.size(); ++c)
+	{
+		float* centroid = &centroids[c * 3];
+		float* normal = &normals[c * 3];
+		float area = 0.0F;
+		centroid[0] = centroid[1] = centroid[2] = 0.0F;
+		normal[0] = normal[1] = normal[2] = 0.0F;
+
+		for (size_t t = clusters[c].m_firstTriangle; t < clusters[c].m_firstTriangle + clusters[c].m_triangleCount; ++t)
+		{
+			const float* p0 = vertices[indices[t * 3]].m_position.GetPtr();
+			const float* p1 = vertices[indices[t * 3 + 1]].m_position.GetPtr();
+			const float* p2 = vertices[indices[t * 3 + 2]].m_position.GetPtr();
+
+			const float e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			const float e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			const float n[3] = { e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0] };
+			const float triangleArea = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+			for (int k = 0; k < 3; ++k)
+			{
+				centroid[k] += (p0[k] + p1[k] + p2[k]) * (triangleArea / 3.0F);
+				normal[k] += n[k];
+			}
+			area += triangleArea;
+		}
+
+		for (int k = 0; k < 3; ++k)
+			meshCentroid[k] += centroid[k];
+		meshArea += area;
+
+		const float invArea = area > 0.0F ? 1.0F / area : 0.0F;
+		for (int k = 0; k < 3; ++k)
+			centroid[k] *= invArea;
+	}
+
+	const float invMeshArea = meshArea > 0.0F ? 1.0F / meshArea : 0.0F;
+	for (int k = 0; k < 3; ++k)
+		meshCentroid[k] *= invMeshArea;
+
+	//clusters facing away from the center are in front of the others from most views
+	for (size_t c = 0; c < clusters.size(); ++c)
+	{
+		const float* centroid = &centroids[c * 3];
+		const float* normal = &normals[c * 3];
+		const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		const float invLength = length > 0.0F ? 1.0F / length : 0.0F;
+
+		float key = 0.0F;
+		for (int k = 0; k < 3; ++k)
+			key += (centroid[k] - meshCentroid[k]) * normal[k] * invLength;
+		clusters[c].m_sortKey = key;
+	}
+
+	std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& lhs, const Cluster& rhs) { return lhs.m_sortKey > rhs.m_sortKey; });
+
+	std::vector<unsigned int> output;
+	output.reserve(triangleCount * 3);
+	for (size_t c = 0; c < clusters.size(); ++c)
+		output.insert(output.end(), indices.begin() + clusters[c].m_firstTriangle * 3, indices.begin() + (clusters[c].m_firstTriangle + clusters[c].m_triangleCount) * 3);
+	indices.swap(output);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	//vertices no index uses are dropped
+	const unsigned int kUnused = 0xFFFFFFFF;
+	std::vector<unsigned int> remap(vertices.size(), kUnused);
+	std::vector<Vertex> output;
+	output.reserve(vertices.size());
+
+	for (size_t i = 0; i < indices.size(); ++i)
+	{
+		unsigned int& target = remap[indices[i]];
+		if (target == kUnused)
+		{
+			target = static_cast<unsigned int>(output.size());
+			output.push_back(vertices[indices[i]]);
+		}
+		indices[i] = target;
+	}
+
+	vertices.swap(output);
+}
+
+MeshOptimizer::Stats MeshOptimizer::AnalyzeVertexCache(const std::vector<unsigned int>& indices, int vertexCount, int cacheSize)
+{
+	Stats stats = { 0.0F, 0.0F };
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0 || vertexCount <= 0)
+		return stats;
+
+	//FIFO, a vertex is cached while fewer than cacheSize misses happened since its own
+	std::vector<unsigned int> cacheTime(vertexCount, 0);
+	std::vector<char> used(vertexCount, 0);
+	unsigned int time = cacheSize + 1;
+	unsigned int misses = 0;
+	unsigned int usedCount = 0;
+	for (size_t i = 0; i < triangleCount * 3; ++i)
+	{
+		const unsigned int v = indices[i];
+		if (time - cacheTime[v] > (unsigned int)cacheSize)
+		{
+			cacheTime[v] = time++;
+			++misses;
+		}
+		if (!used[v])
+		{
+			used[v] = 1;
+			++usedCount;
+		}
+	}
+
+	stats.m_acmr = float(misses) / triangleCount;
+	stats.m_atvr = float(misses) / usedCount;
+	return stats;
+}
+
+void MeshOptimizer::Optimize(Mesh & mesh, Stats * before, Stats * after)
+{
+	std::vector<Vertex> vertices(mesh.GetVertex());
+	std::vector<unsigned int> indices(mesh.GetIndex());
+
+	if (before != nullptr)
+		*before = AnalyzeVertexCache(indices, static_cast<int>(vertices.size()));
+
+	OptimizeVertexCache(indices, static_cast<int>(vertices.size()));
+	OptimizeOverdraw(indices, vertices);
+	OptimizeVertexFetch(vertices, indices);
+
+	if (after != nullptr)
+		*after = AnalyzeVertexCache(indices, static_cast<int>(vertices.size()));
+
+	mesh.SetVertex(vertices);
+	mesh.SetIndex(indices);
+}
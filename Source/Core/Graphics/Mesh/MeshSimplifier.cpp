@@ -0,0 +1,406 @@
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include <unordered_map>
+
+#include "Core\Graphics\Mesh\MeshSimplifier.h"
+#include "Core\Graphics\Mesh\MeshOptimizer.h"
+
+const float MeshSimplifier::kMinLODReduction = 0.85F;
+
+namespace
+{
+	enum VertexKind : unsigned char { kManifold, kBorder, kLocked };
+
+	//symmetric 3x3 A, b and c of x'Ax + 2b'x + c, summed with their area weight
+	struct Quadric
+	{
+		double m_a00, m_a11, m_a22, m_a10, m_a20, m_a21;
+		double m_b0, m_b1, m_b2;
+		double m_c;
+		double m_weight;
+
+		Quadric(void) : m_a00(0), m_a11(0), m_a22(0), m_a10(0), m_a20(0), m_a21(0), m_b0(0), m_b1(0), m_b2(0), m_c(0), m_weight(0) {}
+
+		//unit plane normal (a, b, c), a x + b y + c z + d = 0
+		Quadric(double a, double b, double c, double d, double weight) :
+			m_a00(a * a * weight), m_a11(b * b * weight), m_a22(c * c * weight),
+			m_a10(a * b * weight), m_a20(a * c * weight), m_a21(b * c * weight),
+			m_b0(a * d * weight), m_b1(b * d * weight), m_b2(c * d * weight),
+			m_c(d * d * weight), m_weight(weight) {}
+
+		void Add(const Quadric& other)
+		{
+			m_a00 += other.m_a00; m_a11 += other.m_a11; m_a22 += other.m_a22;
+			m_a10 += other.m_a10; m_a20 += other.m_a20; m_a21 += other.m_a21;
+			m_b0 += other.m_b0; m_b1 += other.m_b1; m_b2 += other.m_b2;
+			m_c += other.m_c;
+			m_weight += other.m_weight;
+		}
+
+		//weighted mean of the squared plane distances
+		double GetError(const float* p) const
+		{
+			const double x = p[0], y = p[1], z = p[2];
+			const double rx = m_a00 * x + m_a10 * y + m_a20 * z;
+			const double ry = m_a10 * x + m_a11 * y + m_a21 * z;
+			const double rz = m_a20 * x + m_a21 * y + m_a22 * z;
+			const double res = rx * x + ry * y + rz * z + 2.0 * (m_b0 * x + m_b1 * y + m_b2 * z) + m_c;
+			return m_weight > 0.0 ? std::fabs(res) / m_weight : 0.0;
+		}
+	};
+
+	struct Collapse
+	{
+		unsigned int m_from;
+		unsigned int m_to;
+		double m_error;
+
+		bool operator<(const Collapse& other) const
+		{
+			if (m_error != other.m_error)
+				return m_error < other.m_error;
+			return m_from != other.m_from ? m_from < other.m_from : m_to < other.m_to;
+		}
+	};
+
+	//center of the bounding box, returns the radius around it
+	float GetBoundingSphere(const std::vector<Vertex>& vertices, float* center)
+	{
+		float boundsMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float boundsMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		for (size_t i = 0; i < vertices.size(); ++i)
+		{
+			const Vector3& position = vertices[i].m_position;
+			boundsMin[0] = std::min(boundsMin[0], position.X); boundsMax[0] = std::max(boundsMax[0], position.X);
+			boundsMin[1] = std::min(boundsMin[1], position.Y); boundsMax[1] = std::max(boundsMax[1], position.Y);
+			boundsMin[2] = std::min(boundsMin[2], position.Z); boundsMax[2] = std::max(boundsMax[2], position.Z);
+		}
+		for (int k = 0; k < 3; ++k)
+			center[k] = vertices.empty() ? 0.0F : (boundsMin[k] + boundsMax[k]) * 0.5F;
+
+		float radiusSquared = 0.0F;
+		for (size_t i = 0; i < vertices.size(); ++i)
+		{
+			const Vector3& position = vertices[i].m_position;
+			const float x = position.X - center[0];
+			const float y = position.Y - center[1];
+			const float z = position.Z - center[2];
+			radiusSquared = std::max(radiusSquared, x * x + y * y + z * z);
+		}
+		return std::sqrt(radiusSquared);
+	}
+
+	typedef std::unordered_map<unsigned long long, unsigned int> EdgeMap;
+
+	unsigned long long MakeEdgeKey(unsigned int a, unsigned int b)
+	{
+		return a < b ? ((unsigned long long)a << 32) | b : ((unsigned long long)b << 32) | a;
+	}
+
+	//triangles on each edge, 1 is a border
+	void CountEdges(const std::vector<unsigned int>& indices, EdgeMap& edges)
+	{
+		edges.clear();
+		edges.reserve(indices.size());
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+			for (int k = 0; k < 3; ++k)
+				++edges[MakeEdgeKey(indices[i + k], indices[i + (k + 1) % 3])];
+	}
+
+	void Cross(const float* a, const float* b, const float* c, double* n)
+	{
+		const double e0[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+		const double e1[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+		n[0] = e0[1] * e1[2] - e0[2] * e1[1];
+		n[1] = e0[2] * e1[0] - e0[0] * e1[2];
+		n[2] = e0[0] * e1[1] - e0[1] * e1[0];
+	}
+
+	//moving from onto to turns a triangle around, or squeezes it flat
+	bool HasFlip(unsigned int from, unsigned int to, const std::vector<float>& positions, const std::vector<unsigned int>& indices,
+		const std::vector<unsigned int>& offsets, const std::vector<unsigned int>& adjacency)
+	{
+		for (unsigned int i = offsets[from]; i < offsets[from + 1]; ++i)
+		{
+			const unsigned int* triangle = &indices[adjacency[i] * 3];
+			if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+				continue;
+
+			double before[3], after[3];
+			Cross(&positions[triangle[0] * 3], &positions[triangle[1] * 3], &positions[triangle[2] * 3], before);
+			const unsigned int moved[3] = {
+				triangle[0] == from ? to : triangle[0],
+				triangle[1] == from ? to : triangle[1],
+				triangle[2] == from ? to : triangle[2] };
+			Cross(&positions[moved[0] * 3], &positions[moved[1] * 3], &positions[moved[2] * 3], after);
+
+			const double dot = before[0] * after[0] + before[1] * after[1] + before[2] * after[2];
+			const double lengths = (before[0] * before[0] + before[1] * before[1] + before[2] * before[2]) * (after[0] * after[0] + after[1] * after[1] + after[2] * after[2]);
+			//cos below 0.1
+			if (dot <= 0.0 || dot * dot < 0.01 * lengths)
+				return true;
+		}
+		return false;
+	}
+}
+
+float MeshSimplifier::Simplify(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, size_t targetIndexCount, float maxError, std::vector<unsigned int>& result)
+{
+	result = indices;
+	const unsigned int vertexCount = vertices.size();
+	if (vertexCount == 0 || indices.size() <= targetIndexCount)
+		return 0.0F;
+
+	//around the bounds center and over the radius, errors come out relative
+	float center[3];
+	const float radius = GetBoundingSphere(vertices, center);
+	const float scale = radius > 0.0F ? 1.0F / radius : 1.0F;
+
+	std::vector<float> positions(vertexCount * 3);
+	for (unsigned int v = 0; v < vertexCount; ++v)
+	{
+		positions[v * 3 + 0] = (vertices[v].m_position.X - center[0]) * scale;
+		positions[v * 3 + 1] = (vertices[v].m_position.Y - center[1]) * scale;
+		positions[v * 3 + 2] = (vertices[v].m_position.Z - center[2]) * scale;
+	}
+
+	//split vertices (same position, other normal / uv) keep the seam where it is
+	std::vector<VertexKind> kinds(vertexCount, kManifold);
+	{
+		std::vector<unsigned int> order(vertexCount);
+		for (unsigned int v = 0; v < vertexCount; ++v)
+			order[v] = v;
+		std::sort(order.begin(), order.end(), [&positions](unsigned int a, unsigned int b) {
+			return std::lexicographical_compare(&positions[a * 3], &positions[a * 3 + 3], &positions[b * 3], &positions[b * 3 + 3]);
+		});
+		for (unsigned int i = 0; i + 1 < vertexCount; ++i)
+		{
+			const float* a = &positions[order[i] * 3];
+			const float* b = &positions[order[i + 1] * 3];
+			if (a[0] == b[0] && a[1] == b[1] && a[2] == b[2])
+				kinds[order[i]] = kinds[order[i + 1]] = kLocked;
+		}
+	}
+
+	EdgeMap edges;
+	CountEdges(result, edges);
+
+	//plane of every triangle, area weighted, plus a plane through every border edge
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t i = 0; i + 2 < result.size(); i += 3)
+	{
+		const unsigned int* triangle = &result[i];
+		double normal[3];
+		Cross(&positions[triangle[0] * 3], &positions[triangle[1] * 3], &positions[triangle[2] * 3], normal);
+		const double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		if (length == 0.0)
+			continue;
+		for (int k = 0; k < 3; ++k)
+			normal[k] /= length;
+
+		const float* p0 = &positions[triangle[0] * 3];
+		const Quadric plane(normal[0], normal[1], normal[2], -(normal[0] * p0[0] + normal[1] * p0[1] + normal[2] * p0[2]), length * 0.5);
+		for (int k = 0; k < 3; ++k)
+			quadrics[triangle[k]].Add(plane);
+
+		for (int k = 0; k < 3; ++k)
+		{
+			const unsigned int a = triangle[k];
+			const unsigned int b = triangle[(k + 1) % 3];
+			const unsigned int count = edges[MakeEdgeKey(a, b)];
+			if (count == 1)
+			{
+				//perpendicular to the triangle, through the edge
+				const float* pa = &positions[a * 3];
+				const float* pb = &positions[b * 3];
+				const double edge[3] = { pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2] };
+				double borderNormal[3] = {
+					edge[1] * normal[2] - edge[2] * normal[1],
+					edge[2] * normal[0] - edge[0] * normal[2],
+					edge[0] * normal[1] - edge[1] * normal[0] };
+				const double edgeLength = std::sqrt(edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2]);
+				if (edgeLength == 0.0)
+					continue;
+				for (int j = 0; j < 3; ++j)
+					borderNormal[j] /= edgeLength;
+
+				const Quadric border(borderNormal[0], borderNormal[1], borderNormal[2],
+					-(borderNormal[0] * pa[0] + borderNormal[1] * pa[1] + borderNormal[2] * pa[2]), edgeLength * edgeLength * kBorderWeight);
+				quadrics[a].Add(border);
+				quadrics[b].Add(border);
+				if (kinds[a] == kManifold)
+					kinds[a] = kBorder;
+				if (kinds[b] == kManifold)
+					kinds[b] = kBorder;
+			}
+			else if (count > 2)
+			{
+				//non manifold, left alone
+				kinds[a] = kinds[b] = kLocked;
+			}
+		}
+	}
+
+	const double maxErrorSquared = (double)maxError * maxError;
+	double resultError = 0.0;
+
+	std::vector<Collapse> collapses;
+	std::vector<unsigned int> remap(vertexCount);
+	std::vector<unsigned char> touched(vertexCount);
+	std::vector<unsigned int> offsets(vertexCount + 1);
+	std::vector<unsigned int> adjacency;
+
+	//greedy passes: cheapest collapses first, a vertex and its ring change once a pass
+	while (result.size() > targetIndexCount)
+	{
+		const size_t triangleCount = result.size() / 3;
+
+		collapses.clear();
+		for (EdgeMap::const_iterator it = edges.begin(); it != edges.end(); ++it)
+		{
+			const unsigned int a = (unsigned int)(it->first >> 32);
+			const unsigned int b = (unsigned int)(it->first & 0xFFFFFFFF);
+			const bool isBorderEdge = it->second == 1;
+
+			Quadric quadric = quadrics[a];
+			quadric.Add(quadrics[b]);
+
+			Collapse collapse;
+			collapse.m_error = DBL_MAX;
+			for (int k = 0; k < 2; ++k)
+			{
+				const unsigned int from = k == 0 ? a : b;
+				const unsigned int to = k == 0 ? b : a;
+				//a border vertex slides onto the next border vertex, along the border
+				if (kinds[from] == kLocked || (kinds[from] == kBorder && (!isBorderEdge || kinds[to] == kManifold)))
+					continue;
+
+				const double error = quadric.GetError(&positions[to * 3]);
+				if (error < collapse.m_error)
+				{
+					collapse.m_from = from;
+					collapse.m_to = to;
+					collapse.m_error = error;
+				}
+			}
+			if (collapse.m_error != DBL_MAX)
+				collapses.push_back(collapse);
+		}
+		if (collapses.empty())
+			break;
+		std::sort(collapses.begin(), collapses.end());
+
+		//vertex to triangle lists for the flip test
+		std::fill(offsets.begin(), offsets.end(), 0);
+		for (size_t i = 0; i < result.size(); ++i)
+			++offsets[result[i] + 1];
+		for (unsigned int v = 0; v < vertexCount; ++v)
+			offsets[v + 1] += offsets[v];
+		adjacency.resize(result.size());
+		{
+			std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < result.size(); ++i)
+				adjacency[cursor[result[i]]++] = (unsigned int)(i / 3);
+		}
+
+		for (unsigned int v = 0; v < vertexCount; ++v)
+			remap[v] = v;
+		std::fill(touched.begin(), touched.end(), 0);
+
+		//an inner collapse takes 2 triangles
+		const size_t collapseGoal = std::max<size_t>(1, (triangleCount - targetIndexCount / 3 + 1) / 2);
+		size_t collapseCount = 0;
+		for (size_t i = 0; i < collapses.size() && collapseCount < collapseGoal; ++i)
+		{
+			const Collapse& collapse = collapses[i];
+			if (collapse.m_error > maxErrorSquared)
+				break;
+			if (touched[collapse.m_from] || touched[collapse.m_to])
+				continue;
+			if (HasFlip(collapse.m_from, collapse.m_to, positions, result, offsets, adjacency))
+				continue;
+
+			//every triangle changed here has all its vertices touched, later tests of the pass see none of them
+			for (unsigned int j = offsets[collapse.m_from]; j < offsets[collapse.m_from + 1]; ++j)
+				for (int k = 0; k < 3; ++k)
+					touched[result[adjacency[j] * 3 + k]] = 1;
+			touched[collapse.m_to] = 1;
+
+			remap[collapse.m_from] = collapse.m_to;
+			quadrics[collapse.m_to].Add(quadrics[collapse.m_from]);
+			resultError = std::max(resultError, collapse.m_error);
+			++collapseCount;
+		}
+		if (collapseCount == 0)
+			break;
+
+		//remap and drop the triangles that lost an edge
+		size_t write = 0;
+		for (size_t i = 0; i + 2 < result.size(); i += 3)
+		{
+			const unsigned int a = remap[result[i]];
+			const unsigned int b = remap[result[i + 1]];
+			const unsigned int c = remap[result[i + 2]];
+			if (a == b || b == c || c == a)
+				continue;
+			result[write++] = a;
+			result[write++] = b;
+			result[write++] = c;
+		}
+		result.resize(write);
+
+		CountEdges(result, edges);
+	}
+
+	return (float)std::sqrt(resultError);
+}
+
+int MeshSimplifier::GenerateLODs(Mesh & mesh, const float * ratios, int ratioCount)
+{
+	const std::vector<Vertex>& vertices = mesh.GetVertex();
+	const std::vector<unsigned int>& indices = mesh.GetIndex();
+
+	std::vector<MeshLOD> lods;
+	std::vector<unsigned int> lodIndices;
+	std::vector<unsigned int> result;
+	size_t lastIndexCount = indices.size();
+	float lastError = 0.0F;
+	for (int i = 0; i < ratioCount && (int)lods.size() + 1 < Mesh::kMaxLODCount; ++i)
+	{
+		//every LOD from the full mesh, the errors measure against the source surface
+		const size_t targetIndexCount = (size_t)(indices.size() / 3 * ratios[i]) * 3;
+		const float error = Simplify(vertices, indices, targetIndexCount, FLT_MAX, result);
+
+		//locked seams can stop the collapses short
+		if (result.empty() || result.size() > lastIndexCount * kMinLODReduction)
+			break;
+
+		MeshOptimizer::OptimizeVertexCache(result, vertices.size());
+
+		MeshLOD lod;
+		lod.m_firstIndex = indices.size() + lodIndices.size();
+		lod.m_indexCount = result.size();
+		lod.m_error = std::max(error, lastError);
+		lods.push_back(lod);
+		lodIndices.insert(lodIndices.end(), result.begin(), result.end());
+
+		lastIndexCount = result.size();
+		lastError = lod.m_error;
+	}
+
+	mesh.SetLODs(lods, lodIndices);
+	return mesh.GetLODCount();
+}
+
+int MeshSimplifier::GenerateLODs(Mesh & mesh)
+{
+	const float ratios[] = { 0.5F, 0.25F, 0.125F };
+	return GenerateLODs(mesh, ratios, sizeof(ratios) / sizeof(ratios[0]));
+}
+
+float MeshSimplifier::GetBoundingRadius(const std::vector<Vertex>& vertices)
+{
+	float center[3];
+	return GetBoundingSphere(vertices, center);
+}
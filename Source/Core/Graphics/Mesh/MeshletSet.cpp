@@ -0,0 +1,226 @@
+#include <cmath>
+#include <cfloat>
+#include <cstring>
+#include <algorithm>
+
+#include "Core\Graphics\Mesh\MeshletSet.h"
+#include "Core\Graphics\Mesh\MeshOptimizer.h"
+#include "Core\Math\Frustum.h"
+#include "Core\Math\Simd\CullWriter.h"
+
+#if SIMD_X86
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	//a cone wider than this faces the camera from everywhere
+	const float kMinConeSpread = 0.1F;
+
+	//4 meshlets from first, bit set when the cone may face the camera
+	uint32_t TestCones(const Vector3Stream& centers, const float* radii, const Vector3Stream& axes, const float* cutoffs, size_t first, const Vector3& camera)
+	{
+		//culled when dot(center - camera, axis) >= cutoff * |center - camera| + radius
+#if SIMD_X86
+		const __m128 dx = _mm_sub_ps(_mm_load_ps(centers.GetX() + first), _mm_set1_ps(camera.X));
+		const __m128 dy = _mm_sub_ps(_mm_load_ps(centers.GetY() + first), _mm_set1_ps(camera.Y));
+		const __m128 dz = _mm_sub_ps(_mm_load_ps(centers.GetZ() + first), _mm_set1_ps(camera.Z));
+		const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, _mm_load_ps(axes.GetX() + first)), _mm_mul_ps(dy, _mm_load_ps(axes.GetY() + first))), _mm_mul_ps(dz, _mm_load_ps(axes.GetZ() + first)));
+		const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+		const __m128 limit = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(cutoffs + first), length), _mm_loadu_ps(radii + first));
+		return ~_mm_movemask_ps(_mm_cmpge_ps(dot, limit)) & 0xF;
+#else
+		uint32_t bits = 0;
+		for (size_t k = 0; k < 4; ++k)
+		{
+			const size_t i = first + k;
+			const float dx = centers.GetX()[i] - camera.X;
+			const float dy = centers.GetY()[i] - camera.Y;
+			const float dz = centers.GetZ()[i] - camera.Z;
+			const float dot = dx * axes.GetX()[i] + dy * axes.GetY()[i] + dz * axes.GetZ()[i];
+			if (dot < cutoffs[i] * std::sqrt(dx * dx + dy * dy + dz * dz) + radii[i])
+				bits |= 1U << k;
+		}
+		return bits;
+#endif
+	}
+}
+
+void MeshletSet::Build(const Mesh & mesh)
+{
+	Clear();
+
+	const std::vector<Vertex>& vertices = mesh.GetVertex();
+	m_indices = mesh.GetIndex();
+	if (vertices.empty() || m_indices.size() < 3)
+		return;
+
+	//neighbouring triangles next to each other, a scan then cuts compact meshlets
+	MeshOptimizer::OptimizeVertexCache(m_indices, vertices.size());
+
+	//meshlet that last took each vertex
+	std::vector<uint32_t> owner(vertices.size(), 0xFFFFFFFF);
+	Meshlet meshlet = { 0, 0, 0 };
+	for (size_t i = 0; i + 2 < m_indices.size(); i += 3)
+	{
+		const unsigned int a = m_indices[i], b = m_indices[i + 1], c = m_indices[i + 2];
+		const uint32_t id = static_cast<uint32_t>(m_meshlets.size());
+		uint32_t newVertices = (owner[a] != id) + (owner[b] != id && b != a) + (owner[c] != id && c != a && c != b);
+
+		if (meshlet.m_vertexCount + newVertices > kMaxVertices || meshlet.m_indexCount >= kMaxTriangles * 3)
+		{
+			m_meshlets.push_back(meshlet);
+			meshlet.m_firstIndex = static_cast<uint32_t>(i);
+			meshlet.m_indexCount = 0;
+			meshlet.m_vertexCount = 0;
+			newVertices = 1 + (b != a) + (c != a && c != b);
+		}
+
+		const uint32_t current = static_cast<uint32_t>(m_meshlets.size());
+		owner[a] = owner[b] = owner[c] = current;
+		meshlet.m_vertexCount += newVertices;
+		meshlet.m_indexCount += 3;
+	}
+	if (meshlet.m_indexCount > 0)
+		m_meshlets.push_back(meshlet);
+
+	ComputeBounds(vertices);
+}
+
+void MeshletSet::Clear(void)
+{
+	m_meshlets.clear();
+	m_indices.clear();
+	m_centers.Clear();
+	m_radii.clear();
+	m_coneAxes.Clear();
+	m_coneCutoffs.clear();
+}
+
+void MeshletSet::ComputeBounds(const std::vector<Vertex>& vertices)
+{
+	const size_t count = m_meshlets.size();
+	m_centers.Resize(count);
+	m_coneAxes.Resize(count);
+	//padded like the streams, the cone test reads whole blocks
+	m_radii.assign(m_centers.GetPaddedCount(), 0.0F);
+	m_coneCutoffs.assign(m_centers.GetPaddedCount(), 1.0F);
+
+	for (size_t m = 0; m < count; ++m)
+	{
+		const Meshlet& meshlet = m_meshlets[m];
+		const unsigned int* indices = &m_indices[meshlet.m_firstIndex];
+
+		//sphere around the box center
+		float boundsMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float boundsMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		for (uint32_t i = 0; i < meshlet.m_indexCount; ++i)
+		{
+			const float* p = vertices[indices[i]].m_position.GetPtr();
+			for (int k = 0; k < 3; ++k)
+			{
+				boundsMin[k] = std::min(boundsMin[k], p[k]);
+				boundsMax[k] = std::max(boundsMax[k], p[k]);
+			}
+		}
+		const float center[3] = { (boundsMin[0] + boundsMax[0]) * 0.5F, (boundsMin[1] + boundsMax[1]) * 0.5F, (boundsMin[2] + boundsMax[2]) * 0.5F };
+		float radiusSquared = 0.0F;
+		for (uint32_t i = 0; i < meshlet.m_indexCount; ++i)
+		{
+			const float* p = vertices[indices[i]].m_position.GetPtr();
+			const float x = p[0] - center[0], y = p[1] - center[1], z = p[2] - center[2];
+			radiusSquared = std::max(radiusSquared, x * x + y * y + z * z);
+		}
+
+		//cone axis is the mean triangle normal, the spread its widest angle to one
+		std::vector<float> normals;
+		normals.reserve(meshlet.m_indexCount);
+		float axis[3] = { 0.0F, 0.0F, 0.0F };
+		for (uint32_t i = 0; i + 2 < meshlet.m_indexCount; i += 3)
+		{
+			const float* p0 = vertices[indices[i]].m_position.GetPtr();
+			const float* p1 = vertices[indices[i + 1]].m_position.GetPtr();
+			const float* p2 = vertices[indices[i + 2]].m_position.GetPtr();
+			const float e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			const float e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			float normal[3] = { e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0] };
+			const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			if (length == 0.0F)
+				continue;
+			for (int k = 0; k < 3; ++k)
+			{
+				normal[k] /= length;
+				axis[k] += normal[k];
+				normals.push_back(normal[k]);
+			}
+		}
+
+		float cutoff = 1.0F;
+		const float axisLength = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+		if (axisLength > 0.0F)
+		{
+			for (int k = 0; k < 3; ++k)
+				axis[k] /= axisLength;
+
+			float minDot = 1.0F;
+			for (size_t i = 0; i < normals.size(); i += 3)
+				minDot = std::min(minDot, normals[i] * axis[0] + normals[i + 1] * axis[1] + normals[i + 2] * axis[2]);
+			//sin of the spread, the test works on the bounding sphere so no apex is needed
+			if (minDot > kMinConeSpread)
+				cutoff = std::sqrt(1.0F - minDot * minDot);
+		}
+
+		m_centers.Set(m, Vector3(center[0], center[1], center[2]));
+		m_radii[m] = std::sqrt(radiusSquared);
+		m_coneAxes.Set(m, Vector3(axis[0], axis[1], axis[2]));
+		m_coneCutoffs[m] = cutoff;
+	}
+}
+
+size_t MeshletSet::Cull(const Frustum & frustum, const Vector3 & cameraPosition, uint32_t * visibleMeshlets) const
+{
+	const size_t count = m_meshlets.size();
+	if (count == 0)
+		return 0;
+
+	m_frustumMask.resize(GetCullMaskSize(count));
+	if (CullSpheres(frustum, m_centers, m_radii.data(), m_frustumMask.data(), nullptr) == 0)
+		return 0;
+
+	//blocks of 4 never straddle a mask word, whole words outside are skipped
+	size_t visible = 0;
+	for (size_t i = 0; i < count; i += 4)
+	{
+		uint32_t bits = (m_frustumMask[i >> 5] >> (i & 31)) & CullWriter::LaneMask(i, count, 4);
+		if (bits == 0)
+			continue;
+
+		bits &= TestCones(m_centers, m_radii.data(), m_coneAxes, m_coneCutoffs.data(), i, cameraPosition);
+		while (bits != 0)
+		{
+			visibleMeshlets[visible++] = static_cast<uint32_t>(i + CullWriter::CountTrailingZeros(bits));
+			bits &= bits - 1;
+		}
+	}
+	return visible;
+}
+
+size_t MeshletSet::CullIndices(const Frustum & frustum, const Vector3 & cameraPosition, std::vector<unsigned int>& indices) const
+{
+	m_visible.resize(m_meshlets.size());
+	const size_t visible = Cull(frustum, cameraPosition, m_visible.data());
+
+	size_t indexCount = 0;
+	for (size_t i = 0; i < visible; ++i)
+		indexCount += m_meshlets[m_visible[i]].m_indexCount;
+
+	indices.resize(indexCount);
+	unsigned int* output = indices.data();
+	for (size_t i = 0; i < visible; ++i)
+	{
+		const Meshlet& meshlet = m_meshlets[m_visible[i]];
+		memcpy(output, &m_indices[meshlet.m_firstIndex], meshlet.m_indexCount * sizeof(unsigned int));
+		output += meshlet.m_indexCount;
+	}
+	return visible;
+}
@@ -0,0 +1,289 @@
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#include "Core\Graphics\Mesh\VertexQuantize.h"
+#include "Core\Math\Simd\SimdConfig.h"
+
+#if SIMD_X86
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	float Clamp(float value, float minValue, float maxValue)
+	{
+		return std::min(std::max(value, minValue), maxValue);
+	}
+
+	//components of one value, missing ones are 1
+	void LoadScalar(const char* source, int sourceComponents, int componentCount, float* value)
+	{
+		const int loadCount = std::min(sourceComponents, componentCount);
+		memcpy(value, source, loadCount * sizeof(float));
+		for (int i = loadCount; i < componentCount; ++i)
+			value[i] = 1.0F;
+	}
+
+	void OctahedralEncode(const float* normal, float& x, float& y)
+	{
+		const float sum = std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]);
+		const float invSum = sum > 0.0F ? 1.0F / sum : 0.0F;
+		x = normal[0] * invSum;
+		y = normal[1] * invSum;
+		if (normal[2] < 0.0F)
+		{
+			const float foldX = (1.0F - std::abs(y)) * (x >= 0.0F ? 1.0F : -1.0F);
+			const float foldY = (1.0F - std::abs(x)) * (y >= 0.0F ? 1.0F : -1.0F);
+			x = foldX;
+			y = foldY;
+		}
+	}
+
+	int16_t ToSnorm16(float value)
+	{
+		return static_cast<int16_t>(std::lrint(Clamp(value, -1.0F, 1.0F) * 32767.0F));
+	}
+
+	uint16_t ToUnorm16(float value)
+	{
+		return static_cast<uint16_t>(std::lrint(Clamp(value, 0.0F, 1.0F) * 65535.0F));
+	}
+
+#if SIMD_X86
+	//up to 4 components, the missing ones from fill
+	SIMD_FORCE_INLINE __m128 LoadComponents(const char* source, int sourceComponents, __m128 fill)
+	{
+		const float* value = reinterpret_cast<const float*>(source);
+		__m128 res;
+		switch (sourceComponents)
+		{
+		case 1: res = _mm_load_ss(value); break;
+		case 2: res = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(value))); break;
+		case 3: res = _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(value))), _mm_load_ss(value + 2)); break;
+		default: return _mm_loadu_ps(value);
+		}
+		return _mm_or_ps(res, fill);
+	}
+
+	__m128 GetFill(int sourceComponents, int componentCount)
+	{
+		SIMD_ALIGN(16) float fill[4];
+		for (int i = 0; i < 4; ++i)
+			fill[i] = i >= sourceComponents && i < componentCount ? 1.0F : 0.0F;
+		return _mm_load_ps(fill);
+	}
+
+	//4 halves in the low 16 bits of each lane, sign bits smeared above
+	SIMD_FORCE_INLINE __m128i FloatToHalf4(__m128 value)
+	{
+		const __m128i maxValue = _mm_set1_epi32((127 + 16) << 23);		//rounds to inf from here
+		const __m128i minNormal = _mm_set1_epi32((127 - 14) << 23);
+		const __m128i subnormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+		const __m128i normalBias = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+
+		const __m128 sign = _mm_and_ps(value, _mm_castsi128_ps(_mm_set1_epi32(0x80000000)));
+		const __m128 absValue = _mm_xor_ps(value, sign);
+		const __m128i absBits = _mm_castps_si128(absValue);
+
+		const __m128i isNaN = _mm_castps_si128(_mm_cmpunord_ps(absValue, absValue));
+		const __m128i isRegular = _mm_cmpgt_epi32(maxValue, absBits);
+		const __m128i special = _mm_or_si128(_mm_and_si128(isNaN, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7C00));
+
+		//subnormal half, the float add rounds the mantissa
+		const __m128i isSubnormal = _mm_cmpgt_epi32(minNormal, absBits);
+		const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absValue, _mm_castsi128_ps(subnormalMagic))), subnormalMagic);
+
+		//normal half, odd mantissas round up on ties
+		const __m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(absBits, 31 - 13), 31);
+		const __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(absBits, normalBias), mantissaOdd), 13);
+
+		__m128i res = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+		res = _mm_or_si128(_mm_and_si128(isRegular, res), _mm_andnot_si128(isRegular, special));
+		return _mm_or_si128(res, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+	}
+
+	SIMD_FORCE_INLINE void Store16(char* output, __m128i value, int componentCount)
+	{
+		SIMD_ALIGN(16) int16_t lanes[8];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_packs_epi32(value, value));
+		memcpy(output, lanes, componentCount * sizeof(int16_t));
+	}
+#endif
+}
+
+uint16_t FloatToHalf(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	const uint32_t sign = bits & 0x80000000;
+	bits ^= sign;
+
+	uint16_t res;
+	if (bits >= ((127 + 16) << 23))
+		res = bits > (255u << 23) ? 0x7E00 : 0x7C00;
+	else if (bits < ((127 - 14) << 23))
+	{
+		const uint32_t magicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+		float magic, absValue;
+		memcpy(&magic, &magicBits, sizeof(magic));
+		memcpy(&absValue, &bits, sizeof(absValue));
+		absValue += magic;
+		memcpy(&bits, &absValue, sizeof(bits));
+		res = static_cast<uint16_t>(bits - magicBits);
+	}
+	else
+	{
+		const uint32_t mantissaOdd = (bits >> 13) & 1;
+		bits += 0xFFF - ((127 - 15) << 23) + mantissaOdd;
+		res = static_cast<uint16_t>(bits >> 13);
+	}
+	return res | static_cast<uint16_t>(sign >> 16);
+}
+
+float HalfToFloat(uint16_t value)
+{
+	const uint32_t sign = (value & 0x8000u) << 16;
+	const uint32_t exponent = (value >> 10) & 0x1F;
+	const uint32_t mantissa = value & 0x3FF;
+
+	uint32_t bits;
+	if (exponent == 0x1F)
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	else if (exponent != 0)
+		bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+	else
+	{
+		//subnormal, mantissa * 2^-24
+		float res = static_cast<float>(mantissa) * (1.0F / 16777216.0F);
+		return sign != 0 ? -res : res;
+	}
+
+	float res;
+	memcpy(&res, &bits, sizeof(res));
+	return res;
+}
+
+void QuantizeHalf(const char * source, size_t sourceStride, int sourceComponents, char * output, size_t outputStride, int componentCount, size_t count)
+{
+#if SIMD_X86
+	const __m128 fill = GetFill(sourceComponents, componentCount);
+	for (size_t i = 0; i < count; ++i, source += sourceStride, output += outputStride)
+		Store16(output, FloatToHalf4(LoadComponents(source, sourceComponents, fill)), componentCount);
+#else
+	float value[4];
+	for (size_t i = 0; i < count; ++i, source += sourceStride, output += outputStride)
+	{
+		LoadScalar(source, sourceComponents, componentCount, value);
+		uint16_t* res = reinterpret_cast<uint16_t*>(output);
+		for (int j = 0; j < componentCount; ++j)
+			res[j] = FloatToHalf(value[j]);
+	}
+#endif
+}
+
+void QuantizeSnorm16(const char * source, size_t sourceStride, int sourceComponents, char * output, size_t outputStride, int componentCount, size_t count)
+{
+#if SIMD_X86
+	const __m128 fill = GetFill(sourceComponents, componentCount);
+	const __m128 minValue = _mm_set1_ps(-1.0F);
+	const __m128 maxValue = _mm_set1_ps(1.0F);
+	const __m128 scale = _mm_set1_ps(32767.0F);
+	for (size_t i = 0; i < count; ++i, source += sourceStride, output += outputStride)
+	{
+		__m128 value = _mm_min_ps(_mm_max_ps(LoadComponents(source, sourceComponents, fill), minValue), maxValue);
+		Store16(output, _mm_cvtps_epi32(_mm_mul_ps(value, scale)), componentCount);
+	}
+#else
+	float value[4];
+	for (size_t i = 0; i < count; ++i, source += sourceStride, output += outputStride)
+	{
+		LoadScalar(source, sourceComponents, componentCount, value);
+		int16_t* res = reinterpret_cast<int16_t*>(output);
+		for (int j = 0; j < componentCount; ++j)
+			res[j] = ToSnorm16(value[j]);
+	}
+#endif
+}
+
+void QuantizeUnorm16(const char * source, size_t sourceStride, int sourceComponents, char * output, size_t outputStride, int componentCount, size_t count)
+{
+#if SIMD_X86
+	const __m128 fill = GetFill(sourceComponents, componentCount);
+	const __m128 minValue = _mm_setzero_ps();
+	const __m128 maxValue = _mm_set1_ps(1.0F);
+	const __m128 scale = _mm_set1_ps(65535.0F);
+	//SSE2 only packs signed, shift into the signed range and back
+	const __m128i bias = _mm_set1_epi32(32768);
+	for (size_t i = 0; i < count; ++i, source += sourceStride, output += outputStride)
+	{
+		__m128 value = _mm_min_ps(_mm_max_ps(LoadComponents(source, sourceComponents, fill), minValue), maxValue);
+		__m128i res = _mm_sub_epi32(_mm_cvtps_epi32(_mm_mul_ps(value, scale)), bias);
+		res = _mm_xor_si128(_mm_packs_epi32(res, res), _mm_set1_epi16((short)0x8000));
+		SIMD_ALIGN(16) uint16_t lanes[8];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), res);
+		memcpy(output, lanes, componentCount * sizeof(uint16_t));
+	}
+#else
+	float value[4];
+	for (size_t i = 0; i < count; ++i, source += sourceStride, output += outputStride)
+	{
+		LoadScalar(source, sourceComponents, componentCount, value);
+		uint16_t* res = reinterpret_cast<uint16_t*>(output);
+		for (int j = 0; j < componentCount; ++j)
+			res[j] = ToUnorm16(value[j]);
+	}
+#endif
+}
+
+void QuantizeOctahedral(const char * source, size_t sourceStride, char * output, size_t outputStride, size_t count)
+{
+	size_t i = 0;
+#if SIMD_X86
+	//4 normals at a time, gathered into x / y / z lanes
+	const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+	const __m128 one = _mm_set1_ps(1.0F);
+	const __m128 scale = _mm_set1_ps(32767.0F);
+	for (; i + 4 <= count; i += 4, source += sourceStride * 4, output += outputStride * 4)
+	{
+		const float* n0 = reinterpret_cast<const float*>(source);
+		const float* n1 = reinterpret_cast<const float*>(source + sourceStride);
+		const float* n2 = reinterpret_cast<const float*>(source + sourceStride * 2);
+		const float* n3 = reinterpret_cast<const float*>(source + sourceStride * 3);
+		const __m128 x = _mm_setr_ps(n0[0], n1[0], n2[0], n3[0]);
+		const __m128 y = _mm_setr_ps(n0[1], n1[1], n2[1], n3[1]);
+		const __m128 z = _mm_setr_ps(n0[2], n1[2], n2[2], n3[2]);
+
+		const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, x), _mm_andnot_ps(signMask, y)), _mm_andnot_ps(signMask, z));
+		const __m128 nonZero = _mm_cmpgt_ps(sum, _mm_setzero_ps());
+		const __m128 invSum = _mm_and_ps(_mm_div_ps(one, sum), nonZero);
+		__m128 octX = _mm_mul_ps(x, invSum);
+		__m128 octY = _mm_mul_ps(y, invSum);
+
+		//lower hemisphere folds over the diagonals, sign of 0 is +
+		const __m128 signX = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(octX, _mm_setzero_ps()), signMask), one);
+		const __m128 signY = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(octY, _mm_setzero_ps()), signMask), one);
+		const __m128 foldX = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, octY)), signX);
+		const __m128 foldY = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, octX)), signY);
+		const __m128 isLower = _mm_cmplt_ps(z, _mm_setzero_ps());
+		octX = _mm_or_ps(_mm_and_ps(isLower, foldX), _mm_andnot_ps(isLower, octX));
+		octY = _mm_or_ps(_mm_and_ps(isLower, foldY), _mm_andnot_ps(isLower, octY));
+
+		const __m128i ix = _mm_cvtps_epi32(_mm_mul_ps(octX, scale));
+		const __m128i iy = _mm_cvtps_epi32(_mm_mul_ps(octY, scale));
+		//x0 y0 x1 y1 x2 y2 x3 y3
+		SIMD_ALIGN(16) int32_t pairs[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(pairs), _mm_packs_epi32(_mm_unpacklo_epi32(ix, iy), _mm_unpackhi_epi32(ix, iy)));
+		for (int j = 0; j < 4; ++j)
+			memcpy(output + outputStride * j, &pairs[j], sizeof(int32_t));
+	}
+#endif
+	for (; i < count; ++i, source += sourceStride, output += outputStride)
+	{
+		float x, y;
+		OctahedralEncode(reinterpret_cast<const float*>(source), x, y);
+		int16_t* res = reinterpret_cast<int16_t*>(output);
+		res[0] = ToSnorm16(x);
+		res[1] = ToSnorm16(y);
+	}
+}
@@ -0,0 +1,214 @@
+#include <cstring>
+#include <algorithm>
+
+#include "Core\Graphics\Mesh\Mesh.h"
+#include "Core\Graphics\Mesh\VertexLayout.h"
+#include "Core\Graphics\Material.h"
+#include "Core\Graphics\Shader.h"
+#include "Core\Graphics\InstanceTransform.h"
+#include "Core\Graphics\Null\NullGfxDevice.h"
+#include "Core\Log\Debug.h"
+
+void GfxDeviceStats::Reset(void)
+{
+	m_drawCalls = 0;
+	m_triangles = 0;
+	m_vertices = 0;
+	m_instances = 0;
+	m_clears = 0;
+	m_programChanges = 0;
+	m_vertexArrayChanges = 0;
+	m_redundantBinds = 0;
+	m_meshUploads = 0;
+	m_programCreates = 0;
+	m_bytesUploaded = 0;
+}
+
+void GfxDeviceStats::Add(const GfxDeviceStats& other)
+{
+	m_drawCalls += other.m_drawCalls;
+	m_triangles += other.m_triangles;
+	m_vertices += other.m_vertices;
+	m_instances += other.m_instances;
+	m_clears += other.m_clears;
+	m_programChanges += other.m_programChanges;
+	m_vertexArrayChanges += other.m_vertexArrayChanges;
+	m_redundantBinds += other.m_redundantBinds;
+	m_meshUploads += other.m_meshUploads;
+	m_programCreates += other.m_programCreates;
+	m_bytesUploaded += other.m_bytesUploaded;
+}
+
+void NullGfxDevice::Init()
+{
+	Debug::Log("NullGfxDevice Init Success");
+}
+
+void NullGfxDevice::Destroy(void)
+{
+	m_meshTable.Clear();
+	m_programTable.Clear();
+	m_releasedMeshes.clear();
+	m_boundProgram = 0;
+	m_boundVertexArray = 0;
+
+	Debug::Log("NullGfxDevice Destroy, Frames : {0}, Draw Calls : {1}, Bytes Uploaded : {2}",
+		m_frameCount, m_totalStats.m_drawCalls, m_totalStats.m_bytesUploaded);
+}
+
+void NullGfxDevice::SwapBuffer(void)
+{
+	m_totalStats.Add(m_frameStats);
+	m_lastFrameStats = m_frameStats;
+	m_frameStats.Reset();
+	++m_frameCount;
+
+	m_releasedMeshes.clear();
+}
+
+void NullGfxDevice::Clear()
+{
+	++m_frameStats.m_clears;
+}
+
+void NullGfxDevice::DrawMesh(const Mesh & mesh, const Material & material, int lod)
+{
+	const MeshBuffer& buffer = UploadMesh(mesh);
+
+	BindVertexArray(buffer.m_id);
+	UseProgram(GetProgram(material.GetShader()));
+
+	const unsigned int indexCount = mesh.GetLOD(lod).m_indexCount;
+	++m_frameStats.m_drawCalls;
+	m_frameStats.m_triangles += indexCount / 3;
+	m_frameStats.m_vertices += indexCount;
+}
+
+void NullGfxDevice::DrawMeshInstanced(const Mesh & mesh, const Material & material, const InstanceTransform * instances, int instanceCount, int lod)
+{
+	if (instanceCount <= 0)
+		return;
+
+	const MeshBuffer& buffer = UploadMesh(mesh);
+
+	const size_t size = instanceCount * sizeof(InstanceTransform);
+	m_instanceData.resize(size);
+	memcpy(m_instanceData.data(), instances, size);
+
+	BindVertexArray(buffer.m_id);
+	UseProgram(GetProgram(material.GetShader()));
+
+	const unsigned int indexCount = mesh.GetLOD(lod).m_indexCount;
+	++m_frameStats.m_drawCalls;
+	m_frameStats.m_instances += instanceCount;
+	m_frameStats.m_triangles += indexCount / 3 * instanceCount;
+	m_frameStats.m_vertices += indexCount * instanceCount;
+	m_frameStats.m_bytesUploaded += size;
+}
+
+void NullGfxDevice::DrawMeshIndexed(const Mesh & mesh, const Material & material, const unsigned int * indices, int indexCount)
+{
+	if (indexCount <= 0)
+		return;
+
+	const MeshBuffer& buffer = UploadMesh(mesh);
+
+	const size_t size = indexCount * GetIndexTypeSize(buffer.m_indexType);
+	m_dynamicIndexData.resize(size);
+	NarrowIndices(indices, indexCount, 0, buffer.m_indexType, m_dynamicIndexData.data());
+
+	BindVertexArray(buffer.m_id);
+	UseProgram(GetProgram(material.GetShader()));
+
+	++m_frameStats.m_drawCalls;
+	m_frameStats.m_triangles += indexCount / 3;
+	m_frameStats.m_vertices += indexCount;
+	m_frameStats.m_bytesUploaded += size;
+}
+
+unsigned int NullGfxDevice::GetProgram(const Shader & shader)
+{
+	const unsigned int* programRes = m_programTable.Get(shader.GetGfxHandle(), &shader);
+	if (programRes != nullptr)
+		return *programRes;
+
+	unsigned int programID = CreateShader(shader);
+	shader.SetGfxHandle(m_programTable.Add(&shader, programID));
+	return programID;
+}
+
+void NullGfxDevice::ReleaseMesh(const Mesh * mesh, GfxHandle handle)
+{
+	MeshBuffer buffer;
+	if (m_meshTable.Remove(handle, mesh, buffer))
+		m_releasedMeshes.push_back(buffer);
+}
+
+void NullGfxDevice::ReleaseShader(const Shader * shader, GfxHandle handle)
+{
+	unsigned int programID;
+	m_programTable.Remove(handle, shader, programID);
+}
+
+const NullGfxDevice::MeshBuffer& NullGfxDevice::UploadMesh(const Mesh & mesh)
+{
+	const MeshBuffer* res = m_meshTable.Get(mesh.GetGfxHandle(), &mesh);
+	if (res != nullptr)
+		return *res;
+
+	//same packing as ESDevice
+	const VertexLayoutDesc& layout = mesh.GetVertexLayout();
+	const int stride = layout.m_stride;
+
+	GfxHandle handle = m_meshTable.Add(&mesh, MeshBuffer());
+	mesh.SetGfxHandle(handle);
+	MeshBuffer& buffer = *m_meshTable.Get(handle, &mesh);
+	buffer.m_id = m_nextID++;
+	buffer.m_stride = stride;
+	buffer.m_vertexData.resize(stride * mesh.GetVertexCount());
+
+	layout.m_pack(mesh.GetVertex().data(), mesh.GetVertexCount(), buffer.m_vertexData.data());
+
+	//glBufferData copies, so does the null device, narrowed like ESDevice, the LODs follow LOD 0
+	const std::vector<unsigned int>& lodIndices = mesh.GetLODIndex();
+	const uint32_t indexCount = mesh.GetIndexCount();
+	const uint32_t maxIndex = std::max(FindMaxIndex(mesh.GetIndex().data(), indexCount), FindMaxIndex(lodIndices.data(), lodIndices.size()));
+	buffer.m_indexType = maxIndex <= 0xFFFF ? IndexType::UInt16 : IndexType::UInt32;
+	const int indexSize = GetIndexTypeSize(buffer.m_indexType);
+	buffer.m_indexData.resize((indexCount + lodIndices.size()) * indexSize);
+	NarrowIndices(mesh.GetIndex().data(), indexCount, 0, buffer.m_indexType, buffer.m_indexData.data());
+	NarrowIndices(lodIndices.data(), lodIndices.size(), 0, buffer.m_indexType, buffer.m_indexData.data() + indexCount * indexSize);
+
+	++m_frameStats.m_meshUploads;
+	m_frameStats.m_bytesUploaded += buffer.m_vertexData.size() + buffer.m_indexData.size();
+
+	return buffer;
+}
+
+unsigned int NullGfxDevice::CreateShader(const Shader & shader)
+{
+	++m_frameStats.m_programCreates;
+	return m_nextID++;
+}
+
+void NullGfxDevice::BindVertexArray(unsigned int id)
+{
+	if (m_boundVertexArray == id)
+	{
+		++m_frameStats.m_redundantBinds;
+		return;
+	}
+	m_boundVertexArray = id;
+	++m_frameStats.m_vertexArrayChanges;
+}
+
+void NullGfxDevice::UseProgram(unsigned int id)
+{
+	if (m_boundProgram == id)
+	{
+		++m_frameStats.m_redundantBinds;
+		return;
+	}
+	m_boundProgram = id;
+	++m_frameStats.m_programChanges;
+}
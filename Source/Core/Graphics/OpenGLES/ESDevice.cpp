@@ -1,7 +1,11 @@
+#include <algorithm>
+
 #include "Core\Graphics\Mesh\Mesh.h"
-#include "Core\Graphics\Mesh\VertexAttribGenerator.h"
+#include "Core\Graphics\Mesh\VertexLayout.h"
 #include "Core\Graphics\Material.h"
 #include "Core\Graphics\Shader.h"
+#include "Core\Graphics\RenderQueue.h"
+#include "Core\Graphics\InstanceTransform.h"
 #include "Core\Graphics\OpenGLES\ESDevice.h"
 #include "Core\Log\Debug.h"
 
@@ -23,7 +27,7 @@ void ESDevice::Init()
 		return;
 	}
 
-	Debug::Log(StringUtil::format("EGL Version: {}.{}", m_majorVersion, m_minorVersion));
+	Debug::Log("EGL Version: {}.{}", m_majorVersion, m_minorVersion);
 
 	EGLint maxConfig;
 	res = eglGetConfigs(m_eglDisplay, nullptr, 0, &maxConfig);
@@ -33,7 +37,7 @@ void ESDevice::Init()
 		return;
 	}
 
-	Debug::Log(StringUtil::format("EGL Config Count : {}", maxConfig));
+	Debug::Log("EGL Config Count : {}", maxConfig);
 
 #ifdef _LOG_ALL_EGLCONFIG
 	EGLConfig* eglConfigs = new EGLConfig[maxConfig]{};
@@ -48,36 +52,36 @@ void ESDevice::Init()
 	for (int i = 0; i < maxConfig; ++i)
 	{
 		EGLint attribValue = 0;
-		Debug::Log(StringUtil::format("EGLConfig : {}", i));
+		Debug::Log("EGLConfig : {}", i);
 
 		eglGetConfigAttrib(m_eglDisplay, eglConfigs[i], EGL_RED_SIZE, &attribValue);
-		Debug::Log(StringUtil::format("Red Size : {}", attribValue));
+		Debug::Log("Red Size : {}", attribValue);
 		eglGetConfigAttrib(m_eglDisplay, eglConfigs[i], EGL_GREEN_SIZE, &attribValue);
-		Debug::Log(StringUtil::format("Green Size : {}", attribValue));
+		Debug::Log("Green Size : {}", attribValue);
 		eglGetConfigAttrib(m_eglDisplay, eglConfigs[i], EGL_BLUE_SIZE, &attribValue);
-		Debug::Log(StringUtil::format("Blue Size : {}", attribValue));
+		Debug::Log("Blue Size : {}", attribValue);
 		eglGetConfigAttrib(m_eglDisplay, eglConfigs[i], EGL_ALPHA_SIZE, &attribValue);
-		Debug::Log(StringUtil::format("Alpha Size : {}", attribValue));
+		Debug::Log("Alpha Size : {}", attribValue);
 		eglGetConfigAttrib(m_eglDisplay, eglConfigs[i], EGL_BUFFER_SIZE, &attribValue);
-		Debug::Log(StringUtil::format("Bit Per Pixel Size : {}", attribValue));
+		Debug::Log("Bit Per Pixel Size : {}", attribValue);
 		eglGetConfigAttrib(m_eglDisplay, eglConfigs[i], EGL_STENCIL_SIZE, &attribValue);
-		Debug::Log(StringUtil::format("Stencil Size : {}", attribValue));
+		Debug::Log("Stencil Size : {}", attribValue);
 		eglGetConfigAttrib(m_eglDisplay, eglConfigs[i], EGL_DEPTH_SIZE, &attribValue);
-		Debug::Log(StringUtil::format("Depth Size : {}", attribValue));
+		Debug::Log("Depth Size : {}", attribValue);
 
 		eglGetConfigAttrib(m_eglDisplay, eglConfigs[i], EGL_RENDERABLE_TYPE, &attribValue);
-		Debug::Log(StringUtil::format("Support Renderable Type : ES1.x-{} ES2-{} ES3-{}", (attribValue & EGL_OPENGL_ES_BIT) != 0, (attribValue & EGL_OPENGL_ES2_BIT) != 0, (attribValue & EGL_OPENGL_ES3_BIT_KHR) != 0));
+		Debug::Log("Support Renderable Type : ES1.x-{} ES2-{} ES3-{}", (attribValue & EGL_OPENGL_ES_BIT) != 0, (attribValue & EGL_OPENGL_ES2_BIT) != 0, (attribValue & EGL_OPENGL_ES3_BIT_KHR) != 0);
 		eglGetConfigAttrib(m_eglDisplay, eglConfigs[i], EGL_SURFACE_TYPE, &attribValue);
-		Debug::Log(StringUtil::format("Support Widnow Surface : {}", attribValue & EGL_WINDOW_BIT));
+		Debug::Log("Support Widnow Surface : {}", attribValue & EGL_WINDOW_BIT);
 
 		eglGetConfigAttrib(m_eglDisplay, eglConfigs[i], EGL_CONFIG_CAVEAT, &attribValue);
-		Debug::Log(StringUtil::format("Slow Device :  {}, Compatible Device {}", (attribValue & EGL_SLOW_CONFIG) != 0, (attribValue & EGL_NON_CONFORMANT_CONFIG) != 0));
+		Debug::Log("Slow Device :  {}, Compatible Device {}", (attribValue & EGL_SLOW_CONFIG) != 0, (attribValue & EGL_NON_CONFORMANT_CONFIG) != 0);
 		
 		eglGetConfigAttrib(m_eglDisplay, eglConfigs[i], EGL_MIN_SWAP_INTERVAL, &attribValue);
-		Debug::Log(StringUtil::format("Min Swap Interval : {}", attribValue));
+		Debug::Log("Min Swap Interval : {}", attribValue);
 
 		eglGetConfigAttrib(m_eglDisplay, eglConfigs[i], EGL_MAX_SWAP_INTERVAL, &attribValue);
-		Debug::Log(StringUtil::format("Max Swap Interval : {}", attribValue));
+		Debug::Log("Max Swap Interval : {}", attribValue);
 	}
 	delete eglConfigs;
 #endif
@@ -130,15 +134,49 @@ void ESDevice::Init()
 		return;
 	}
 
+	m_stateCache.Reset();
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &m_uniformAlignment);
+	m_dynamicRing.Init(&m_stateCache, kDynamicFrameSize, std::max(m_uniformAlignment, static_cast<GLint>(sizeof(float) * 4)));
+	m_programCache.Init("ShaderCache");
+	m_shaderCompiler.Init(m_eglDisplay, m_eglConfig, m_eglContext);
+
 	Debug::Log("EGL Init Success");
 }
 
 void ESDevice::Destroy(void)
 {
+	//everything still alive goes with the context
+	m_programTable.ForEach([this](ProgramResource& resource)
+	{
+		if (resource.m_job.IsValid())
+			m_shaderCompiler.Cancel(resource.m_job);
+		else if (resource.m_program != 0)
+			m_deletePrograms.push_back(resource.m_program);
+	});
+	m_meshTable.Clear();
+	m_programTable.Clear();
+	ProcessDeletes();
+	m_shaderCompiler.Destroy();
+
+	for (size_t i = 0; i < m_arenas.size(); ++i)
+	{
+		glDeleteVertexArrays(1, &m_arenas[i].m_vao);
+		glDeleteBuffers(1, &m_arenas[i].m_vbo);
+		glDeleteBuffers(1, &m_arenas[i].m_ebo);
+		m_stateCache.OnDeleteVertexArray(m_arenas[i].m_vao);
+		m_stateCache.OnDeleteBuffer(m_arenas[i].m_vbo);
+		m_stateCache.OnDeleteBuffer(m_arenas[i].m_ebo);
+	}
+	m_arenas.clear();
+
+	m_dynamicRing.Destroy();
+
 	eglDestroyContext(m_eglDisplay, m_eglContext);
 	eglDestroySurface(m_eglDisplay, m_eglSurface);
 
-	Debug::Log("ESDevice Destroy");
+	Debug::Log("ESDevice Destroy, GL State Calls Issued : {0}, Filtered : {1}", m_stateCache.GetIssuedCount(), m_stateCache.GetFilteredCount());
+	Debug::Log("Program Binary Cache Hit : {0}, Miss : {1}, Rejected : {2}", m_programCache.GetHitCount(), m_programCache.GetMissCount(), m_programCache.GetRejectCount());
+	Debug::Log("Frame Allocator High Water : {0} Bytes, Overflows : {1}", m_frameAllocator.GetHighWater(), m_frameAllocator.GetOverflowCount());
 }
 
 void ESDevice::SwapBuffer(void)
@@ -146,226 +184,393 @@ void ESDevice::SwapBuffer(void)
 	/*TODO : Swap Interval ?*/
 	//eglSwapInterval(m_eglDisplay, 1);
 	eglSwapBuffers(m_eglDisplay, m_eglSurface);
+
+	m_dynamicRing.EndFrame();
+	ProcessDeletes();
+	m_frameAllocator.Reset();
 }
 
 void ESDevice::Clear()
 {
-	glClearColor(1, 0, 0, 1);
+	m_stateCache.SetClearColor(1, 0, 0, 1);
 	glClear(GL_COLOR_BUFFER_BIT);
 }
 
-void ESDevice::DrawMesh(const Mesh & mesh, const Material & material)
+void ESDevice::DrawMesh(const Mesh & mesh, const Material & material, int lod)
 {
-	GLuint resVBO = 0;
-	GLuint resVAO = 0;
-	GLuint resEBO = 0;
+	const MeshResource* meshRes = GetMeshResource(mesh);
+	GLuint shaderID = GetProgram(material.GetShader());
+	if (meshRes == nullptr || shaderID == -1)
+		return;
 
-	VBOMap::iterator vboRes = m_meshToVBO.find(&mesh);
-	if (vboRes == m_meshToVBO.end())
-	{
-		//create vertex attrib
-		std::vector<VertexAttribGenerator::VertexAttribution> vas;
-		VertexAttribGenerator::Generate(mesh, vas);
+	//left bound, the state cache skips the rebind of the next draw
+	m_stateCache.BindVertexArray(meshRes->m_vao);
+	m_stateCache.UseProgram(shaderID);
+	const void* indexOffset = nullptr;
+	const GLsizei indexCount = GetLODRange(*meshRes, mesh, lod, indexOffset);
+	glDrawElements(GL_TRIANGLES, indexCount, meshRes->m_indexType, indexOffset);
+	//glDrawArrays(GL_TRIANGLES, 0, mesh.GetVertexCount());
+}
+
+void ESDevice::DrawMeshInstanced(const Mesh & mesh, const Material & material, const InstanceTransform * instances, int instanceCount, int lod)
+{
+	const MeshResource* meshRes = GetMeshResource(mesh);
+	GLuint shaderID = GetProgram(material.GetShader());
+	if (meshRes == nullptr || shaderID == -1 || instanceCount <= 0)
+		return;
 
-		//vbo
-		GLuint vbo = 0;
-		glGenBuffers(1, &vbo);
-		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	if (!UploadInstances(instances, instanceCount))
+		return;
 
-		int stride = 0;
+	m_stateCache.BindVertexArray(meshRes->m_vao);
+	EnableInstanceAttribs(0);
 
-		for (int i = 0; i < vas.size(); ++i)
-			stride += vas[i].m_size;
+	m_stateCache.UseProgram(shaderID);
+	const void* indexOffset = nullptr;
+	const GLsizei indexCount = GetLODRange(*meshRes, mesh, lod, indexOffset);
+	glDrawElementsInstanced(GL_TRIANGLES, indexCount, meshRes->m_indexType, indexOffset, instanceCount);
 
-		char* buffer = new char[stride * mesh.GetVertexCount()];
-		char* bufferPointer = buffer;
+	DisableInstanceAttribs();
+}
 
-		const std::vector<Vertex>& meshVertexs = mesh.GetVertex();
+void ESDevice::DrawMeshIndexed(const Mesh & mesh, const Material & material, const unsigned int * indices, int indexCount)
+{
+	const MeshResource* meshRes = GetMeshResource(mesh);
+	GLuint shaderID = GetProgram(material.GetShader());
+	if (meshRes == nullptr || shaderID == -1 || indexCount <= 0)
+		return;
 
-		for (int i = 0; i < meshVertexs.size(); ++i)
-		{
-			memcpy(bufferPointer, &(meshVertexs[i].m_position), 3 * sizeof(float));
-			bufferPointer += 3 * sizeof(float);
-			memcpy(bufferPointer, &(meshVertexs[i].m_normal), 3 * sizeof(float));
-			bufferPointer += 3 * sizeof(float);
-			memcpy(bufferPointer, &(meshVertexs[i].m_texCoord), 2 * sizeof(float));
-			bufferPointer += 2 * sizeof(float);
-		}
+	m_stateCache.BindVertexArray(meshRes->m_vao);
+	m_stateCache.UseProgram(shaderID);
+	DrawDynamicIndices(*meshRes, indices, indexCount);
+}
 
-		/* TODO : start IO ??? */
-		glBufferData(GL_ARRAY_BUFFER, stride * mesh.GetVertexCount(), buffer, GL_STATIC_DRAW);
-		
-		
-		delete[] buffer;
-		bufferPointer = nullptr;
+void ESDevice::DrawRenderQueue(const RenderQueue & queue)
+{
+	const RenderPacket* packets = queue.GetPackets();
+
+	//every instance of the queue in one copy
+	bool hasInstances = false;
+	if (queue.GetInstanceCount() > 0)
+		hasInstances = UploadInstances(queue.GetInstances(), queue.GetInstanceCount());
 
-		//vao
-		GLuint vao = 0;
-		glGenVertexArrays(1, &vao);
-		glBindVertexArray(vao);
-		int offset = 0;
+	//packets are sorted by program then mesh, the state cache drops the repeated binds
+	for (size_t i = 0; i < queue.GetCount(); ++i)
+	{
+		const MeshResource* meshRes = GetMeshResource(*packets[i].m_mesh);
+		GLuint shaderID = GetProgram(packets[i].m_material->GetShader());
+		if (meshRes == nullptr || shaderID == -1)
+			continue;
 
-		//type transfer
-		GLenum typeTrans[]{ GL_UNSIGNED_BYTE, GL_BYTE, GL_HALF_FLOAT, GL_FLOAT };
+		m_stateCache.UseProgram(shaderID);
+		m_stateCache.BindVertexArray(meshRes->m_vao);
 
-		for (int i = 0; i < vas.size(); ++i)
+		if (packets[i].m_indexCount > 0)
 		{
-			glEnableVertexAttribArray(i);
-			glVertexAttribPointer(i, vas[i].m_componentSize, typeTrans[(int)vas[i].m_attribType], false, stride, (void*)offset);
-			offset += vas[i].m_size;
+			DrawDynamicIndices(*meshRes, queue.GetIndices() + packets[i].m_firstIndex, packets[i].m_indexCount);
+			continue;
 		}
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		
-		//ebo
-		GLuint ebo;
-		glGenBuffers(1, &ebo);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * mesh.GetIndexCount(), mesh.GetIndex().data(), GL_STATIC_DRAW);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-		glBindVertexArray(vao);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-		glBindVertexArray(0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-		//add
-		m_meshToVBO[&mesh] = vbo;
-		m_meshToVAO[&mesh] = vao;
-		m_meshToEBO[&mesh] = ebo;
-
-		resVBO = vbo;
-		resVAO = vao;
-		resEBO = ebo;
+
+		const void* indexOffset = nullptr;
+		const GLsizei indexCount = GetLODRange(*meshRes, *packets[i].m_mesh, packets[i].m_lod, indexOffset);
+
+		if (packets[i].m_instanceCount > 0)
+		{
+			//a DrawDynamicIndices may have grown the ring, the instances went with the old buffer
+			if (hasInstances && m_instanceGeneration != m_dynamicRing.GetGeneration())
+				hasInstances = UploadInstances(queue.GetInstances(), queue.GetInstanceCount());
+			if (!hasInstances)
+				continue;
+
+			EnableInstanceAttribs(packets[i].m_firstInstance);
+			glDrawElementsInstanced(GL_TRIANGLES, indexCount, meshRes->m_indexType, indexOffset, packets[i].m_instanceCount);
+			DisableInstanceAttribs();
+		}
+		else
+			glDrawElements(GL_TRIANGLES, indexCount, meshRes->m_indexType, indexOffset);
 	}
-	else
+}
+
+bool ESDevice::UploadInstances(const InstanceTransform * instances, size_t instanceCount)
+{
+	const size_t size = instanceCount * sizeof(InstanceTransform);
+	void* data = m_dynamicRing.Map(size, sizeof(float) * 4, m_instanceOffset);
+	if (data == nullptr)
+		return false;
+
+	m_instanceGeneration = m_dynamicRing.GetGeneration();
+	memcpy(data, instances, size);
+	m_dynamicRing.Unmap();
+	return true;
+}
+
+void ESDevice::DrawDynamicIndices(const MeshResource & meshRes, const unsigned int * indices, size_t indexCount)
+{
+	//the arena holds other meshes past this one
+	const uint32_t maxIndex = FindMaxIndex(indices, indexCount);
+	if (maxIndex >= meshRes.m_vertexCount)
 	{
-		resVBO = vboRes->second;
-		resVAO = m_meshToVAO.find(&mesh)->second;
-		resEBO = m_meshToEBO.find(&mesh)->second;
+		Debug::Error("Mesh index {0} is out of its {1} vertices", maxIndex, meshRes.m_vertexCount);
+		return;
 	}
 
-	//shader
-	ShaderMap::iterator shaderRes = m_shaderMap.find(&material.GetShader());
-	GLuint shaderID = -1;
-	if (shaderRes == m_shaderMap.end())
+	size_t offset = 0;
+	void* data = m_dynamicRing.Map(indexCount * meshRes.m_indexSize, meshRes.m_indexSize, offset);
+	if (data == nullptr)
+		return;
+
+	//rebased like the uploaded ones
+	NarrowIndices(indices, indexCount, meshRes.m_baseVertex, meshRes.m_indexSize == 2 ? IndexType::UInt16 : IndexType::UInt32, data);
+	m_dynamicRing.Unmap();
+
+	//the element binding is vao state, the arena's is put back for the next draws
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_dynamicRing.GetBuffer());
+	glDrawElements(GL_TRIANGLES, indexCount, meshRes.m_indexType, (void*)offset);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_arenas[meshRes.m_arena].m_ebo);
+}
+
+bool ESDevice::BindDynamicUniforms(GLuint bindingPoint, const void * data, size_t size)
+{
+	size_t offset = 0;
+	void* ringData = m_dynamicRing.Map(size, m_uniformAlignment, offset);
+	if (ringData == nullptr)
+		return false;
+
+	memcpy(ringData, data, size);
+	m_dynamicRing.Unmap();
+	m_stateCache.BindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, m_dynamicRing.GetBuffer(), offset, size);
+	return true;
+}
+
+void ESDevice::EnableInstanceAttribs(size_t firstInstance)
+{
+	m_stateCache.BindBuffer(GL_ARRAY_BUFFER, m_dynamicRing.GetBuffer());
+	for (GLuint row = 0; row < 3; ++row)
 	{
-		//create shader
-		const Shader& shader = material.GetShader();
+		const GLuint location = kInstanceAttribLocation + row;
+		glEnableVertexAttribArray(location);
+		glVertexAttribPointer(location, 4, GL_FLOAT, false, sizeof(InstanceTransform), (void*)(m_instanceOffset + firstInstance * sizeof(InstanceTransform) + row * 4 * sizeof(float)));
+		glVertexAttribDivisor(location, 1);
+	}
+}
 
-		GLuint programID = CreateShader(shader);
-		if (programID == -1)
-			return;
+void ESDevice::DisableInstanceAttribs(void)
+{
+	//the arena vao is shared with plain draws
+	for (GLuint row = 0; row < 3; ++row)
+		glDisableVertexAttribArray(kInstanceAttribLocation + row);
+}
 
-		//add shader
-		m_shaderMap[&shader] = programID;
-		shaderID = programID;
+const ESDevice::MeshResource* ESDevice::GetMeshResource(const Mesh & mesh)
+{
+	const MeshResource* meshRes = m_meshTable.Get(mesh.GetGfxHandle(), &mesh);
+	if (meshRes != nullptr)
+		return meshRes;
+
+	//the LODs follow LOD 0 in the same range
+	const std::vector<unsigned int>& lodIndices = mesh.GetLODIndex();
+	const uint32_t vertexCount = mesh.GetVertexCount();
+	const uint32_t lodIndexCount = mesh.GetIndexCount();
+	const uint32_t indexCount = lodIndexCount + lodIndices.size();
+	if (vertexCount == 0 || lodIndexCount == 0)
+		return nullptr;
+
+	const uint32_t maxIndex = std::max(FindMaxIndex(mesh.GetIndex().data(), lodIndexCount), FindMaxIndex(lodIndices.data(), lodIndices.size()));
+	if (maxIndex >= vertexCount)
+	{
+		Debug::Error("Mesh index {0} is out of its {1} vertices", maxIndex, vertexCount);
+		return nullptr;
 	}
-	else
-		shaderID = shaderRes->second;
 
-	glBindVertexArray(resVAO);
-	
-	glUseProgram(shaderID);
-	glDrawElements(GL_TRIANGLES, mesh.GetIndexCount(), GL_UNSIGNED_INT, 0);
-	//glDrawArrays(GL_TRIANGLES, 0, mesh.GetVertexCount());
+	//8 bit indices are slow on most GPUs, 16 bit is the narrowest used
+	const IndexType indexType = vertexCount <= kArena16VertexCount ? IndexType::UInt16 : IndexType::UInt32;
+	const int indexSize = GetIndexTypeSize(indexType);
+
+	//meshes share an arena when the layout key and the index type match
+	const VertexLayoutDesc& layout = mesh.GetVertexLayout();
+	const int stride = layout.m_stride;
+
+	MeshResource resource;
+	resource.m_arena = 0xFFFFFFFF;
+	resource.m_vertexCount = vertexCount;
+	resource.m_indexCount = indexCount;
+	for (uint32_t i = 0; i < m_arenas.size() && resource.m_arena == 0xFFFFFFFF; ++i)
+	{
+		MeshArena& arena = m_arenas[i];
+		if (arena.m_layout != layout.m_key || arena.m_indexType != indexType)
+			continue;
+
+		resource.m_baseVertex = arena.m_vertexAllocator.Allocate(vertexCount);
+		if (resource.m_baseVertex == GfxBufferAllocator::kInvalidOffset)
+			continue;
+		resource.m_firstIndex = arena.m_indexAllocator.Allocate(indexCount);
+		if (resource.m_firstIndex == GfxBufferAllocator::kInvalidOffset)
+		{
+			arena.m_vertexAllocator.Free(resource.m_baseVertex, vertexCount);
+			continue;
+		}
+		resource.m_arena = i;
+	}
+
+	if (resource.m_arena == 0xFFFFFFFF)
+	{
+		const uint32_t arenaVertexCount = indexType == IndexType::UInt16 ? kArena16VertexCount : std::max(vertexCount, kArenaVertexCount);
+		resource.m_arena = CreateArena(layout, indexType, arenaVertexCount, std::max(indexCount, kArenaIndexCount));
+		resource.m_baseVertex = m_arenas[resource.m_arena].m_vertexAllocator.Allocate(vertexCount);
+		resource.m_firstIndex = m_arenas[resource.m_arena].m_indexAllocator.Allocate(indexCount);
+	}
 
-	glBindVertexArray(0);
-	glUseProgram(0);
+	const MeshArena& arena = m_arenas[resource.m_arena];
+	resource.m_vao = arena.m_vao;
+	resource.m_indexType = indexType == IndexType::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	resource.m_indexSize = indexSize;
+	resource.m_indexOffset = resource.m_firstIndex * indexSize;
+
+	const size_t bufferSize = stride * vertexCount;
+	char* buffer = m_frameAllocator.Allocate<char>(bufferSize);
+	layout.m_pack(mesh.GetVertex().data(), vertexCount, buffer);
+
+	//ES 3.0 has no base vertex draw, the indices point at the arena range instead
+	const size_t indicesSize = indexCount * indexSize;
+	char* indices = m_frameAllocator.Allocate<char>(indicesSize);
+	if (!NarrowIndices(mesh.GetIndex().data(), lodIndexCount, resource.m_baseVertex, indexType, indices) ||
+		!NarrowIndices(lodIndices.data(), lodIndices.size(), resource.m_baseVertex, indexType, indices + lodIndexCount * indexSize))
+		Debug::Error("Mesh indices do not fit arena {0}", resource.m_arena);
+
+	//copy target, so no vao element binding is touched
+	m_stateCache.BindBuffer(GL_COPY_WRITE_BUFFER, arena.m_vbo);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, resource.m_baseVertex * stride, bufferSize, buffer);
+	m_stateCache.BindBuffer(GL_COPY_WRITE_BUFFER, arena.m_ebo);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, resource.m_indexOffset, indicesSize, indices);
+
+	//add
+	GfxHandle handle = m_meshTable.Add(&mesh, resource);
+	mesh.SetGfxHandle(handle);
+	return m_meshTable.Get(handle, &mesh);
 }
 
-GLuint ESDevice::CreateShader(const Shader & shader)
+GLsizei ESDevice::GetLODRange(const MeshResource & meshRes, const Mesh & mesh, int lod, const void *& indexOffset)
 {
-	GLuint shaderID = -1;
-	
-	GLuint vsID = glCreateShader(GL_VERTEX_SHADER);
+	const MeshLOD range = mesh.GetLOD(lod);
+	indexOffset = (const void*)(meshRes.m_indexOffset + range.m_firstIndex * meshRes.m_indexSize);
+	return range.m_indexCount;
+}
 
-	const String& vsSource = shader.GetVertexShaderSource();
-	const char *source = vsSource.data();
-	GLint len = vsSource.size();
-	glShaderSource(vsID, 1, &source, &len);
-	glCompileShader(vsID);
-	
-	GLint isSuccess = 0;
-	glGetShaderiv(vsID, GL_COMPILE_STATUS, &isSuccess);
-	if (!isSuccess)
+uint32_t ESDevice::CreateArena(const VertexLayoutDesc& layout, IndexType indexType, uint32_t vertexCount, uint32_t indexCount)
+{
+	const int stride = layout.m_stride;
+	MeshArena arena(vertexCount, indexCount);
+	arena.m_layout = layout.m_key;
+	arena.m_indexType = indexType;
+	arena.m_stride = stride;
+
+	//vbo
+	glGenBuffers(1, &arena.m_vbo);
+	m_stateCache.BindBuffer(GL_ARRAY_BUFFER, arena.m_vbo);
+	glBufferData(GL_ARRAY_BUFFER, stride * vertexCount, nullptr, GL_STATIC_DRAW);
+
+	//vao
+	glGenVertexArrays(1, &arena.m_vao);
+	m_stateCache.BindVertexArray(arena.m_vao);
+
+	//type transfer
+	GLenum typeTrans[]{ GL_UNSIGNED_BYTE, GL_BYTE, GL_HALF_FLOAT, GL_FLOAT, GL_SHORT, GL_UNSIGNED_SHORT };
+
+	for (int i = 0; i < layout.m_attribCount; ++i)
 	{
-		GLint infoLogLen = 0;
-		glGetShaderiv(vsID, GL_INFO_LOG_LENGTH, &infoLogLen);
-		/* TODO : Cache buffer */
-		GLchar *infoBuffer = new GLchar[infoLogLen]();
-		glGetShaderInfoLog(vsID, infoLogLen, &infoLogLen, infoBuffer);
-		Debug::Error(StringUtil::format("[{0}] vertex shader compile error : {1}", shader.GetShaderPath(), infoBuffer));
-		
-		delete[] infoBuffer;
-		glDeleteShader(vsID);
-		return -1;
+		const VertexAttribDesc& attrib = layout.m_attribs[i];
+		glEnableVertexAttribArray(attrib.m_location);
+		glVertexAttribPointer(attrib.m_location, attrib.m_componentCount, typeTrans[(int)attrib.m_attribType], attrib.m_normalized, stride, (void*)(size_t)attrib.m_offset);
 	}
-	
-	GLuint fsID = glCreateShader(GL_FRAGMENT_SHADER);
-	const String& fsSource = shader.GetFragmentShaderSource();
-	source = fsSource.data();
-	len = fsSource.size();
-	glShaderSource(fsID, 1, &source, &len);
-	glCompileShader(fsID);
-
-	glGetShaderiv(fsID, GL_COMPILE_STATUS, &isSuccess);
-	if (!isSuccess)
+
+	//ebo, recorded in the vao, the arena vao stays bound
+	glGenBuffers(1, &arena.m_ebo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, arena.m_ebo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, GetIndexTypeSize(indexType) * indexCount, nullptr, GL_STATIC_DRAW);
+
+	Debug::Log("Mesh Arena {0} : {1} Vertices, {2} Indices of {3} Bytes, Stride {4}", m_arenas.size(), vertexCount, indexCount, GetIndexTypeSize(indexType), stride);
+
+	m_arenas.push_back(arena);
+	return static_cast<uint32_t>(m_arenas.size() - 1);
+}
+
+GLuint ESDevice::GetProgram(const Shader & shader, bool wait)
+{
+	ProgramResource* programRes = m_programTable.Get(shader.GetGfxHandle(), &shader);
+	if (programRes == nullptr)
 	{
-		GLint infoLogLen = 0;
-		glGetShaderiv(fsID, GL_INFO_LOG_LENGTH, &infoLogLen);
-		GLchar *infoBuffer = new GLchar[infoLogLen]();
-		glGetShaderInfoLog(fsID, infoLogLen, nullptr, infoBuffer);
-		Debug::Error(StringUtil::format("[{0}] fragment shader compile error : {1}", shader.GetShaderPath(), infoBuffer));
-
-		delete[] infoBuffer;
-		glDeleteShader(fsID);
-		return -1;
+		PrepareShader(shader);
+		programRes = m_programTable.Get(shader.GetGfxHandle(), &shader);
 	}
 
-	//vs and fs is ok
-	GLuint program = glCreateProgram();
-	glAttachShader(program, vsID);
-	glAttachShader(program, fsID);
-
-	glLinkProgram(program);
-	glGetProgramiv(program, GL_LINK_STATUS, &isSuccess);
-	if (!isSuccess)
+	if (programRes->m_job.IsValid())
 	{
-		GLint infoLogLen = 0;
-		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLen);
-		GLchar *infoBuffer = new GLchar[infoLogLen]();
-		glGetProgramInfoLog(program, infoLogLen, nullptr, infoBuffer);
-		Debug::Error(StringUtil::format("{0} shader program compile error : {1}", shader.GetShaderPath(), infoBuffer));
-
-		delete[] infoBuffer;
-		glDeleteProgram(program);
-		return -1;
+		GLuint program = 0;
+		ESShaderCompiler::Status status = wait ? m_shaderCompiler.Wait(programRes->m_job, program) : m_shaderCompiler.Poll(programRes->m_job, program);
+		if (status == ESShaderCompiler::kPending)
+		{
+			if (m_fallbackShader == nullptr || m_fallbackShader == &shader)
+				return -1;
+			return GetProgram(*m_fallbackShader, true);
+		}
+
+		programRes->m_job = GfxHandle();
+		if (status == ESShaderCompiler::kReady)
+		{
+			programRes->m_program = program;
+			m_programCache.Store(shader, program);
+		}
 	}
 
-	//link success
-	//print shader info
-	Debug::Log(StringUtil::format("Shader : {0}, Information :", shader.GetShaderPath()));
-	Debug::Log("-------------------------------");
-	
-	GLint programArg = 0;
-	glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &programArg);
-	Debug::Log(StringUtil::format("Active Attributes Count : {0}", programArg));
-	glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &programArg);
-	Debug::Log(StringUtil::format("Active Attributes Max Length : {0}", programArg));
+	return programRes->m_program != 0 ? programRes->m_program : -1;
+}
 
-	glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &programArg);
-	Debug::Log(StringUtil::format("Active Uniforms Count : {0}", program));
-	glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &programArg);
-	Debug::Log(StringUtil::format("Active Uniforms Max Length : {0}", programArg));
+void ESDevice::PrepareShader(const Shader & shader)
+{
+	if (m_programTable.Get(shader.GetGfxHandle(), &shader) != nullptr)
+		return;
 
-	glGetProgramiv(program, GL_ATTACHED_SHADERS, &programArg);
-	Debug::Log(StringUtil::format("Attach Shaders Count : {0}", programArg));
+	//cached binary first, compile on a miss
+	ProgramResource resource;
+	resource.m_program = m_programCache.Load(shader);
+	if (resource.m_program == 0)
+		resource.m_job = m_shaderCompiler.Submit(shader, m_programCache.IsEnabled());
 
-	//glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &programArg);
-	//Debug::Log(StringUtil::format("Program Binary Length : {0}", programArg));
+	shader.SetGfxHandle(m_programTable.Add(&shader, resource));
+}
+
+void ESDevice::ReleaseMesh(const Mesh * mesh, GfxHandle handle)
+{
+	MeshResource resource;
+	if (m_meshTable.Remove(handle, mesh, resource))
+		m_releasedMeshes.push_back(resource);
+}
+
+void ESDevice::ReleaseShader(const Shader * shader, GfxHandle handle)
+{
+	ProgramResource resource;
+	if (!m_programTable.Remove(handle, shader, resource))
+		return;
+
+	if (resource.m_job.IsValid())
+		m_shaderCompiler.Cancel(resource.m_job);
+	else if (resource.m_program != 0)
+		m_deletePrograms.push_back(resource.m_program);
+}
 
-	Debug::Log("-------------------------------");
+void ESDevice::ProcessDeletes(void)
+{
+	//the swapped frame no longer reads these ranges
+	for (size_t i = 0; i < m_releasedMeshes.size(); ++i)
+	{
+		const MeshResource& resource = m_releasedMeshes[i];
+		MeshArena& arena = m_arenas[resource.m_arena];
+		arena.m_vertexAllocator.Free(resource.m_baseVertex, resource.m_vertexCount);
+		arena.m_indexAllocator.Free(resource.m_firstIndex, resource.m_indexCount);
+	}
+	for (size_t i = 0; i < m_deletePrograms.size(); ++i)
+		glDeleteProgram(m_deletePrograms[i]);
 
-	return program;
+	m_releasedMeshes.clear();
+	m_deletePrograms.clear();
 }
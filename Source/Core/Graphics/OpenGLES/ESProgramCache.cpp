@@ -0,0 +1,130 @@
+#include <vector>
+#include <cstring>
+
+#include "Core\Graphics\OpenGLES\ESProgramCache.h"
+#include "Core\Graphics\Shader.h"
+#include "Core\Resource\File.h"
+#include "Core\Misc\Utility.h"
+#include "Core\Log\Debug.h"
+
+namespace
+{
+	uint64_t HashGLString(GLenum name, uint64_t seed)
+	{
+		const char* value = reinterpret_cast<const char*>(glGetString(name));
+		if (value == nullptr)
+			return seed;
+		return HashFNV1a64(value, strlen(value), seed);
+	}
+}
+
+void ESProgramCache::Init(const String & directory)
+{
+	GLint formatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+	if (formatCount <= 0)
+	{
+		Debug::Log("Program Binary Cache disabled, no binary format");
+		return;
+	}
+
+	if (!Resource::MakeDirectory(directory))
+	{
+		Debug::Error("Program Binary Cache can not create {0}", directory);
+		return;
+	}
+
+	std::vector<GLint> formats(formatCount);
+	glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+
+	m_driverHash = HashFNV1a64(formats.data(), formats.size() * sizeof(GLint));
+	m_driverHash = HashGLString(GL_VENDOR, m_driverHash);
+	m_driverHash = HashGLString(GL_RENDERER, m_driverHash);
+	m_driverHash = HashGLString(GL_VERSION, m_driverHash);
+
+	m_directory = directory;
+	m_enabled = true;
+	Debug::Log("Program Binary Cache : {0}, Formats : {1}", m_directory, formatCount);
+}
+
+GLuint ESProgramCache::Load(const Shader & shader)
+{
+	if (!m_enabled)
+		return 0;
+
+	const uint64_t key = GetKey(shader);
+	std::vector<char> file;
+	int len = Resource::ReadBinaryFile(GetFileName(key), file);
+	if (len < static_cast<int>(sizeof(Header)))
+	{
+		++m_missCount;
+		return 0;
+	}
+
+	Header header;
+	memcpy(&header, file.data(), sizeof(Header));
+	//a hash collision or a truncated write
+	if (header.m_magic != kMagic || header.m_version != kVersion || header.m_key != key || header.m_length != len - sizeof(Header))
+	{
+		++m_missCount;
+		return 0;
+	}
+
+	GLuint program = glCreateProgram();
+	glProgramBinary(program, header.m_format, file.data() + sizeof(Header), header.m_length);
+
+	GLint isSuccess = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &isSuccess);
+	if (!isSuccess)
+	{
+		glDeleteProgram(program);
+		++m_rejectCount;
+		Debug::Warning("[{0}] cached program binary rejected, recompiling", shader.GetShaderPath());
+		return 0;
+	}
+
+	++m_hitCount;
+	return program;
+}
+
+void ESProgramCache::Store(const Shader & shader, GLuint program)
+{
+	if (!m_enabled)
+		return;
+
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return;
+
+	std::vector<char> file(sizeof(Header) + length);
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &length, &format, file.data() + sizeof(Header));
+
+	Header header;
+	header.m_magic = kMagic;
+	header.m_version = kVersion;
+	header.m_key = GetKey(shader);
+	header.m_format = format;
+	header.m_length = length;
+	memcpy(file.data(), &header, sizeof(Header));
+
+	Resource::WriteBinaryFile(GetFileName(header.m_key), file.data(), sizeof(Header) + length);
+}
+
+uint64_t ESProgramCache::GetKey(const Shader & shader) const
+{
+	const String& vsSource = shader.GetVertexShaderSource();
+	const String& fsSource = shader.GetFragmentShaderSource();
+	//the length keeps "ab" + "c" apart from "a" + "bc"
+	const uint64_t vsLength = vsSource.size();
+
+	uint64_t key = HashFNV1a64(&vsLength, sizeof(vsLength), m_driverHash);
+	key = HashFNV1a64(vsSource.data(), vsSource.size(), key);
+	return HashFNV1a64(fsSource.data(), fsSource.size(), key);
+}
+
+String ESProgramCache::GetFileName(uint64_t key) const
+{
+	return StringUtil::format("{0}/{1:016x}.bin", m_directory, key);
+}
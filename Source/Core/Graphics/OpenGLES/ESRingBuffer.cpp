@@ -0,0 +1,133 @@
+#include <algorithm>
+
+#include "Core\Graphics\OpenGLES\ESRingBuffer.h"
+#include "Core\Graphics\OpenGLES\ESStateCache.h"
+#include "Core\Log\Debug.h"
+
+ESRingBuffer::ESRingBuffer(void) : m_stateCache(nullptr), m_buffer(0), m_frameSize(0), m_alignment(1), m_frame(0), m_head(0), m_mapped(false), m_waitCount(0), m_growCount(0), m_generation(0)
+{
+	for (int i = 0; i < kFrameCount; ++i)
+		m_fences[i] = 0;
+}
+
+void ESRingBuffer::Init(ESStateCache* stateCache, size_t frameSize, size_t alignment)
+{
+	m_stateCache = stateCache;
+	m_alignment = std::max(alignment, static_cast<size_t>(1));
+	CreateBuffer(frameSize);
+}
+
+void ESRingBuffer::Destroy(void)
+{
+	if (m_mapped)
+		Unmap();
+
+	for (int i = 0; i < kFrameCount; ++i)
+	{
+		if (m_fences[i] != 0)
+			glDeleteSync(m_fences[i]);
+		m_fences[i] = 0;
+	}
+
+	if (m_buffer != 0)
+	{
+		glDeleteBuffers(1, &m_buffer);
+		m_stateCache->OnDeleteBuffer(m_buffer);
+	}
+	m_buffer = 0;
+	m_frameSize = 0;
+}
+
+void* ESRingBuffer::Map(size_t size, size_t alignment, size_t & offset)
+{
+	/* Assert(!m_mapped && m_alignment % alignment == 0) */
+	size_t head = (m_head + alignment - 1) / alignment * alignment;
+	if (head + size > m_frameSize)
+	{
+		//a new buffer object, the driver keeps the old one alive for draws in flight
+		CreateBuffer(std::max(m_frameSize * 2, size + alignment));
+		++m_growCount;
+		Debug::Warning("ESRingBuffer grows to {0} bytes a frame", m_frameSize);
+		head = 0;
+	}
+
+	offset = m_frame * m_frameSize + head;
+	m_head = head + size;
+
+	m_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+	void* data = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+	m_mapped = data != nullptr;
+	if (!m_mapped)
+		Debug::Error("ESRingBuffer map failed");
+	return data;
+}
+
+void ESRingBuffer::Unmap(void)
+{
+	if (!m_mapped)
+		return;
+
+	m_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+	glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+	m_mapped = false;
+}
+
+void ESRingBuffer::EndFrame(void)
+{
+	if (m_buffer == 0)
+		return;
+
+	if (m_fences[m_frame] != 0)
+		glDeleteSync(m_fences[m_frame]);
+	m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	m_frame = (m_frame + 1) % kFrameCount;
+	m_head = 0;
+	WaitFence(m_frame);
+}
+
+void ESRingBuffer::CreateBuffer(size_t frameSize)
+{
+	if (m_buffer != 0)
+	{
+		glDeleteBuffers(1, &m_buffer);
+		m_stateCache->OnDeleteBuffer(m_buffer);
+	}
+
+	//fences of the old buffer mean nothing for the new one
+	for (int i = 0; i < kFrameCount; ++i)
+	{
+		if (m_fences[i] != 0)
+			glDeleteSync(m_fences[i]);
+		m_fences[i] = 0;
+	}
+
+	//the offset of a segment has to meet every alignment too
+	m_frameSize = (frameSize + m_alignment - 1) / m_alignment * m_alignment;
+	m_head = 0;
+	++m_generation;
+	glGenBuffers(1, &m_buffer);
+	m_stateCache->BindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, m_frameSize * kFrameCount, nullptr, GL_DYNAMIC_DRAW);
+}
+
+void ESRingBuffer::WaitFence(int frame)
+{
+	GLsync fence = m_fences[frame];
+	if (fence == 0)
+		return;
+
+	//usually signaled long ago, only a GPU kFrameCount frames behind waits
+	GLenum res = glClientWaitSync(fence, 0, 0);
+	if (res == GL_TIMEOUT_EXPIRED)
+	{
+		++m_waitCount;
+		do
+		{
+			res = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		} while (res == GL_TIMEOUT_EXPIRED);
+	}
+
+	glDeleteSync(fence);
+	m_fences[frame] = 0;
+}
@@ -0,0 +1,451 @@
+#include <cstring>
+
+#include "Core\Graphics\OpenGLES\ESShaderCompiler.h"
+#include "Core\Graphics\Shader.h"
+#include "Core\Log\Debug.h"
+#include "Core\Misc\LinearAllocator.h"
+
+//GL_KHR_parallel_shader_compile, not in every gl2ext.h
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+typedef void (GL_APIENTRYP PFNMAXSHADERCOMPILERTHREADSKHR)(GLuint count);
+
+namespace
+{
+	bool HasExtension(const char* name)
+	{
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (GLint i = 0; i < count; ++i)
+		{
+			const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+			if (extension != nullptr && strcmp(extension, name) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	//read into scratch memory, only the error string is allocated
+	void AppendInfoLog(GLuint object, bool isProgram, String& out)
+	{
+		GLint infoLogLen = 0;
+		if (isProgram)
+			glGetProgramiv(object, GL_INFO_LOG_LENGTH, &infoLogLen);
+		else
+			glGetShaderiv(object, GL_INFO_LOG_LENGTH, &infoLogLen);
+		if (infoLogLen <= 0)
+			return;
+
+		ScratchScope scratch;
+		char* infoLog = scratch.Allocate<char>(infoLogLen);
+		GLsizei length = 0;
+		if (isProgram)
+			glGetProgramInfoLog(object, infoLogLen, &length, infoLog);
+		else
+			glGetShaderInfoLog(object, infoLogLen, &length, infoLog);
+		out.append(infoLog, length);
+	}
+}
+
+ESShaderCompiler::ESShaderCompiler(void)
+	: m_mode(kSerial), m_eglDisplay(EGL_NO_DISPLAY), m_workerContext(EGL_NO_CONTEXT), m_workerSurface(EGL_NO_SURFACE),
+	m_workerStarted(false), m_workerFailed(false), m_quit(false), m_submitCount(0), m_waitCount(0)
+{
+}
+
+void ESShaderCompiler::Init(EGLDisplay display, EGLConfig config, EGLContext shareContext)
+{
+	m_eglDisplay = display;
+
+	if (HasExtension("GL_KHR_parallel_shader_compile"))
+	{
+		//as many driver threads as it likes
+		PFNMAXSHADERCOMPILERTHREADSKHR maxShaderCompilerThreads = reinterpret_cast<PFNMAXSHADERCOMPILERTHREADSKHR>(eglGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+		if (maxShaderCompilerThreads != nullptr)
+			maxShaderCompilerThreads(0xFFFFFFFF);
+		m_mode = kParallel;
+	}
+	else if (StartWorker(config, shareContext))
+		m_mode = kWorker;
+	else
+		m_mode = kSerial;
+
+	const char* modeNames[] = { "Serial", "Parallel", "Worker" };
+	Debug::Log("Shader Compiler : {0}", modeNames[m_mode]);
+}
+
+void ESShaderCompiler::Destroy(void)
+{
+	if (m_mode == kWorker)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+			m_queue.clear();
+		}
+		m_wakeCondition.notify_all();
+		m_worker.join();
+
+		CollectResults();
+		if (m_workerSurface != EGL_NO_SURFACE)
+			eglDestroySurface(m_eglDisplay, m_workerSurface);
+		eglDestroyContext(m_eglDisplay, m_workerContext);
+		m_workerSurface = EGL_NO_SURFACE;
+		m_workerContext = EGL_NO_CONTEXT;
+	}
+
+	m_jobs.ForEach([](Job& record)
+	{
+		if (record.m_vs != 0)
+			glDeleteShader(record.m_vs);
+		if (record.m_fs != 0)
+			glDeleteShader(record.m_fs);
+		if (record.m_program != 0)
+			glDeleteProgram(record.m_program);
+	});
+	m_jobs.Clear();
+
+	Debug::Log("Shader Compiler Destroy, Submitted : {0}, Waited : {1}", m_submitCount, m_waitCount);
+}
+
+GfxHandle ESShaderCompiler::Submit(const Shader & shader, bool retrievable)
+{
+	Job record;
+	record.m_path = shader.GetShaderPath();
+	record.m_program = 0;
+	record.m_vs = 0;
+	record.m_fs = 0;
+	record.m_status = kPending;
+	++m_submitCount;
+
+	if (m_mode == kParallel)
+	{
+		//no status query here, that would wait for the driver
+		record.m_vs = CreateStage(GL_VERTEX_SHADER, shader.GetVertexShaderSource());
+		record.m_fs = CreateStage(GL_FRAGMENT_SHADER, shader.GetFragmentShaderSource());
+		record.m_program = glCreateProgram();
+		glAttachShader(record.m_program, record.m_vs);
+		glAttachShader(record.m_program, record.m_fs);
+		if (retrievable)
+			glProgramParameteri(record.m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(record.m_program);
+		return m_jobs.Add(this, record);
+	}
+
+	if (m_mode == kWorker)
+	{
+		const GfxHandle job = m_jobs.Add(this, record);
+		WorkItem item;
+		item.m_job = job;
+		item.m_vsSource = shader.GetVertexShaderSource();
+		item.m_fsSource = shader.GetFragmentShaderSource();
+		item.m_retrievable = retrievable;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_queue.push_back(std::move(item));
+		}
+		m_wakeCondition.notify_one();
+		return job;
+	}
+
+	record.m_program = Compile(shader.GetVertexShaderSource(), shader.GetFragmentShaderSource(), retrievable, record.m_error);
+	record.m_status = record.m_program != 0 ? kReady : kFailed;
+	return m_jobs.Add(this, record);
+}
+
+ESShaderCompiler::Status ESShaderCompiler::Poll(GfxHandle job, GLuint & program)
+{
+	if (m_mode == kWorker)
+		CollectResults();
+
+	Job* record = m_jobs.Get(job, this);
+	if (record == nullptr)
+		return kFailed;
+
+	if (record->m_status == kPending)
+	{
+		if (m_mode != kParallel)
+			return kPending;
+
+		GLint isDone = GL_FALSE;
+		glGetProgramiv(record->m_program, GL_COMPLETION_STATUS_KHR, &isDone);
+		if (!isDone)
+			return kPending;
+	}
+	return Finish(job, *record, program);
+}
+
+ESShaderCompiler::Status ESShaderCompiler::Wait(GfxHandle job, GLuint & program)
+{
+	if (m_mode == kWorker)
+		CollectResults();
+
+	Job* record = m_jobs.Get(job, this);
+	if (record == nullptr)
+		return kFailed;
+
+	if (record->m_status == kPending)
+		++m_waitCount;
+
+	//kParallel blocks in the link status query of Finish
+	while (m_mode == kWorker && record->m_status == kPending)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_doneCondition.wait(lock, [this] { return !m_results.empty(); });
+		}
+		CollectResults();
+		record = m_jobs.Get(job, this);
+	}
+	return Finish(job, *record, program);
+}
+
+void ESShaderCompiler::Cancel(GfxHandle job)
+{
+	Job record;
+	if (!m_jobs.Remove(job, this, record))
+		return;
+
+	if (m_mode == kWorker && record.m_status == kPending)
+	{
+		//not started yet, or CollectResults deletes the program of the unknown job
+		std::lock_guard<std::mutex> lock(m_mutex);
+		for (size_t i = 0; i < m_queue.size(); ++i)
+		{
+			if (m_queue[i].m_job == job)
+			{
+				m_queue.erase(m_queue.begin() + i);
+				break;
+			}
+		}
+		return;
+	}
+
+	if (record.m_vs != 0)
+		glDeleteShader(record.m_vs);
+	if (record.m_fs != 0)
+		glDeleteShader(record.m_fs);
+	if (record.m_program != 0)
+		glDeleteProgram(record.m_program);
+}
+
+bool ESShaderCompiler::StartWorker(EGLConfig config, EGLContext shareContext)
+{
+	EGLint contextAttribList[] = { EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE };
+	m_workerContext = eglCreateContext(m_eglDisplay, config, shareContext, contextAttribList);
+	if (m_workerContext == EGL_NO_CONTEXT)
+	{
+		Debug::Warning("Shader Compiler : Create Shared Context Failed");
+		return false;
+	}
+
+	//stays EGL_NO_SURFACE when the config has no pbuffer, that needs EGL_KHR_surfaceless_context
+	EGLint surfaceAttribList[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+	m_workerSurface = eglCreatePbufferSurface(m_eglDisplay, config, surfaceAttribList);
+
+	m_worker = std::thread(&ESShaderCompiler::WorkerLoop, this);
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_doneCondition.wait(lock, [this] { return m_workerStarted; });
+	}
+
+	if (m_workerFailed)
+	{
+		Debug::Warning("Shader Compiler : Bind Shared Context Failed");
+		m_worker.join();
+		if (m_workerSurface != EGL_NO_SURFACE)
+			eglDestroySurface(m_eglDisplay, m_workerSurface);
+		eglDestroyContext(m_eglDisplay, m_workerContext);
+		m_workerSurface = EGL_NO_SURFACE;
+		m_workerContext = EGL_NO_CONTEXT;
+		return false;
+	}
+	return true;
+}
+
+void ESShaderCompiler::WorkerLoop(void)
+{
+	const EGLBoolean res = eglMakeCurrent(m_eglDisplay, m_workerSurface, m_workerSurface, m_workerContext);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_workerStarted = true;
+		m_workerFailed = res == EGL_FALSE;
+	}
+	m_doneCondition.notify_all();
+	if (res == EGL_FALSE)
+		return;
+
+	for (;;)
+	{
+		WorkItem item;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wakeCondition.wait(lock, [this] { return m_quit || !m_queue.empty(); });
+			if (m_quit)
+				break;
+			item = std::move(m_queue.front());
+			m_queue.erase(m_queue.begin());
+		}
+
+		WorkResult result;
+		result.m_job = item.m_job;
+		result.m_program = Compile(item.m_vsSource, item.m_fsSource, item.m_retrievable, result.m_error);
+		result.m_fence = nullptr;
+		if (result.m_program != 0)
+		{
+			//the device context waits on it before the first use
+			result.m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			glFlush();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_results.push_back(std::move(result));
+		}
+		m_doneCondition.notify_all();
+	}
+
+	eglMakeCurrent(m_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	eglReleaseThread();
+}
+
+void ESShaderCompiler::CollectResults(void)
+{
+	std::vector<WorkResult> results;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_results.empty())
+			return;
+		results.swap(m_results);
+	}
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		WorkResult& result = results[i];
+		if (result.m_fence != nullptr)
+		{
+			glWaitSync(result.m_fence, 0, GL_TIMEOUT_IGNORED);
+			glDeleteSync(result.m_fence);
+		}
+
+		Job* record = m_jobs.Get(result.m_job, this);
+		if (record == nullptr)
+		{
+			//cancelled while compiling
+			if (result.m_program != 0)
+				glDeleteProgram(result.m_program);
+			continue;
+		}
+
+		record->m_program = result.m_program;
+		record->m_error = std::move(result.m_error);
+		record->m_status = result.m_program != 0 ? kReady : kFailed;
+	}
+}
+
+ESShaderCompiler::Status ESShaderCompiler::Finish(GfxHandle job, Job & record, GLuint & program)
+{
+	if (record.m_status == kPending)
+	{
+		record.m_program = CheckProgram(record.m_program, record.m_vs, record.m_fs, record.m_error);
+		record.m_vs = 0;
+		record.m_fs = 0;
+		record.m_status = record.m_program != 0 ? kReady : kFailed;
+	}
+
+	const Status status = record.m_status;
+	if (status == kReady)
+	{
+		program = record.m_program;
+		LogProgram(record.m_path, program);
+	}
+	else
+		Debug::Error("[{0}] {1}", record.m_path, record.m_error);
+
+	Job removed;
+	m_jobs.Remove(job, this, removed);
+	return status;
+}
+
+GLuint ESShaderCompiler::Compile(const String & vsSource, const String & fsSource, bool retrievable, String & error)
+{
+	GLuint vs = CreateStage(GL_VERTEX_SHADER, vsSource);
+	GLuint fs = CreateStage(GL_FRAGMENT_SHADER, fsSource);
+
+	GLuint program = glCreateProgram();
+	glAttachShader(program, vs);
+	glAttachShader(program, fs);
+	if (retrievable)
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glLinkProgram(program);
+
+	return CheckProgram(program, vs, fs, error);
+}
+
+GLuint ESShaderCompiler::CreateStage(GLenum type, const String & source)
+{
+	GLuint stage = glCreateShader(type);
+	const char* data = source.data();
+	GLint len = static_cast<GLint>(source.size());
+	glShaderSource(stage, 1, &data, &len);
+	glCompileShader(stage);
+	return stage;
+}
+
+GLuint ESShaderCompiler::CheckProgram(GLuint program, GLuint vs, GLuint fs, String & error)
+{
+	GLint isSuccess = 0;
+	glGetShaderiv(vs, GL_COMPILE_STATUS, &isSuccess);
+	if (!isSuccess)
+		AppendInfoLog(vs, false, error.assign("vertex shader compile error : "));
+	else
+	{
+		glGetShaderiv(fs, GL_COMPILE_STATUS, &isSuccess);
+		if (!isSuccess)
+			AppendInfoLog(fs, false, error.assign("fragment shader compile error : "));
+		else
+		{
+			glGetProgramiv(program, GL_LINK_STATUS, &isSuccess);
+			if (!isSuccess)
+				AppendInfoLog(program, true, error.assign("shader program link error : "));
+		}
+	}
+
+	//the program keeps what it needs
+	glDetachShader(program, vs);
+	glDetachShader(program, fs);
+	glDeleteShader(vs);
+	glDeleteShader(fs);
+
+	if (!isSuccess)
+	{
+		glDeleteProgram(program);
+		return 0;
+	}
+	return program;
+}
+
+void ESShaderCompiler::LogProgram(const String & path, GLuint program)
+{
+	//print shader info
+	Debug::Log("Shader : {0}, Information :", path);
+	Debug::Log("-------------------------------");
+
+	GLint programArg = 0;
+	glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &programArg);
+	Debug::Log("Active Attributes Count : {0}", programArg);
+	glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &programArg);
+	Debug::Log("Active Attributes Max Length : {0}", programArg);
+
+	glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &programArg);
+	Debug::Log("Active Uniforms Count : {0}", programArg);
+	glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &programArg);
+	Debug::Log("Active Uniforms Max Length : {0}", programArg);
+
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &programArg);
+	Debug::Log("Program Binary Length : {0}", programArg);
+
+	Debug::Log("-------------------------------");
+}
@@ -0,0 +1,278 @@
+#include "Core\Graphics\OpenGLES\ESStateCache.h"
+
+namespace
+{
+	const GLuint kUnknownName = 0xFFFFFFFF;
+}
+
+void ESStateCache::Reset(void)
+{
+	m_program = 0;
+	m_vertexArray = 0;
+	for (int i = 0; i < kBufferSlotCount; ++i)
+		m_buffers[i] = 0;
+	for (int unit = 0; unit < kTextureUnitCount; ++unit)
+	{
+		for (int i = 0; i < kTextureSlotCount; ++i)
+			m_textures[unit][i] = 0;
+	}
+	m_activeTexture = GL_TEXTURE0;
+
+	m_blend = 0;
+	m_blendSrc = GL_ONE;
+	m_blendDst = GL_ZERO;
+	m_depthTest = 0;
+	m_depthFunc = GL_LESS;
+	m_depthMask = 1;
+	m_cullFace = 0;
+	m_cullMode = GL_BACK;
+	for (int i = 0; i < 4; ++i)
+		m_clearColor[i] = 0.0F;
+	m_clearColorValid = true;
+
+	ResetCounters();
+}
+
+void ESStateCache::Invalidate(void)
+{
+	m_program = kUnknownName;
+	m_vertexArray = kUnknownName;
+	for (int i = 0; i < kBufferSlotCount; ++i)
+		m_buffers[i] = kUnknownName;
+	for (int unit = 0; unit < kTextureUnitCount; ++unit)
+	{
+		for (int i = 0; i < kTextureSlotCount; ++i)
+			m_textures[unit][i] = kUnknownName;
+	}
+	m_activeTexture = 0;
+
+	m_blend = -1;
+	m_blendSrc = 0;
+	m_blendDst = 0;
+	m_depthTest = -1;
+	m_depthFunc = 0;
+	m_depthMask = -1;
+	m_cullFace = -1;
+	m_cullMode = 0;
+	m_clearColorValid = false;
+
+	ResetCounters();
+}
+
+void ESStateCache::UseProgram(GLuint program)
+{
+	if (m_program == program)
+	{
+		++m_filteredCount;
+		return;
+	}
+	glUseProgram(program);
+	m_program = program;
+	++m_issuedCount;
+}
+
+void ESStateCache::BindVertexArray(GLuint vertexArray)
+{
+	if (m_vertexArray == vertexArray)
+	{
+		++m_filteredCount;
+		return;
+	}
+	glBindVertexArray(vertexArray);
+	m_vertexArray = vertexArray;
+	++m_issuedCount;
+}
+
+void ESStateCache::BindBuffer(GLenum target, GLuint buffer)
+{
+	const int slot = GetBufferSlot(target);
+	if (slot >= 0 && m_buffers[slot] == buffer)
+	{
+		++m_filteredCount;
+		return;
+	}
+	glBindBuffer(target, buffer);
+	if (slot >= 0)
+		m_buffers[slot] = buffer;
+	++m_issuedCount;
+}
+
+void ESStateCache::BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	//ranges move every draw, only the generic binding is worth tracking
+	glBindBufferRange(target, index, buffer, offset, size);
+	const int slot = GetBufferSlot(target);
+	if (slot >= 0)
+		m_buffers[slot] = buffer;
+	++m_issuedCount;
+}
+
+void ESStateCache::BindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+	const int slot = GetTextureSlot(target);
+	if (slot >= 0 && unit < kTextureUnitCount && m_textures[unit][slot] == texture)
+	{
+		++m_filteredCount;
+		return;
+	}
+
+	const GLenum activeTexture = GL_TEXTURE0 + unit;
+	if (m_activeTexture != activeTexture)
+	{
+		glActiveTexture(activeTexture);
+		m_activeTexture = activeTexture;
+		++m_issuedCount;
+	}
+	glBindTexture(target, texture);
+	if (slot >= 0 && unit < kTextureUnitCount)
+		m_textures[unit][slot] = texture;
+	++m_issuedCount;
+}
+
+void ESStateCache::SetBlend(bool enable)
+{
+	SetCapability(GL_BLEND, m_blend, enable);
+}
+
+void ESStateCache::SetBlendFunc(GLenum src, GLenum dst)
+{
+	if (m_blendSrc == src && m_blendDst == dst)
+	{
+		++m_filteredCount;
+		return;
+	}
+	glBlendFunc(src, dst);
+	m_blendSrc = src;
+	m_blendDst = dst;
+	++m_issuedCount;
+}
+
+void ESStateCache::SetDepthTest(bool enable)
+{
+	SetCapability(GL_DEPTH_TEST, m_depthTest, enable);
+}
+
+void ESStateCache::SetDepthFunc(GLenum func)
+{
+	if (m_depthFunc == func)
+	{
+		++m_filteredCount;
+		return;
+	}
+	glDepthFunc(func);
+	m_depthFunc = func;
+	++m_issuedCount;
+}
+
+void ESStateCache::SetDepthMask(bool write)
+{
+	if (m_depthMask == static_cast<int>(write))
+	{
+		++m_filteredCount;
+		return;
+	}
+	glDepthMask(write ? GL_TRUE : GL_FALSE);
+	m_depthMask = write;
+	++m_issuedCount;
+}
+
+void ESStateCache::SetCullFace(bool enable)
+{
+	SetCapability(GL_CULL_FACE, m_cullFace, enable);
+}
+
+void ESStateCache::SetCullMode(GLenum mode)
+{
+	if (m_cullMode == mode)
+	{
+		++m_filteredCount;
+		return;
+	}
+	glCullFace(mode);
+	m_cullMode = mode;
+	++m_issuedCount;
+}
+
+void ESStateCache::SetClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+{
+	if (m_clearColorValid && m_clearColor[0] == r && m_clearColor[1] == g && m_clearColor[2] == b && m_clearColor[3] == a)
+	{
+		++m_filteredCount;
+		return;
+	}
+	glClearColor(r, g, b, a);
+	m_clearColor[0] = r;
+	m_clearColor[1] = g;
+	m_clearColor[2] = b;
+	m_clearColor[3] = a;
+	m_clearColorValid = true;
+	++m_issuedCount;
+}
+
+void ESStateCache::OnDeleteVertexArray(GLuint vertexArray)
+{
+	if (m_vertexArray == vertexArray)
+		m_vertexArray = 0;
+}
+
+void ESStateCache::OnDeleteBuffer(GLuint buffer)
+{
+	for (int i = 0; i < kBufferSlotCount; ++i)
+	{
+		if (m_buffers[i] == buffer)
+			m_buffers[i] = 0;
+	}
+}
+
+void ESStateCache::OnDeleteTexture(GLuint texture)
+{
+	for (int unit = 0; unit < kTextureUnitCount; ++unit)
+	{
+		for (int i = 0; i < kTextureSlotCount; ++i)
+		{
+			if (m_textures[unit][i] == texture)
+				m_textures[unit][i] = 0;
+		}
+	}
+}
+
+int ESStateCache::GetBufferSlot(GLenum target)
+{
+	switch (target)
+	{
+	case GL_ARRAY_BUFFER: return kArrayBuffer;
+	case GL_COPY_READ_BUFFER: return kCopyReadBuffer;
+	case GL_COPY_WRITE_BUFFER: return kCopyWriteBuffer;
+	case GL_UNIFORM_BUFFER: return kUniformBuffer;
+	case GL_PIXEL_PACK_BUFFER: return kPixelPackBuffer;
+	case GL_PIXEL_UNPACK_BUFFER: return kPixelUnpackBuffer;
+	default: return -1;
+	}
+}
+
+int ESStateCache::GetTextureSlot(GLenum target)
+{
+	switch (target)
+	{
+	case GL_TEXTURE_2D: return kTexture2D;
+	case GL_TEXTURE_CUBE_MAP: return kTextureCube;
+	case GL_TEXTURE_3D: return kTexture3D;
+	case GL_TEXTURE_2D_ARRAY: return kTexture2DArray;
+	default: return -1;
+	}
+}
+
+void ESStateCache::SetCapability(GLenum capability, int & current, bool enable)
+{
+	if (current == static_cast<int>(enable))
+	{
+		++m_filteredCount;
+		return;
+	}
+	if (enable)
+		glEnable(capability);
+	else
+		glDisable(capability);
+	current = enable;
+	++m_issuedCount;
+}
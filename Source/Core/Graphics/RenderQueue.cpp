@@ -0,0 +1,163 @@
+#include <cstring>
+#include <algorithm>
+
+#include "Core\Graphics\RenderQueue.h"
+#include "Core\Graphics\Material.h"
+
+void RenderQueue::Add(const Mesh & mesh, const Material & material, float depth, unsigned int pass, int lod)
+{
+	AddPacket(mesh, material, depth, pass, lod);
+}
+
+void RenderQueue::AddInstanced(const Mesh & mesh, const Material & material, const Matrix4x4 * transforms, int instanceCount, float depth, unsigned int pass, int lod)
+{
+	if (instanceCount <= 0)
+		return;
+
+	RenderPacket& packet = AddPacket(mesh, material, depth, pass, lod);
+	packet.m_firstInstance = static_cast<uint32_t>(m_instances.size());
+	packet.m_instanceCount = instanceCount;
+	m_instances.resize(m_instances.size() + instanceCount);
+	PackInstanceTransforms(transforms, instanceCount, &m_instances[packet.m_firstInstance]);
+}
+
+void RenderQueue::AddInstanced(const Mesh & mesh, const Material & material, const InstanceTransform * instances, int instanceCount, float depth, unsigned int pass, int lod)
+{
+	if (instanceCount <= 0)
+		return;
+
+	RenderPacket& packet = AddPacket(mesh, material, depth, pass, lod);
+	packet.m_firstInstance = static_cast<uint32_t>(m_instances.size());
+	packet.m_instanceCount = instanceCount;
+	m_instances.insert(m_instances.end(), instances, instances + instanceCount);
+}
+
+void RenderQueue::AddIndexed(const Mesh & mesh, const Material & material, const unsigned int * indices, size_t indexCount, float depth, unsigned int pass)
+{
+	if (indexCount == 0)
+		return;
+
+	RenderPacket& packet = AddPacket(mesh, material, depth, pass, 0);
+	packet.m_firstIndex = static_cast<uint32_t>(m_indices.size());
+	packet.m_indexCount = static_cast<uint32_t>(indexCount);
+	m_indices.insert(m_indices.end(), indices, indices + indexCount);
+}
+
+RenderPacket & RenderQueue::AddPacket(const Mesh & mesh, const Material & material, float depth, unsigned int pass, int lod)
+{
+	RenderPacket packet;
+	packet.m_key = MakeKey(pass,
+		GetSortID(m_shaderIDs, &material.GetShader(), kShaderBits),
+		GetSortID(m_materialIDs, &material, kMaterialBits),
+		GetSortID(m_meshIDs, &mesh, kMeshBits),
+		depth);
+	packet.m_mesh = &mesh;
+	packet.m_material = &material;
+	packet.m_firstInstance = 0;
+	packet.m_instanceCount = 0;
+	packet.m_lod = lod;
+	packet.m_firstIndex = 0;
+	packet.m_indexCount = 0;
+	//the material may change or be read on another thread by the time the queue plays
+	packet.m_color = material.GetPackedBaseColor();
+	m_packets.push_back(packet);
+	return m_packets.back();
+}
+
+void RenderQueue::Clear(void)
+{
+	m_packets.clear();
+	m_instances.clear();
+	m_indices.clear();
+	//keys are only compared inside one Sort
+	m_shaderIDs.clear();
+	m_materialIDs.clear();
+	m_meshIDs.clear();
+}
+
+void RenderQueue::Remove(const void * object)
+{
+	//their instances and indices stay until Clear, nothing points at them anymore
+	m_packets.erase(std::remove_if(m_packets.begin(), m_packets.end(), [object](const RenderPacket& packet)
+	{
+		return packet.m_mesh == object || packet.m_material == object || &packet.m_material->GetShader() == object;
+	}), m_packets.end());
+}
+
+void RenderQueue::Sort(void)
+{
+	const size_t count = m_packets.size();
+	if (count < 2)
+		return;
+
+	//LSD radix, 8 bits a pass, one histogram sweep for all passes
+	const int kPassCount = sizeof(uint64_t);
+	uint32_t histogram[kPassCount][256];
+	memset(histogram, 0, sizeof(histogram));
+	for (size_t i = 0; i < count; ++i)
+	{
+		const uint64_t key = m_packets[i].m_key;
+		for (int pass = 0; pass < kPassCount; ++pass)
+			++histogram[pass][(key >> (pass * 8)) & 0xFF];
+	}
+
+	m_sortBuffer.resize(count);
+	RenderPacket* source = m_packets.data();
+	RenderPacket* target = m_sortBuffer.data();
+	for (int pass = 0; pass < kPassCount; ++pass)
+	{
+		uint32_t* bucket = histogram[pass];
+		const int shift = pass * 8;
+
+		//every key has the same digit, nothing moves
+		if (bucket[(source[0].m_key >> shift) & 0xFF] == count)
+			continue;
+
+		uint32_t offset = 0;
+		for (int digit = 0; digit < 256; ++digit)
+		{
+			const uint32_t digitCount = bucket[digit];
+			bucket[digit] = offset;
+			offset += digitCount;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+			target[bucket[(source[i].m_key >> shift) & 0xFF]++] = source[i];
+
+		RenderPacket* swap = source;
+		source = target;
+		target = swap;
+	}
+
+	if (source != m_packets.data())
+		m_packets.swap(m_sortBuffer);
+}
+
+uint64_t RenderQueue::MakeKey(unsigned int pass, uint32_t shader, uint32_t material, uint32_t mesh, float depth)
+{
+	const uint32_t kDepthMax = (1u << kDepthBits) - 1;
+	uint32_t quantizedDepth = 0;
+	if (depth >= 1.0F)
+		quantizedDepth = kDepthMax;
+	else if (depth > 0.0F)
+		quantizedDepth = static_cast<uint32_t>(depth * kDepthMax);
+
+	return (static_cast<uint64_t>(pass & ((1u << kPassBits) - 1)) << kPassShift) |
+		(static_cast<uint64_t>(shader) << kShaderShift) |
+		(static_cast<uint64_t>(material) << kMaterialShift) |
+		(static_cast<uint64_t>(mesh) << kMeshShift) |
+		(static_cast<uint64_t>(quantizedDepth) << kDepthShift);
+}
+
+uint32_t RenderQueue::GetSortID(SortIDMap & ids, const void * object, int bits)
+{
+	SortIDMap::iterator res = ids.find(object);
+	if (res != ids.end())
+		return res->second;
+
+	//ids past the field share the last one, still correct, just sorts less well
+	const uint32_t maxID = (1u << bits) - 1;
+	const uint32_t id = std::min(static_cast<uint32_t>(ids.size()), maxID);
+	ids[object] = id;
+	return id;
+}
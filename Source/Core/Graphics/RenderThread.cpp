@@ -0,0 +1,223 @@
+#include <algorithm>
+
+#include "Core\Graphics\RenderThread.h"
+#include "Core\Graphics\GfxDevice.h"
+#include "Core\Graphics\Mesh\Mesh.h"
+#include "Core\Graphics\Shader.h"
+
+namespace
+{
+	typedef std::chrono::duration<float, std::milli> Milliseconds;
+}
+
+/* RenderCommandList */
+
+RenderQueue & RenderCommandList::CloseQueue(void)
+{
+	if (m_queues[m_queueCount].IsEmpty())
+		return m_queues[m_queueCount];
+
+	RenderCommand command = { RenderCommandType::DrawQueue, static_cast<uint32_t>(m_queueCount), nullptr, GfxHandle() };
+	m_commands.push_back(command);
+	if (++m_queueCount == m_queues.size())
+		m_queues.resize(m_queueCount + 1);
+	return m_queues[m_queueCount];
+}
+
+void RenderCommandList::Clear(void)
+{
+	AddCommand(RenderCommandType::Clear, nullptr, GfxHandle());
+}
+
+void RenderCommandList::PrepareShader(const Shader & shader)
+{
+	AddCommand(RenderCommandType::PrepareShader, &shader, GfxHandle());
+}
+
+void RenderCommandList::ReleaseMesh(const Mesh * mesh, GfxHandle handle)
+{
+	AddCommand(RenderCommandType::ReleaseMesh, mesh, handle);
+}
+
+void RenderCommandList::ReleaseShader(const Shader * shader, GfxHandle handle)
+{
+	AddCommand(RenderCommandType::ReleaseShader, shader, handle);
+}
+
+void RenderCommandList::RemoveShader(const Shader * shader)
+{
+	m_commands.erase(std::remove_if(m_commands.begin(), m_commands.end(), [shader](const RenderCommand& command)
+	{
+		return command.m_type == RenderCommandType::PrepareShader && command.m_object == shader;
+	}), m_commands.end());
+}
+
+void RenderCommandList::AddCommand(RenderCommandType type, const void * object, GfxHandle handle)
+{
+	RenderCommand command = { type, 0, object, handle };
+	m_commands.push_back(command);
+}
+
+void RenderCommandList::RemoveDraws(const void * object)
+{
+	//the open queue too
+	for (size_t i = 0; i <= m_queueCount; ++i)
+		m_queues[i].Remove(object);
+}
+
+void RenderCommandList::Reset(void)
+{
+	//the render thread cleared the queues it drew
+	m_commands.clear();
+	m_queues[m_queueCount].Clear();
+	m_queueCount = 0;
+	m_present = false;
+	m_last = false;
+}
+
+/* RenderThread */
+
+void RenderThread::Start(GfxDevice * gfxDevice)
+{
+	if (m_thread.joinable() || gfxDevice == nullptr)
+		return;
+
+	m_gfxDevice = gfxDevice;
+	m_thread = std::thread(&RenderThread::Run, this);
+}
+
+void RenderThread::Stop(void)
+{
+	if (!m_thread.joinable())
+		return;
+
+	//releases recorded since the last SwapBuffer
+	Publish(true);
+	m_thread.join();
+	m_gfxDevice = nullptr;
+}
+
+void RenderThread::Submit(void)
+{
+	Publish(false);
+
+	//the other list is free once the frame before this one is done
+	const Clock::time_point waitStart = Clock::now();
+	WaitFor(m_completedFrame, m_recordFrame - 1);
+	const float waitTime = Milliseconds(Clock::now() - waitStart).count();
+
+	RenderCommandList& list = GetCommandList();
+	if (list.m_present)
+		UpdateStats(list, waitTime);
+	list.Reset();
+}
+
+void RenderThread::WaitReleased(const GfxFrameStamp & frames)
+{
+	WaitFor(m_completedFrame, frames.GetFrameBefore(GetRecordFrame()));
+}
+
+void RenderThread::Publish(bool last)
+{
+	RenderCommandList& list = GetCommandList();
+	list.m_present = !last;
+	list.m_last = last;
+	list.m_submitTime = Clock::now();
+
+	Signal(m_submittedFrame, ++m_recordFrame);
+}
+
+void RenderThread::Run(void)
+{
+	m_gfxDevice->Init();
+
+	for (uint32_t frame = 1; ; ++frame)
+	{
+		WaitFor(m_submittedFrame, frame);
+
+		RenderCommandList& list = m_lists[frame & 1];
+		const bool last = list.m_last;
+		Execute(list);
+		Signal(m_completedFrame, frame);
+
+		if (last)
+			break;
+	}
+
+	m_gfxDevice->Destroy();
+}
+
+void RenderThread::Execute(RenderCommandList & list)
+{
+	list.m_startTime = Clock::now();
+
+	for (size_t i = 0; i < list.m_commands.size(); ++i)
+	{
+		const RenderCommand& command = list.m_commands[i];
+		switch (command.m_type)
+		{
+		case RenderCommandType::Clear:
+			m_gfxDevice->Clear();
+			break;
+		case RenderCommandType::DrawQueue:
+		{
+			RenderQueue& queue = list.m_queues[command.m_queue];
+			queue.Sort();
+			m_gfxDevice->DrawRenderQueue(queue);
+			queue.Clear();
+			break;
+		}
+		case RenderCommandType::ReleaseMesh:
+			m_gfxDevice->ReleaseMesh(static_cast<const Mesh*>(command.m_object), command.m_handle);
+			break;
+		case RenderCommandType::ReleaseShader:
+			m_gfxDevice->ReleaseShader(static_cast<const Shader*>(command.m_object), command.m_handle);
+			break;
+		case RenderCommandType::PrepareShader:
+			m_gfxDevice->PrepareShader(*static_cast<const Shader*>(command.m_object));
+			break;
+		}
+	}
+
+	if (list.m_present)
+		m_gfxDevice->SwapBuffer();
+	list.m_presentTime = Clock::now();
+}
+
+void RenderThread::WaitFor(const std::atomic<uint32_t>& counter, uint32_t frame)
+{
+	if (counter.load(std::memory_order_acquire) >= frame)
+		return;
+
+	//seq_cst against Signal, either it sees the sleeper or this sees the counter
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+	m_condition.wait(lock, [&counter, frame]() { return counter.load(std::memory_order_seq_cst) >= frame; });
+	m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void RenderThread::Signal(std::atomic<uint32_t>& counter, uint32_t frame)
+{
+	counter.store(frame, std::memory_order_seq_cst);
+	if (m_sleepers.load(std::memory_order_seq_cst) == 0)
+		return;
+
+	//a waiter between its check and its sleep holds the mutex, so the wake is not lost
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+	}
+	m_condition.notify_all();
+}
+
+void RenderThread::UpdateStats(const RenderCommandList & list, float waitTime)
+{
+	const float latency = Milliseconds(list.m_presentTime - list.m_submitTime).count();
+
+	++m_stats.m_frameCount;
+	m_stats.m_lastLatency = latency;
+	m_stats.m_averageLatency += (latency - m_stats.m_averageLatency) / m_stats.m_frameCount;
+	m_stats.m_maxLatency = std::max(m_stats.m_maxLatency, latency);
+	m_stats.m_lastRenderTime = Milliseconds(list.m_presentTime - list.m_startTime).count();
+	m_stats.m_lastWaitTime = waitTime;
+	m_stats.m_totalWaitTime += waitTime;
+}
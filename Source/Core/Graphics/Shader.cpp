@@ -1,5 +1,6 @@
 #include "Core\Graphics\Shader.h"
 #include "Core\Resource\File.h"
+#include "Core\Graphics\GraphicManager.h"
 
 Shader::Shader(String shaderPath) : m_shaderPath(shaderPath)
 {
@@ -22,4 +23,12 @@ Shader::Shader(String shaderPath) : m_shaderPath(shaderPath)
 		Debug::Error("Can not create fragment shader");
 		return;
 	}
+}
+
+Shader::~Shader(void)
+{
+	//without a handle too, a prepare may be waiting on the render thread
+	GraphicManager* graphicManager = GraphicManager::Instance();
+	if (graphicManager != nullptr)
+		graphicManager->ReleaseShader(*this);
 }
\ No newline at end of file
@@ -0,0 +1,552 @@
+#include <cmath>
+#include <algorithm>
+
+#include "Core\Graphics\Mesh\Mesh.h"
+#include "Core\Graphics\Material.h"
+#include "Core\Graphics\RenderQueue.h"
+#include "Core\Graphics\Software\SoftwareGfxDevice.h"
+#include "Core\Graphics\InstanceTransform.h"
+#include "Core\Math\Simd\SimdConfig.h"
+#include "Core\Misc\Memory.h"
+#include "Core\Log\Debug.h"
+
+#if SIMD_X86
+	#include <emmintrin.h>
+#elif SIMD_NEON
+	#include <arm_neon.h>
+#endif
+
+//fill_n takes it by reference
+const uint32_t SoftwareGfxDevice::kClearColor;
+
+namespace
+{
+	const int kSubPixelScale = 1 << SoftwareGfxDevice::kSubPixelBits;
+	const int kHalfPixel = kSubPixelScale / 2;
+
+	// top left fill rule, y points down and the inside of every edge is positive
+	inline bool IsTopLeft(int dx, int dy)
+	{
+		return dy < 0 || (dy == 0 && dx > 0);
+	}
+
+	// w at pixel (x, y) relative to the setup origin
+	inline int64_t EdgeAt(int32_t w, int32_t stepX, int32_t stepY, int x, int y)
+	{
+		return static_cast<int64_t>(w) + static_cast<int64_t>(stepX) * x + static_cast<int64_t>(stepY) * y;
+	}
+}
+
+SoftwareGfxDevice::SoftwareGfxDevice(int width, int height, int threadCount) :
+	m_width(std::min(std::max(width, 1), static_cast<int>(kMaxSize))), m_height(std::min(std::max(height, 1), static_cast<int>(kMaxSize))),
+	m_colorBuffer(nullptr), m_depthBuffer(nullptr), m_drawColor(0xFFFFFFFF), m_clearPending(false),
+	m_threadCount(threadCount), m_generation(0), m_busyWorkers(0), m_quit(false), m_nextTile(0)
+{
+	m_tileCountX = (m_width + kTileSize - 1) / kTileSize;
+	m_tileCountY = (m_height + kTileSize - 1) / kTileSize;
+	m_pitch = m_tileCountX * kTileSize;
+}
+
+void SoftwareGfxDevice::Init()
+{
+	//whole tiles, so a tile never needs a bounds check
+	const size_t pixelCount = static_cast<size_t>(m_pitch) * m_tileCountY * kTileSize;
+	m_colorBuffer = static_cast<uint32_t*>(AlignedMalloc(pixelCount * sizeof(uint32_t), 16));
+	m_depthBuffer = static_cast<float*>(AlignedMalloc(pixelCount * sizeof(float), 16));
+	m_bins.resize(m_tileCountX * m_tileCountY);
+
+	m_clearPending = true;
+	Flush();
+
+	if (m_threadCount <= 0)
+		m_threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	for (int i = 1; i < m_threadCount; ++i)
+		m_workers.push_back(std::thread(&SoftwareGfxDevice::WorkerLoop, this, m_generation));
+
+	Debug::Log("SoftwareGfxDevice Init Success, {0}x{1}, Threads : {2}", m_width, m_height, m_threadCount);
+}
+
+void SoftwareGfxDevice::Destroy(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_wakeCondition.notify_all();
+	for (size_t i = 0; i < m_workers.size(); ++i)
+		m_workers[i].join();
+	m_workers.clear();
+
+	AlignedFree(m_colorBuffer);
+	AlignedFree(m_depthBuffer);
+	m_colorBuffer = nullptr;
+	m_depthBuffer = nullptr;
+
+	Debug::Log("SoftwareGfxDevice Destroy");
+}
+
+void SoftwareGfxDevice::SwapBuffer(void)
+{
+	Flush();
+}
+
+void SoftwareGfxDevice::Clear()
+{
+	//draws before the clear still have to land
+	if (!m_triangles.empty())
+		Flush();
+	m_clearPending = true;
+}
+
+void SoftwareGfxDevice::DrawMesh(const Mesh & mesh, const Material & material, int lod)
+{
+	m_drawColor = material.GetPackedBaseColor();
+	DrawTransformed(mesh, mesh.GetLODIndexData(lod), mesh.GetLOD(lod).m_indexCount, nullptr);
+}
+
+void SoftwareGfxDevice::DrawMeshInstanced(const Mesh & mesh, const Material & material, const InstanceTransform * instances, int instanceCount, int lod)
+{
+	m_drawColor = material.GetPackedBaseColor();
+	for (int i = 0; i < instanceCount; ++i)
+		DrawTransformed(mesh, mesh.GetLODIndexData(lod), mesh.GetLOD(lod).m_indexCount, &instances[i]);
+}
+
+void SoftwareGfxDevice::DrawMeshIndexed(const Mesh & mesh, const Material & material, const unsigned int * indices, int indexCount)
+{
+	m_drawColor = material.GetPackedBaseColor();
+	DrawTransformed(mesh, indices, indexCount, nullptr);
+}
+
+void SoftwareGfxDevice::DrawRenderQueue(const RenderQueue & queue)
+{
+	//same as GfxDevice, with the color of the packet instead of the material's current one
+	const RenderPacket* packets = queue.GetPackets();
+	for (size_t i = 0; i < queue.GetCount(); ++i)
+	{
+		const RenderPacket& packet = packets[i];
+		const Mesh& mesh = *packet.m_mesh;
+		m_drawColor = packet.m_color;
+		if (packet.m_indexCount > 0)
+			DrawTransformed(mesh, queue.GetIndices() + packet.m_firstIndex, packet.m_indexCount, nullptr);
+		else
+		{
+			const unsigned int* indices = mesh.GetLODIndexData(packet.m_lod);
+			const unsigned int indexCount = mesh.GetLOD(packet.m_lod).m_indexCount;
+			if (packet.m_instanceCount > 0)
+			{
+				const InstanceTransform* instances = queue.GetInstances() + packet.m_firstInstance;
+				for (uint32_t j = 0; j < packet.m_instanceCount; ++j)
+					DrawTransformed(mesh, indices, indexCount, &instances[j]);
+			}
+			else
+				DrawTransformed(mesh, indices, indexCount, nullptr);
+		}
+	}
+}
+
+void SoftwareGfxDevice::DrawTransformed(const Mesh & mesh, const unsigned int * indices, unsigned int indexCount, const InstanceTransform * transform)
+{
+	//SimpleMesh vertex shader, position passes through as clip position
+	//SimpleMeshInstanced applies the instance rows first
+	const std::vector<Vertex>& meshVertexs = mesh.GetVertex();
+	m_vertices.resize(meshVertexs.size());
+	const float halfWidth = m_width * 0.5F;
+	const float halfHeight = m_height * 0.5F;
+	for (size_t i = 0; i < meshVertexs.size(); ++i)
+	{
+		const Vector3& position = meshVertexs[i].m_position;
+		float x = position.X;
+		float y = position.Y;
+		float z = position.Z;
+		if (transform != nullptr)
+		{
+			const float (*rows)[4] = transform->m_rows;
+			x = rows[0][0] * position.X + rows[0][1] * position.Y + rows[0][2] * position.Z + rows[0][3];
+			y = rows[1][0] * position.X + rows[1][1] * position.Y + rows[1][2] * position.Z + rows[1][3];
+			z = rows[2][0] * position.X + rows[2][1] * position.Y + rows[2][2] * position.Z + rows[2][3];
+		}
+		m_vertices[i].x = (x + 1.0F) * halfWidth;
+		m_vertices[i].y = (1.0F - y) * halfHeight;
+		m_vertices[i].z = z * 0.5F + 0.5F;
+	}
+
+	//LODs and culled meshlets share the vertices, only the triangles differ
+	for (unsigned int i = 0; i + 2 < indexCount; i += 3)
+		ClipAndSetup(m_vertices[indices[i]], m_vertices[indices[i + 1]], m_vertices[indices[i + 2]]);
+}
+
+void SoftwareGfxDevice::ClipAndSetup(const ScreenVertex & v0, const ScreenVertex & v1, const ScreenVertex & v2)
+{
+	const float width = static_cast<float>(m_width);
+	const float height = static_cast<float>(m_height);
+
+	//trivial reject, depth is clipped per pixel
+	if ((v0.x < 0.0F && v1.x < 0.0F && v2.x < 0.0F) || (v0.x > width && v1.x > width && v2.x > width) ||
+		(v0.y < 0.0F && v1.y < 0.0F && v2.y < 0.0F) || (v0.y > height && v1.y > height && v2.y > height) ||
+		(v0.z < 0.0F && v1.z < 0.0F && v2.z < 0.0F) || (v0.z > 1.0F && v1.z > 1.0F && v2.z > 1.0F))
+		return;
+
+	const float minX = std::min(v0.x, std::min(v1.x, v2.x));
+	const float maxX = std::max(v0.x, std::max(v1.x, v2.x));
+	const float minY = std::min(v0.y, std::min(v1.y, v2.y));
+	const float maxY = std::max(v0.y, std::max(v1.y, v2.y));
+	if (minX >= 0.0F && maxX <= width && minY >= 0.0F && maxY <= height)
+	{
+		SetupTriangle(v0, v1, v2);
+		return;
+	}
+
+	// Sutherland-Hodgman against the screen rectangle, keeps the fixed point setup in range
+	ScreenVertex polygon[2][8];
+	int count = 3;
+	polygon[0][0] = v0;
+	polygon[0][1] = v1;
+	polygon[0][2] = v2;
+
+	int current = 0;
+	for (int plane = 0; plane < 4 && count >= 3; ++plane)
+	{
+		const ScreenVertex* input = polygon[current];
+		ScreenVertex* output = polygon[current ^ 1];
+		int outputCount = 0;
+
+		for (int i = 0; i < count; ++i)
+		{
+			const ScreenVertex& a = input[i];
+			const ScreenVertex& b = input[(i + 1) % count];
+			//signed distance, inside is >= 0
+			const float da = plane == 0 ? a.x : plane == 1 ? width - a.x : plane == 2 ? a.y : height - a.y;
+			const float db = plane == 0 ? b.x : plane == 1 ? width - b.x : plane == 2 ? b.y : height - b.y;
+
+			if (da >= 0.0F)
+				output[outputCount++] = a;
+			if ((da >= 0.0F) != (db >= 0.0F))
+			{
+				const float t = da / (da - db);
+				ScreenVertex& v = output[outputCount++];
+				v.x = a.x + (b.x - a.x) * t;
+				v.y = a.y + (b.y - a.y) * t;
+				v.z = a.z + (b.z - a.z) * t;
+			}
+		}
+
+		count = outputCount;
+		current ^= 1;
+	}
+
+	for (int i = 1; i + 1 < count; ++i)
+		SetupTriangle(polygon[current][0], polygon[current][i], polygon[current][i + 1]);
+}
+
+void SoftwareGfxDevice::SetupTriangle(const ScreenVertex & v0, const ScreenVertex & v1, const ScreenVertex & v2)
+{
+	//snap to the sub pixel grid
+	int x[3] = { static_cast<int>(floorf(v0.x * kSubPixelScale + 0.5F)), static_cast<int>(floorf(v1.x * kSubPixelScale + 0.5F)), static_cast<int>(floorf(v2.x * kSubPixelScale + 0.5F)) };
+	int y[3] = { static_cast<int>(floorf(v0.y * kSubPixelScale + 0.5F)), static_cast<int>(floorf(v1.y * kSubPixelScale + 0.5F)), static_cast<int>(floorf(v2.y * kSubPixelScale + 0.5F)) };
+	float z[3] = { v0.z, v1.z, v2.z };
+
+	int64_t area = static_cast<int64_t>(x[1] - x[0]) * (y[2] - y[0]) - static_cast<int64_t>(y[1] - y[0]) * (x[2] - x[0]);
+	if (area == 0)
+		return;
+	if (area < 0)
+	{
+		std::swap(x[1], x[2]);
+		std::swap(y[1], y[2]);
+		std::swap(z[1], z[2]);
+		area = -area;
+	}
+
+	Triangle triangle;
+	const int minX = std::min(x[0], std::min(x[1], x[2]));
+	const int maxX = std::max(x[0], std::max(x[1], x[2]));
+	const int minY = std::min(y[0], std::min(y[1], y[2]));
+	const int maxY = std::max(y[0], std::max(y[1], y[2]));
+	//pixels whose center is inside the bounds
+	triangle.m_minX = std::max((minX - kHalfPixel + kSubPixelScale - 1) >> kSubPixelBits, 0);
+	triangle.m_minY = std::max((minY - kHalfPixel + kSubPixelScale - 1) >> kSubPixelBits, 0);
+	triangle.m_maxX = std::min((maxX - kHalfPixel) >> kSubPixelBits, m_width - 1);
+	triangle.m_maxY = std::min((maxY - kHalfPixel) >> kSubPixelBits, m_height - 1);
+	if (triangle.m_minX > triangle.m_maxX || triangle.m_minY > triangle.m_maxY)
+		return;
+
+	const int sampleX = (triangle.m_minX << kSubPixelBits) + kHalfPixel;
+	const int sampleY = (triangle.m_minY << kSubPixelBits) + kHalfPixel;
+	for (int i = 0; i < 3; ++i)
+	{
+		//edge opposite to vertex i
+		const int a = (i + 1) % 3;
+		const int b = (i + 2) % 3;
+		const int dx = x[b] - x[a];
+		const int dy = y[b] - y[a];
+		const int64_t w = static_cast<int64_t>(dx) * (sampleY - y[a]) - static_cast<int64_t>(dy) * (sampleX - x[a]);
+		triangle.m_w[i] = static_cast<int32_t>(w) - (IsTopLeft(dx, dy) ? 0 : 1);
+		triangle.m_stepX[i] = -dy * kSubPixelScale;
+		triangle.m_stepY[i] = dx * kSubPixelScale;
+	}
+
+	//depth plane, per sub pixel then scaled to per pixel
+	const float invArea = 1.0F / static_cast<float>(area);
+	const float dz1 = z[1] - z[0];
+	const float dz2 = z[2] - z[0];
+	const float zdx = (dz1 * (y[2] - y[0]) - dz2 * (y[1] - y[0])) * invArea;
+	const float zdy = (dz2 * (x[1] - x[0]) - dz1 * (x[2] - x[0])) * invArea;
+	triangle.m_z = z[0] + zdx * (sampleX - x[0]) + zdy * (sampleY - y[0]);
+	triangle.m_zStepX = zdx * kSubPixelScale;
+	triangle.m_zStepY = zdy * kSubPixelScale;
+	triangle.m_color = m_drawColor;
+
+	const uint32_t index = static_cast<uint32_t>(m_triangles.size());
+	m_triangles.push_back(triangle);
+	BinTriangle(triangle, index);
+}
+
+void SoftwareGfxDevice::BinTriangle(const Triangle & triangle, uint32_t index)
+{
+	const int tileMinX = triangle.m_minX / kTileSize;
+	const int tileMaxX = triangle.m_maxX / kTileSize;
+	const int tileMinY = triangle.m_minY / kTileSize;
+	const int tileMaxY = triangle.m_maxY / kTileSize;
+	const bool singleTile = tileMinX == tileMaxX && tileMinY == tileMaxY;
+
+	for (int ty = tileMinY; ty <= tileMaxY; ++ty)
+	{
+		for (int tx = tileMinX; tx <= tileMaxX; ++tx)
+		{
+			if (!singleTile)
+			{
+				//reject the tile if every corner is outside one edge, w is linear so corners are enough
+				const int x0 = std::max(tx * kTileSize, triangle.m_minX) - triangle.m_minX;
+				const int y0 = std::max(ty * kTileSize, triangle.m_minY) - triangle.m_minY;
+				const int x1 = std::min(tx * kTileSize + kTileSize - 1, triangle.m_maxX) - triangle.m_minX;
+				const int y1 = std::min(ty * kTileSize + kTileSize - 1, triangle.m_maxY) - triangle.m_minY;
+
+				bool outside = false;
+				for (int i = 0; i < 3 && !outside; ++i)
+				{
+					//corner that maximizes w
+					const int cx = triangle.m_stepX[i] >= 0 ? x1 : x0;
+					const int cy = triangle.m_stepY[i] >= 0 ? y1 : y0;
+					outside = EdgeAt(triangle.m_w[i], triangle.m_stepX[i], triangle.m_stepY[i], cx, cy) < 0;
+				}
+				if (outside)
+					continue;
+			}
+
+			m_bins[ty * m_tileCountX + tx].push_back(index);
+		}
+	}
+}
+
+void SoftwareGfxDevice::Flush(void)
+{
+	if (m_triangles.empty() && !m_clearPending)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_nextTile = 0;
+		m_busyWorkers = static_cast<int>(m_workers.size());
+		++m_generation;
+	}
+	m_wakeCondition.notify_all();
+
+	RasterTiles();
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_doneCondition.wait(lock, [this] { return m_busyWorkers == 0; });
+	}
+
+	for (size_t i = 0; i < m_bins.size(); ++i)
+		m_bins[i].clear();
+	m_triangles.clear();
+	m_clearPending = false;
+}
+
+void SoftwareGfxDevice::WorkerLoop(unsigned int generation)
+{
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wakeCondition.wait(lock, [this, generation] { return m_quit || m_generation != generation; });
+			if (m_quit)
+				return;
+			generation = m_generation;
+		}
+
+		RasterTiles();
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (--m_busyWorkers == 0)
+				m_doneCondition.notify_one();
+		}
+	}
+}
+
+void SoftwareGfxDevice::RasterTiles(void)
+{
+	const int tileCount = m_tileCountX * m_tileCountY;
+	for (int tile = m_nextTile++; tile < tileCount; tile = m_nextTile++)
+		RasterTile(tile);
+}
+
+void SoftwareGfxDevice::RasterTile(int tile)
+{
+	const int x0 = (tile % m_tileCountX) * kTileSize;
+	const int y0 = (tile / m_tileCountX) * kTileSize;
+
+	if (m_clearPending)
+	{
+		for (int y = y0; y < y0 + kTileSize; ++y)
+		{
+			std::fill_n(m_colorBuffer + y * m_pitch + x0, kTileSize, kClearColor);
+			std::fill_n(m_depthBuffer + y * m_pitch + x0, kTileSize, 1.0F);
+		}
+	}
+
+	const std::vector<uint32_t>& bin = m_bins[tile];
+	for (size_t i = 0; i < bin.size(); ++i)
+		RasterTriangle(m_triangles[bin[i]], x0, y0, x0 + kTileSize - 1, y0 + kTileSize - 1);
+}
+
+void SoftwareGfxDevice::RasterTriangle(const Triangle & triangle, int x0, int y0, int x1, int y1)
+{
+	//4 pixel groups, the tile is a multiple of 4 wide so groups never leave it
+	const int startX = std::max(triangle.m_minX, x0) & ~3;
+	const int endX = std::min(triangle.m_maxX, x1);
+	const int startY = std::max(triangle.m_minY, y0);
+	const int endY = std::min(triangle.m_maxY, y1);
+	if (startX > endX || startY > endY)
+		return;
+
+	const int offsetX = startX - triangle.m_minX;
+	const int offsetY = startY - triangle.m_minY;
+	int32_t w0 = triangle.m_w[0] + triangle.m_stepX[0] * offsetX + triangle.m_stepY[0] * offsetY;
+	int32_t w1 = triangle.m_w[1] + triangle.m_stepX[1] * offsetX + triangle.m_stepY[1] * offsetY;
+	int32_t w2 = triangle.m_w[2] + triangle.m_stepX[2] * offsetX + triangle.m_stepY[2] * offsetY;
+	float z = triangle.m_z + triangle.m_zStepX * offsetX + triangle.m_zStepY * offsetY;
+
+#if SIMD_X86
+	const __m128i laneOffset0 = _mm_setr_epi32(0, triangle.m_stepX[0], triangle.m_stepX[0] * 2, triangle.m_stepX[0] * 3);
+	const __m128i laneOffset1 = _mm_setr_epi32(0, triangle.m_stepX[1], triangle.m_stepX[1] * 2, triangle.m_stepX[1] * 3);
+	const __m128i laneOffset2 = _mm_setr_epi32(0, triangle.m_stepX[2], triangle.m_stepX[2] * 2, triangle.m_stepX[2] * 3);
+	const __m128i stepX0 = _mm_set1_epi32(triangle.m_stepX[0] * 4);
+	const __m128i stepX1 = _mm_set1_epi32(triangle.m_stepX[1] * 4);
+	const __m128i stepX2 = _mm_set1_epi32(triangle.m_stepX[2] * 4);
+	const __m128 zStepX = _mm_set1_ps(triangle.m_zStepX * 4.0F);
+	const __m128 zLaneOffset = _mm_mul_ps(_mm_setr_ps(0.0F, 1.0F, 2.0F, 3.0F), _mm_set1_ps(triangle.m_zStepX));
+	const __m128 zero = _mm_setzero_ps();
+	const __m128i color = _mm_set1_epi32(static_cast<int>(triangle.m_color));
+
+	for (int y = startY; y <= endY; ++y)
+	{
+		uint32_t* colorRow = m_colorBuffer + y * m_pitch;
+		float* depthRow = m_depthBuffer + y * m_pitch;
+		__m128i e0 = _mm_add_epi32(_mm_set1_epi32(w0), laneOffset0);
+		__m128i e1 = _mm_add_epi32(_mm_set1_epi32(w1), laneOffset1);
+		__m128i e2 = _mm_add_epi32(_mm_set1_epi32(w2), laneOffset2);
+		__m128 pz = _mm_add_ps(_mm_set1_ps(z), zLaneOffset);
+
+		for (int x = startX; x <= endX; x += 4)
+		{
+			//inside when no edge function has the sign bit set
+			const __m128i outside = _mm_srai_epi32(_mm_or_si128(_mm_or_si128(e0, e1), e2), 31);
+			const __m128 depth = _mm_load_ps(depthRow + x);
+			const __m128 pass = _mm_and_ps(_mm_cmplt_ps(pz, depth), _mm_cmpge_ps(pz, zero));
+			const __m128i write = _mm_andnot_si128(outside, _mm_castps_si128(pass));
+
+			if (_mm_movemask_epi8(write) != 0)
+			{
+				const __m128 writeMask = _mm_castsi128_ps(write);
+				_mm_store_ps(depthRow + x, _mm_or_ps(_mm_and_ps(writeMask, pz), _mm_andnot_ps(writeMask, depth)));
+				__m128i* colorPointer = reinterpret_cast<__m128i*>(colorRow + x);
+				_mm_store_si128(colorPointer, _mm_or_si128(_mm_and_si128(write, color), _mm_andnot_si128(write, _mm_load_si128(colorPointer))));
+			}
+
+			e0 = _mm_add_epi32(e0, stepX0);
+			e1 = _mm_add_epi32(e1, stepX1);
+			e2 = _mm_add_epi32(e2, stepX2);
+			pz = _mm_add_ps(pz, zStepX);
+		}
+
+		w0 += triangle.m_stepY[0];
+		w1 += triangle.m_stepY[1];
+		w2 += triangle.m_stepY[2];
+		z += triangle.m_zStepY;
+	}
+#elif SIMD_NEON
+	const int32x4_t lane = { 0, 1, 2, 3 };
+	const int32x4_t laneOffset0 = vmulq_n_s32(lane, triangle.m_stepX[0]);
+	const int32x4_t laneOffset1 = vmulq_n_s32(lane, triangle.m_stepX[1]);
+	const int32x4_t laneOffset2 = vmulq_n_s32(lane, triangle.m_stepX[2]);
+	const int32x4_t stepX0 = vdupq_n_s32(triangle.m_stepX[0] * 4);
+	const int32x4_t stepX1 = vdupq_n_s32(triangle.m_stepX[1] * 4);
+	const int32x4_t stepX2 = vdupq_n_s32(triangle.m_stepX[2] * 4);
+	const float32x4_t zLaneOffset = vmulq_n_f32(vcvtq_f32_s32(lane), triangle.m_zStepX);
+	const float32x4_t zStepX = vdupq_n_f32(triangle.m_zStepX * 4.0F);
+	const float32x4_t zero = vdupq_n_f32(0.0F);
+	const uint32x4_t color = vdupq_n_u32(triangle.m_color);
+
+	for (int y = startY; y <= endY; ++y)
+	{
+		uint32_t* colorRow = m_colorBuffer + y * m_pitch;
+		float* depthRow = m_depthBuffer + y * m_pitch;
+		int32x4_t e0 = vaddq_s32(vdupq_n_s32(w0), laneOffset0);
+		int32x4_t e1 = vaddq_s32(vdupq_n_s32(w1), laneOffset1);
+		int32x4_t e2 = vaddq_s32(vdupq_n_s32(w2), laneOffset2);
+		float32x4_t pz = vaddq_f32(vdupq_n_f32(z), zLaneOffset);
+
+		for (int x = startX; x <= endX; x += 4)
+		{
+			const uint32x4_t inside = vcgeq_s32(vorrq_s32(vorrq_s32(e0, e1), e2), vdupq_n_s32(0));
+			const float32x4_t depth = vld1q_f32(depthRow + x);
+			const uint32x4_t write = vandq_u32(inside, vandq_u32(vcltq_f32(pz, depth), vcgeq_f32(pz, zero)));
+
+			if (vget_lane_u64(vreinterpret_u64_u16(vmovn_u32(write)), 0) != 0)
+			{
+				vst1q_f32(depthRow + x, vbslq_f32(write, pz, depth));
+				vst1q_u32(colorRow + x, vbslq_u32(write, color, vld1q_u32(colorRow + x)));
+			}
+
+			e0 = vaddq_s32(e0, stepX0);
+			e1 = vaddq_s32(e1, stepX1);
+			e2 = vaddq_s32(e2, stepX2);
+			pz = vaddq_f32(pz, zStepX);
+		}
+
+		w0 += triangle.m_stepY[0];
+		w1 += triangle.m_stepY[1];
+		w2 += triangle.m_stepY[2];
+		z += triangle.m_zStepY;
+	}
+#else
+	for (int y = startY; y <= endY; ++y)
+	{
+		uint32_t* colorRow = m_colorBuffer + y * m_pitch;
+		float* depthRow = m_depthBuffer + y * m_pitch;
+		int32_t e0 = w0, e1 = w1, e2 = w2;
+		float pz = z;
+
+		for (int x = startX; x <= endX; ++x)
+		{
+			if ((e0 | e1 | e2) >= 0 && pz >= 0.0F && pz < depthRow[x])
+			{
+				depthRow[x] = pz;
+				colorRow[x] = triangle.m_color;
+			}
+
+			e0 += triangle.m_stepX[0];
+			e1 += triangle.m_stepX[1];
+			e2 += triangle.m_stepX[2];
+			pz += triangle.m_zStepX;
+		}
+
+		w0 += triangle.m_stepY[0];
+		w1 += triangle.m_stepY[1];
+		w2 += triangle.m_stepY[2];
+		z += triangle.m_zStepY;
+	}
+#endif
+}
@@ -0,0 +1,184 @@
+#include <new>
+
+#include "Core\Job\JobSystem.h"
+#include "Core\Job\WorkStealingQueue.h"
+#include "Core\Misc\Memory.h"
+
+namespace
+{
+	thread_local int sThreadIndex = -1;
+}
+
+void JobSystem::OnInit(void)
+{
+	Start(GetDefaultWorkerCount());
+}
+
+void JobSystem::OnDestroy(void)
+{
+	Stop();
+}
+
+void JobSystem::Start(int workerCount)
+{
+	if (!m_queues.empty())
+		return;
+
+	//queues are cache line aligned, plain new does not promise it
+	for (int i = 0; i <= workerCount; ++i)
+		m_queues.push_back(new (AlignedMalloc(sizeof(WorkStealingQueue), 64)) WorkStealingQueue());
+
+	sThreadIndex = 0;
+	m_exit.store(false);
+	for (int i = 1; i <= workerCount; ++i)
+		m_workers.push_back(std::thread(&JobSystem::WorkerMain, this, i));
+}
+
+void JobSystem::Stop(void)
+{
+	m_exit.store(true);
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+	}
+	m_wake.notify_all();
+
+	for (size_t i = 0; i < m_workers.size(); ++i)
+		m_workers[i].join();
+	m_workers.clear();
+
+	for (size_t i = 0; i < m_queues.size(); ++i)
+	{
+		m_queues[i]->~WorkStealingQueue();
+		AlignedFree(m_queues[i]);
+	}
+	m_queues.clear();
+	m_queuedJobs.store(0);
+	sThreadIndex = -1;
+}
+
+int JobSystem::GetDefaultWorkerCount(void)
+{
+	const int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+	return std::max(hardwareThreads - 1, 0);
+}
+
+int JobSystem::GetThreadIndex(void)
+{
+	return sThreadIndex;
+}
+
+void JobSystem::Run(Job * jobs, int jobCount, JobCounter & counter)
+{
+	if (jobCount <= 0)
+		return;
+
+	counter.m_count.fetch_add(jobCount, std::memory_order_relaxed);
+
+	const int threadIndex = sThreadIndex;
+	if (threadIndex < 0 || threadIndex >= GetThreadCount())
+	{
+		for (int i = 0; i < jobCount; ++i)
+		{
+			jobs[i].m_counter = &counter;
+			Execute(jobs[i]);
+		}
+		return;
+	}
+
+	WorkStealingQueue& queue = *m_queues[threadIndex];
+	int pushed = 0;
+	for (int i = 0; i < jobCount; ++i)
+	{
+		jobs[i].m_counter = &counter;
+		//full, this thread has work enough already
+		if (queue.Push(&jobs[i]))
+			++pushed;
+		else
+			Execute(jobs[i]);
+	}
+
+	if (pushed > 0)
+	{
+		m_queuedJobs.fetch_add(pushed);
+		WakeWorkers(pushed);
+	}
+}
+
+void JobSystem::Wait(const JobCounter & counter)
+{
+	const int threadIndex = sThreadIndex;
+	while (!counter.IsDone())
+	{
+		Job* job = threadIndex >= 0 && threadIndex < GetThreadCount() ? FindJob(threadIndex) : nullptr;
+		if (job != nullptr)
+			Execute(*job);
+		else
+			std::this_thread::yield();
+	}
+}
+
+void JobSystem::WorkerMain(int threadIndex)
+{
+	sThreadIndex = threadIndex;
+
+	int idleCount = 0;
+	while (!m_exit.load(std::memory_order_acquire))
+	{
+		Job* job = FindJob(threadIndex);
+		if (job != nullptr)
+		{
+			Execute(*job);
+			idleCount = 0;
+			continue;
+		}
+
+		if (++idleCount < kSpinCount)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		idleCount = 0;
+
+		//Run adds the jobs before it looks for sleepers, so one of the two sees the other
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_sleepingWorkers.fetch_add(1);
+		m_wake.wait(lock, [this]() { return m_queuedJobs.load() > 0 || m_exit.load(); });
+		m_sleepingWorkers.fetch_sub(1);
+	}
+}
+
+Job * JobSystem::FindJob(int threadIndex)
+{
+	Job* job = m_queues[threadIndex]->Pop();
+
+	//oldest jobs of the others, they are the biggest left in a recursive split
+	const int threadCount = GetThreadCount();
+	for (int i = 1; job == nullptr && i < threadCount; ++i)
+		job = m_queues[(threadIndex + i) % threadCount]->Steal();
+
+	if (job != nullptr)
+		m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	return job;
+}
+
+void JobSystem::Execute(Job & job)
+{
+	JobCounter* counter = job.m_counter;
+	job.m_function(job.m_data, job.m_begin, job.m_end);
+	//the job may be gone once the counter drops
+	counter->m_count.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::WakeWorkers(int jobCount)
+{
+	if (m_sleepingWorkers.load() == 0)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+	}
+	if (jobCount == 1)
+		m_wake.notify_one();
+	else
+		m_wake.notify_all();
+}
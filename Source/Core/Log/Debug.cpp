@@ -1,7 +1,22 @@
 #include "Core\Container\String.h"
 #include "Core\Log\Debug.h"
 #include "Core\Log\LogManager.h"
+#include "Core\Misc\LinearAllocator.h"
 
+namespace
+{
+	//longer lines spill to the scratch stack
+	const size_t kInlineLineSize = 256;
+	typedef fmt::basic_memory_buffer<char, kInlineLineSize, LinearStlAllocator<char>> LineBuffer;
+
+	void WriteFormat(LogData::LogType logType, fmt::string_view format, fmt::format_args args)
+	{
+		ScratchScope scratch;
+		LineBuffer line((LinearStlAllocator<char>(scratch.GetAllocator())));
+		fmt::vformat_to(line, format, args);
+		LogManager::Instance()->Log(line.data(), line.size(), logType);
+	}
+}
 
 void Debug::Log(const String& logStr)
 {
@@ -16,4 +31,19 @@ void Debug::Warning(const String& warStr)
 void Debug::Error(const String& errStr)
 {
 	LogManager::Instance()->Log(errStr, LogData::LogType::Error);
-}
\ No newline at end of file
+}
+
+void Debug::LogFormat(fmt::string_view format, fmt::format_args args)
+{
+	WriteFormat(LogData::LogType::Log, format, args);
+}
+
+void Debug::WarningFormat(fmt::string_view format, fmt::format_args args)
+{
+	WriteFormat(LogData::LogType::Warning, format, args);
+}
+
+void Debug::ErrorFormat(fmt::string_view format, fmt::format_args args)
+{
+	WriteFormat(LogData::LogType::Error, format, args);
+}
@@ -2,33 +2,36 @@
 #include "Core\Log\LogHandler.h"
 
 /* LogData */
-LogData::LogData(const String &logStr, LogData::LogType logType) : m_logStr(logStr), m_logType(logType)
+LogData::LogData(const char* logStr, size_t length, LogData::LogType logType) : m_logStr(logStr, length), m_logType(logType)
 {
 	m_logTime = Time::Now();
 }
 
-void LogData::ReUse(const String& logStr, LogType logType)
+void LogData::ReUse(const char* logStr, size_t length, LogType logType)
 {
-	m_logStr = String(logStr);
+	m_logStr.assign(logStr, length);
 	m_logType = logType;
 	m_logTime = Time::Now();
 }
 
 /* LogManager */
 
-void LogManager::Log(const String& logInfo, LogData::LogType logType)
+void LogManager::Log(const char* logInfo, size_t length, LogData::LogType logType)
 {
-	const LogData* newLogData;
+	std::lock_guard<std::mutex> lock(m_logMutex);
+
+	LogData* newLogData;
 	if (m_logBuffer.size() == LOG_BUFFER_MAX_SIZE)
 	{
-		LogData *logData = const_cast<LogData*>(m_logBuffer.front());
-		m_logBuffer.pop();
-		logData->ReUse(logInfo, logType);
-
-		newLogData = logData;
+		newLogData = m_logBuffer[m_logNext];
+		newLogData->ReUse(logInfo, length, logType);
+		m_logNext = (m_logNext + 1) % LOG_BUFFER_MAX_SIZE;
 	}
 	else
-		newLogData = new LogData(logInfo, logType);
+	{
+		newLogData = new LogData(logInfo, length, logType);
+		m_logBuffer.push_back(newLogData);
+	}
 
 	//Notify Handler
 	//TODO : should use asset in debug?
@@ -40,4 +43,8 @@ void LogManager::OnDestroy(void)
 {
 	//TODO : File Flush ?
 	delete m_logHandler;
+
+	for (size_t i = 0; i < m_logBuffer.size(); ++i)
+		delete m_logBuffer[i];
+	m_logBuffer.clear();
 }
\ No newline at end of file
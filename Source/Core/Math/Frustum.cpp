@@ -0,0 +1,118 @@
+#include <cmath>
+#include "Core/Math/Frustum.h"
+#include "Core/Math/Matrix4x4.h"
+#include "Core/Math/Vector3Stream.h"
+#include "Core/Math/Simd/MathKernels.h"
+#include "Core/Math/Simd/CullWriter.h"
+
+void Frustum::Set(const Matrix4x4& viewProjection)
+{
+	// Gribb & Hartmann, clip.w +- clip.xyz >= 0
+	const Matrix4x4& m = viewProjection;
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			m_planes[i * 2 + 0][c] = m.Get(3, c) + m.Get(i, c);
+			m_planes[i * 2 + 1][c] = m.Get(3, c) - m.Get(i, c);
+		}
+	}
+
+	for (int i = 0; i < kPlaneCount; ++i)
+	{
+		Vector4& p = m_planes[i];
+		const float length = sqrtf(p.X * p.X + p.Y * p.Y + p.Z * p.Z);
+		if (length > 0.0F)
+			p = p * (1.0F / length);
+	}
+}
+
+bool Frustum::IsVisible(const Vector3& center, const Vector3& extents) const
+{
+	for (int i = 0; i < kPlaneCount; ++i)
+	{
+		const Vector4& p = m_planes[i];
+		const float distance = p.X * center.X + p.Y * center.Y + p.Z * center.Z + p.W;
+		const float radius = fabsf(p.X) * extents.X + fabsf(p.Y) * extents.Y + fabsf(p.Z) * extents.Z;
+		if (distance + radius < 0.0F)
+			return false;
+	}
+	return true;
+}
+
+bool Frustum::IsVisible(const Vector3& center, float radius) const
+{
+	for (int i = 0; i < kPlaneCount; ++i)
+	{
+		const Vector4& p = m_planes[i];
+		if (p.X * center.X + p.Y * center.Y + p.Z * center.Z + p.W + radius < 0.0F)
+			return false;
+	}
+	return true;
+}
+
+size_t CullAABBs(const Frustum& frustum, const Vector3Stream& centers, const Vector3Stream& extents, uint32_t* visibleMask, uint32_t* visibleIndices)
+{
+	/* Assert(centers.GetCount() == extents.GetCount()); */
+	return gMathKernels.cullAABBStream(frustum.GetPlanes(), centers, extents, visibleMask, visibleIndices);
+}
+
+size_t CullSpheres(const Frustum& frustum, const Vector3Stream& centers, const float* radii, uint32_t* visibleMask, uint32_t* visibleIndices)
+{
+	return gMathKernels.cullSphereStream(frustum.GetPlanes(), centers, radii, visibleMask, visibleIndices);
+}
+
+/* Scalar reference kernels */
+
+size_t CullAABBStream_Scalar(const Vector4* planes, const Vector3Stream& centers, const Vector3Stream& extents, uint32_t* mask, uint32_t* indices)
+{
+	const float* cx = centers.GetX(); const float* cy = centers.GetY(); const float* cz = centers.GetZ();
+	const float* ex = extents.GetX(); const float* ey = extents.GetY(); const float* ez = extents.GetZ();
+	const size_t count = centers.GetCount();
+
+	CullWriter writer(mask, indices);
+	for (size_t i = 0; i < count; i += 4)
+	{
+		uint32_t bits = 0;
+		for (size_t k = 0; k < 4; ++k)
+		{
+			const size_t j = i + k;
+			bool inside = true;
+			for (int p = 0; p < Frustum::kPlaneCount; ++p)
+			{
+				const Vector4& plane = planes[p];
+				const float distance = plane.X * cx[j] + plane.Y * cy[j] + plane.Z * cz[j] + plane.W;
+				const float radius = fabsf(plane.X) * ex[j] + fabsf(plane.Y) * ey[j] + fabsf(plane.Z) * ez[j];
+				inside &= distance + radius >= 0.0F;
+			}
+			bits |= (inside ? 1U : 0U) << k;
+		}
+		writer.Write(bits & CullWriter::LaneMask(i, count, 4), i, 4);
+	}
+	return writer.Finish();
+}
+
+size_t CullSphereStream_Scalar(const Vector4* planes, const Vector3Stream& centers, const float* radii, uint32_t* mask, uint32_t* indices)
+{
+	const float* cx = centers.GetX(); const float* cy = centers.GetY(); const float* cz = centers.GetZ();
+	const size_t count = centers.GetCount();
+
+	CullWriter writer(mask, indices);
+	for (size_t i = 0; i < count; i += 4)
+	{
+		uint32_t bits = 0;
+		for (size_t k = 0; k < 4 && i + k < count; ++k)
+		{
+			const size_t j = i + k;
+			bool inside = true;
+			for (int p = 0; p < Frustum::kPlaneCount; ++p)
+			{
+				const Vector4& plane = planes[p];
+				inside &= plane.X * cx[j] + plane.Y * cy[j] + plane.Z * cz[j] + plane.W + radii[j] >= 0.0F;
+			}
+			bits |= (inside ? 1U : 0U) << k;
+		}
+		writer.Write(bits, i, 4);
+	}
+	return writer.Finish();
+}
@@ -1,5 +1,5 @@
-﻿#include "Core\Math\Matrix3x3.h"
-#include "Core\Math\Matrix4x4.h"
+﻿#include "Core/Math/Matrix3x3.h"
+#include "Core/Math/Matrix4x4.h"
 
 namespace
 {
@@ -23,37 +23,11 @@ const Matrix3x3 Matrix3x3::zero = CreateZeroMatrix3x3();
 
 void GetRotMatrixNormVec(float* out, const float* inVec, float radians);
 
-inline Vector3 Matrix3x3::MultiplyVector3(const Vector3& v) const
-{
-	Vector3 res;
-	res.X = m_data[0] * v.X + m_data[3] * v.Y + m_data[6] * v.Z;
-	res.Y = m_data[1] * v.X + m_data[4] * v.Y + m_data[7] * v.Z;
-	res.Z = m_data[2] * v.X + m_data[5] * v.Y + m_data[8] * v.Z;
-	return res;
-}
-
-inline void Matrix3x3::MultiplyVector3(const Vector3& v, Vector3& output) const
-{
-	output.X = m_data[0] * v.X + m_data[3] * v.Y + m_data[6] * v.Z;
-	output.Y = m_data[1] * v.X + m_data[4] * v.Y + m_data[7] * v.Z;
-	output.Z = m_data[2] * v.X + m_data[5] * v.Y + m_data[8] * v.Z;
-}
-
 Vector3 Matrix3x3::MultiplyPoint3(const Vector3 & inV) const
 {
 	return MultiplyVector3(inV);
 }
 
-inline Vector3 Matrix3x3::MultiplyVector3Transpose(const Vector3& v) const
-{
-	Vector3 res;
-	res.X = Get(0, 0) * v.X + Get(1, 0) * v.Y + Get(2, 0) * v.Z;
-	res.Y = Get(0, 1) * v.X + Get(1, 1) * v.Y + Get(2, 1) * v.Z;
-	res.Z = Get(0, 2) * v.X + Get(1, 2) * v.Y + Get(2, 2) * v.Z;
-	return res;
-}
-
-
 Matrix3x3& Matrix3x3::operator=(const Matrix4x4& mat4)
 {
 	m_data[0] = mat4.m_data[0];
@@ -85,7 +59,6 @@ Matrix3x3::Matrix3x3(const Matrix4x4& mat4)
 	m_data[8] = mat4.m_data[10];
 }
 
-
 Matrix3x3& Matrix3x3::SetIdentity()
 {
 	Get(0, 0) = 1.0F;  Get(0, 1) = 0.0F;  Get(0, 2) = 0.0F;
@@ -102,7 +75,6 @@ Matrix3x3& Matrix3x3::SetZero()
 	return *this;
 }
 
-
 Matrix3x3& Matrix3x3::SetBasis(const Vector3& inX, const Vector3& inY, const Vector3& inZ)
 {
 	Get(0, 0) = inX[0];    Get(0, 1) = inY[0];    Get(0, 2) = inZ[0];
@@ -119,7 +91,6 @@ Matrix3x3& Matrix3x3::SetBasisTransposed(const Vector3& inX, const Vector3& inY,
 	return *this;
 }
 
-
 Matrix3x3& Matrix3x3::SetScale(const Vector3& inScale)
 {
 	Get(0, 0) = inScale[0];    Get(0, 1) = 0.0F;          Get(0, 2) = 0.0F;
@@ -144,7 +115,6 @@ Matrix3x3& Matrix3x3::Scale(const Vector3& inScale)
 	return *this;
 }
 
-
 bool Matrix3x3::IsIdentity(float threshold)
 {
 	if (CompareApproximately(Get(0, 0), 1.0f, threshold) && CompareApproximately(Get(0, 1), 0.0f, threshold) && CompareApproximately(Get(0, 2), 0.0f, threshold) &&
@@ -154,7 +124,6 @@ bool Matrix3x3::IsIdentity(float threshold)
 	return false;
 }
 
-
 float Matrix3x3::GetDeterminant() const
 {
 	float fCofactor0 = Get(0, 0) * Get(1, 1) * Get(2, 2);
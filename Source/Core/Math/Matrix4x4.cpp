@@ -1,8 +1,10 @@
 #include <stdint.h>
-#include "Core\Math\Matrix4x4.h"
-#include "Core\Math\Matrix3x3.h"
-#include "Core\Math\Quaternion.h"
-#include "Core\Misc\Utility.h"
+#include <stdexcept>
+#include "Core/Math/Matrix4x4.h"
+#include "Core/Math/Matrix3x3.h"
+#include "Core/Math/Quaternion.h"
+#include "Core/Math/Simd/MathKernels.h"
+#include "Core/Misc/Utility.h"
 
 /* Intersting !!! */
 // when putting control-flow, multiple statements, or unknown code (e.g. passed via an outer macro) inside of a macro,
@@ -20,213 +22,6 @@
 
 const Matrix4x4 Matrix4x4::identity(Identity);
 
-inline Matrix4x4::Matrix4x4(const Matrix4x4 &other)
-{
-	CopyMatrix4x4(other.GetPtr(), GetPtr());
-}
-
-inline Matrix4x4& Matrix4x4::operator=(const Matrix4x4& m)
-{
-	CopyMatrix4x4(m.GetPtr(), GetPtr());
-	return *this;
-}
-
-inline Vector3 Matrix4x4::GetAxisX() const
-{
-	return Vector3(Get(0, 0), Get(1, 0), Get(2, 0));
-}
-
-inline Vector3 Matrix4x4::GetAxisY() const
-{
-	return Vector3(Get(0, 1), Get(1, 1), Get(2, 1));
-}
-
-inline Vector3 Matrix4x4::GetAxisZ() const
-{
-	return Vector3(Get(0, 2), Get(1, 2), Get(2, 2));
-}
-
-inline Vector3 Matrix4x4::GetAxis(int axis) const
-{
-	return Vector3(Get(0, axis), Get(1, axis), Get(2, axis));
-}
-
-inline Vector3 Matrix4x4::GetPosition() const
-{
-	return Vector3(Get(0, 3), Get(1, 3), Get(2, 3));
-}
-
-inline Vector4 Matrix4x4::GetRow(int row) const
-{
-	return Vector4(Get(row, 0), Get(row, 1), Get(row, 2), Get(row, 3));
-}
-
-inline Vector4 Matrix4x4::GetColumn(int col) const
-{
-	return Vector4(Get(0, col), Get(1, col), Get(2, col), Get(3, col));
-}
-
-inline void Matrix4x4::SetAxisX(const Vector3& v)
-{
-	Get(0, 0) = v.X; Get(1, 0) = v.Y; Get(2, 0) = v.Z;
-}
-
-inline void Matrix4x4::SetAxisY(const Vector3& v)
-{
-	Get(0, 1) = v.X; Get(1, 1) = v.Y; Get(2, 1) = v.Z;
-}
-
-inline void Matrix4x4::SetAxisZ(const Vector3& v)
-{
-	Get(0, 2) = v.X; Get(1, 2) = v.Y; Get(2, 2) = v.Z;
-}
-
-inline void Matrix4x4::SetAxis(int axis, const Vector3& v)
-{
-	Get(0, axis) = v.X; Get(1, axis) = v.Y; Get(2, axis) = v.Z;
-}
-
-inline void Matrix4x4::SetPosition(const Vector3& v)
-{
-	Get(0, 3) = v.X; Get(1, 3) = v.Y; Get(2, 3) = v.Z;
-}
-
-inline void Matrix4x4::SetRow(int row, const Vector4& v)
-{
-	Get(row, 0) = v.X; Get(row, 1) = v.Y; Get(row, 2) = v.Z; Get(row, 3) = v.W;
-}
-
-inline void Matrix4x4::SetColumn(int col, const Vector4& v)
-{
-	Get(0, col) = v.X; Get(1, col) = v.Y; Get(2, col) = v.Z; Get(3, col) = v.W;
-}
-
-inline Vector3 Matrix4x4::MultiplyPoint3(const Vector3& v) const
-{
-	Vector3 res;
-	res.X = m_data[0] * v.X + m_data[4] * v.Y + m_data[8] * v.Z + m_data[12];
-	res.Y = m_data[1] * v.X + m_data[5] * v.Y + m_data[9] * v.Z + m_data[13];
-	res.Z = m_data[2] * v.X + m_data[6] * v.Y + m_data[10] * v.Z + m_data[14];
-	return res;
-}
-
-inline void Matrix4x4::MultiplyPoint3(const Vector3& v, Vector3& output) const
-{
-	output.X = m_data[0] * v.X + m_data[4] * v.Y + m_data[8] * v.Z + m_data[12];
-	output.Y = m_data[1] * v.X + m_data[5] * v.Y + m_data[9] * v.Z + m_data[13];
-	output.Z = m_data[2] * v.X + m_data[6] * v.Y + m_data[10] * v.Z + m_data[14];
-}
-
-inline Vector3 Matrix4x4::MultiplyVector3(const Vector3& v) const
-{
-	Vector3 res;
-	res.X = m_data[0] * v.X + m_data[4] * v.Y + m_data[8] * v.Z;
-	res.Y = m_data[1] * v.X + m_data[5] * v.Y + m_data[9] * v.Z;
-	res.Z = m_data[2] * v.X + m_data[6] * v.Y + m_data[10] * v.Z;
-	return res;
-}
-
-inline void Matrix4x4::MultiplyVector3(const Vector3& v, Vector3& output) const
-{
-	output.X = m_data[0] * v.X + m_data[4] * v.Y + m_data[8] * v.Z;
-	output.Y = m_data[1] * v.X + m_data[5] * v.Y + m_data[9] * v.Z;
-	output.Z = m_data[2] * v.X + m_data[6] * v.Y + m_data[10] * v.Z;
-}
-
-inline bool Matrix4x4::PerspectiveMultiplyPoint3(const Vector3& v, Vector3& output) const
-{
-	Vector3 res;
-	float w;
-	res.X = Get(0, 0) * v.X + Get(0, 1) * v.Y + Get(0, 2) * v.Z + Get(0, 3);
-	res.Y = Get(1, 0) * v.X + Get(1, 1) * v.Y + Get(1, 2) * v.Z + Get(1, 3);
-	res.Z = Get(2, 0) * v.X + Get(2, 1) * v.Y + Get(2, 2) * v.Z + Get(2, 3);
-	w = Get(3, 0) * v.X + Get(3, 1) * v.Y + Get(3, 2) * v.Z + Get(3, 3);
-	if (abs(w) > 1.0e-7f)
-	{
-		float invW = 1.0f / w;
-		output.X = res.X * invW;
-		output.Y = res.Y * invW;
-		output.Z = res.Z * invW;
-		return true;
-	}
-	else
-	{
-		output.X = 0.0f;
-		output.Y = 0.0f;
-		output.Z = 0.0f;
-		return false;
-	}
-}
-
-inline Vector4 Matrix4x4::MultiplyVector4(const Vector4& v) const
-{
-	Vector4 res;
-	MultiplyVector4(v, res);
-	return res;
-}
-
-inline void Matrix4x4::MultiplyVector4(const Vector4& v, Vector4& output) const
-{
-	output.X = m_data[0] * v.X + m_data[4] * v.Y + m_data[8] * v.Z + m_data[12] * v.W;
-	output.Y = m_data[1] * v.X + m_data[5] * v.Y + m_data[9] * v.Z + m_data[13] * v.W;
-	output.Z = m_data[2] * v.X + m_data[6] * v.Y + m_data[10] * v.Z + m_data[14] * v.W;
-	output.W = m_data[3] * v.X + m_data[7] * v.Y + m_data[11] * v.Z + m_data[15] * v.W;
-}
-
-inline bool Matrix4x4::PerspectiveMultiplyVector3(const Vector3& v, Vector3& output) const
-{
-	Vector3 res;
-	float w;
-	res.X = Get(0, 0) * v.X + Get(0, 1) * v.Y + Get(0, 2) * v.Z;
-	res.Y = Get(1, 0) * v.X + Get(1, 1) * v.Y + Get(1, 2) * v.Z;
-	res.Z = Get(2, 0) * v.X + Get(2, 1) * v.Y + Get(2, 2) * v.Z;
-	w = Get(3, 0) * v.X + Get(3, 1) * v.Y + Get(3, 2) * v.Z;
-	if (abs(w) > 1.0e-7f)
-	{
-		float invW = 1.0f / w;
-		output.X = res.X * invW;
-		output.Y = res.Y * invW;
-		output.Z = res.Z * invW;
-		return true;
-	}
-	else
-	{
-		output.X = 0.0f;
-		output.Y = 0.0f;
-		output.Z = 0.0f;
-		return false;
-	}
-}
-
-inline Vector3 Matrix4x4::InverseMultiplyPoint3Affine(const Vector3& inV) const
-{
-	Vector3 v(inV.X - Get(0, 3), inV.Y - Get(1, 3), inV.Z - Get(2, 3));
-	Vector3 res;
-	res.X = Get(0, 0) * v.X + Get(1, 0) * v.Y + Get(2, 0) * v.Z;
-	res.Y = Get(0, 1) * v.X + Get(1, 1) * v.Y + Get(2, 1) * v.Z;
-	res.Z = Get(0, 2) * v.X + Get(1, 2) * v.Y + Get(2, 2) * v.Z;
-	return res;
-}
-
-inline Vector3 Matrix4x4::InverseMultiplyVector3Affine(const Vector3& v) const
-{
-	Vector3 res;
-	res.X = Get(0, 0) * v.X + Get(1, 0) * v.Y + Get(2, 0) * v.Z;
-	res.Y = Get(0, 1) * v.X + Get(1, 1) * v.Y + Get(2, 1) * v.Z;
-	res.Z = Get(0, 2) * v.X + Get(1, 2) * v.Y + Get(2, 2) * v.Z;
-	return res;
-}
-
-inline bool IsFinite(const Matrix4x4& f)
-{
-	return
-		isfinite(f.m_data[0]) & isfinite(f.m_data[1]) & isfinite(f.m_data[2]) &
-		isfinite(f.m_data[4]) & isfinite(f.m_data[5]) & isfinite(f.m_data[6]) &
-		isfinite(f.m_data[8]) & isfinite(f.m_data[9]) & isfinite(f.m_data[10]) &
-		isfinite(f.m_data[12]) & isfinite(f.m_data[13]) & isfinite(f.m_data[14]) & isfinite(f.m_data[15]);
-}
-
-
 Matrix4x4::Matrix4x4(const float data[16])
 {
 	for (int i = 0; i < 16; i++)
@@ -786,6 +581,140 @@ bool InvertMatrix4x4_General3D(const float* in, float* out)
 #undef MAT
 #undef RETURN_ZERO
 
+namespace
+{
+	// ComputeTransformType only looks at axis lengths, a sheared matrix can
+	// have unit axes. The transpose based inverses need orthogonal ones.
+	bool HasOrthogonalAxes(const float* m, float epsilon)
+	{
+		const float sqrScale = m[0] * m[0] + m[1] * m[1] + m[2] * m[2];
+		const float xy = m[0] * m[4] + m[1] * m[5] + m[2] * m[6];
+		const float xz = m[0] * m[8] + m[1] * m[9] + m[2] * m[10];
+		const float yz = m[4] * m[8] + m[5] * m[9] + m[6] * m[10];
+		const float limit = epsilon * sqrScale;
+		return fabsf(xy) <= limit && fabsf(xz) <= limit && fabsf(yz) <= limit;
+	}
+
+	// out = transpose(3x3) * invSqrScale, translation = -out * t
+	inline void InvertScaledTranspose(const float* m, float* out, float invSqrScale)
+	{
+		const float r00 = m[0] * invSqrScale, r01 = m[1] * invSqrScale, r02 = m[2] * invSqrScale;
+		const float r10 = m[4] * invSqrScale, r11 = m[5] * invSqrScale, r12 = m[6] * invSqrScale;
+		const float r20 = m[8] * invSqrScale, r21 = m[9] * invSqrScale, r22 = m[10] * invSqrScale;
+		const float tx = m[12], ty = m[13], tz = m[14];
+
+		out[0] = r00; out[1] = r10; out[2] = r20; out[3] = 0.0F;
+		out[4] = r01; out[5] = r11; out[6] = r21; out[7] = 0.0F;
+		out[8] = r02; out[9] = r12; out[10] = r22; out[11] = 0.0F;
+		out[12] = -(r00 * tx + r01 * ty + r02 * tz);
+		out[13] = -(r10 * tx + r11 * ty + r12 * tz);
+		out[14] = -(r20 * tx + r21 * ty + r22 * tz);
+		out[15] = 1.0F;
+	}
+}
+
+bool Matrix4x4::Invert(const Matrix4x4& inM, Matrix4x4& outM)
+{
+	if (inM.IsPerspective())
+		return InvertMatrix4x4_Full(inM.m_data, outM.m_data);
+
+	const TransformType type = ComputeTransformType(inM);
+	if (IsNonUniformScaleTransform(type) || !HasOrthogonalAxes(inM.m_data, Vector3::epsilon))
+		return InvertMatrix4x4_Affine(inM.m_data, outM.m_data);
+
+	if (IsUniformScaleTransform(type))
+		InvertMatrix4x4_UniformScale(inM.m_data, outM.m_data);
+	else
+		InvertMatrix4x4_Rigid(inM.m_data, outM.m_data);
+	return true;
+}
+
+void InvertMatrix4x4_Rigid(const float* m, float* out)
+{
+	gMathKernels.invertMatrix4x4Rigid(m, out);
+}
+
+void InvertMatrix4x4_UniformScale(const float* m, float* out)
+{
+	gMathKernels.invertMatrix4x4UniformScale(m, out);
+}
+
+bool InvertMatrix4x4_Affine(const float* m, float* out)
+{
+	return gMathKernels.invertMatrix4x4Affine(m, out);
+}
+
+bool InvertMatrixArray4x4(const Matrix4x4* a, Matrix4x4* res, size_t count)
+{
+	bool invertible = true;
+	size_t begin = 0;
+
+	//affine runs go to the batch kernel, projections one by one
+	for (size_t i = 0; i <= count; ++i)
+	{
+		if (i < count && !a[i].IsPerspective())
+			continue;
+
+		if (i > begin)
+			invertible &= gMathKernels.invertMatrixArray4x4Affine(a + begin, res + begin, i - begin);
+		if (i < count)
+			invertible &= InvertMatrix4x4_Full(a[i].m_data, res[i].m_data);
+		begin = i + 1;
+	}
+	return invertible;
+}
+
+void InvertMatrix4x4_Rigid_Scalar(const float* m, float* out)
+{
+	InvertScaledTranspose(m, out, 1.0F);
+}
+
+void InvertMatrix4x4_UniformScale_Scalar(const float* m, float* out)
+{
+	InvertScaledTranspose(m, out, 1.0F / (m[0] * m[0] + m[1] * m[1] + m[2] * m[2]));
+}
+
+// Rows of the inverse 3x3 are the cross products of its columns over the determinant.
+// Reads everything before writing, so m may be the same as out.
+bool InvertMatrix4x4_Affine_Scalar(const float* m, float* out)
+{
+	const float ax = m[0], ay = m[1], az = m[2];
+	const float bx = m[4], by = m[5], bz = m[6];
+	const float cx = m[8], cy = m[9], cz = m[10];
+	const float tx = m[12], ty = m[13], tz = m[14];
+
+	// b x c, c x a, a x b
+	const float r00 = by * cz - bz * cy, r01 = bz * cx - bx * cz, r02 = bx * cy - by * cx;
+	const float r10 = cy * az - cz * ay, r11 = cz * ax - cx * az, r12 = cx * ay - cy * ax;
+	const float r20 = ay * bz - az * by, r21 = az * bx - ax * bz, r22 = ax * by - ay * bx;
+
+	const float det = ax * r00 + ay * r01 + az * r02;
+	if (det * det < 1e-25F)
+	{
+		for (int i = 0; i < 16; i++)
+			out[i] = 0.0F;
+		return false;
+	}
+
+	const float invDet = 1.0F / det;
+	out[0] = r00 * invDet; out[1] = r10 * invDet; out[2] = r20 * invDet; out[3] = 0.0F;
+	out[4] = r01 * invDet; out[5] = r11 * invDet; out[6] = r21 * invDet; out[7] = 0.0F;
+	out[8] = r02 * invDet; out[9] = r12 * invDet; out[10] = r22 * invDet; out[11] = 0.0F;
+	out[12] = -(out[0] * tx + out[4] * ty + out[8] * tz);
+	out[13] = -(out[1] * tx + out[5] * ty + out[9] * tz);
+	out[14] = -(out[2] * tx + out[6] * ty + out[10] * tz);
+	out[15] = 1.0F;
+	return true;
+}
+
+bool InvertMatrixArray4x4Affine_Scalar(const Matrix4x4* a, Matrix4x4* res, size_t count)
+{
+	bool invertible = true;
+	for (size_t i = 0; i < count; ++i)
+		invertible &= InvertMatrix4x4_Affine_Scalar(a[i].m_data, res[i].m_data);
+	return invertible;
+}
+
 Matrix4x4& Matrix4x4::Transpose()
 {
 	std::swap(Get(0, 1), Get(1, 0));
@@ -908,7 +837,7 @@ FrustumPlanes Matrix4x4::DecomposeProjection() const
 
 Quaternionf Matrix4x4::GetRotation() const
 {
-	throw std::exception("Not Implemented[need delete SIMD]");
+	throw std::runtime_error("Not Implemented[need delete SIMD]");
 	/* Assert(ValidTRS()); */
 
 	/* delete simd */
@@ -947,6 +876,11 @@ bool Matrix4x4::ValidTRS() const
 }
 
 void MultiplyMatrices4x4(const Matrix4x4* __restrict lhs, const Matrix4x4* __restrict rhs, Matrix4x4* __restrict res)
+{
+	gMathKernels.multiplyMatrices4x4(lhs, rhs, res);
+}
+
+void MultiplyMatrices4x4_Scalar(const Matrix4x4* __restrict lhs, const Matrix4x4* __restrict rhs, Matrix4x4* __restrict res)
 {
 	/* Assert(lhs != rhs && lhs != res && rhs != res); */
 	for (int i = 0; i < 4; i++)
@@ -977,9 +911,14 @@ void MultiplyMatrixArray4x4(const Matrix4x4* __restrict a, const Matrix4x4* __re
 	Assert(res);
 	*/
 
+	gMathKernels.multiplyMatrixArray4x4(a, b, res, count);
+}
+
+void MultiplyMatrixArray4x4_Scalar(const Matrix4x4* __restrict a, const Matrix4x4* __restrict b, Matrix4x4* __restrict res, size_t count)
+{
 	for (size_t i = 0; i < count; ++i)
 	{
-		MultiplyMatrices4x4(a + i, b + i, res + i);
+		MultiplyMatrices4x4_Scalar(a + i, b + i, res + i);
 	}
 }
 
@@ -993,11 +932,17 @@ void MultiplyMatrixArrayWithBase4x4(const Matrix4x4* __restrict base,
 	Assert(res);
 	*/
 
+	gMathKernels.multiplyMatrixArrayWithBase4x4(base, a, b, res, count);
+}
+
+void MultiplyMatrixArrayWithBase4x4_Scalar(const Matrix4x4* __restrict base,
+	const Matrix4x4* __restrict a, const Matrix4x4* __restrict b, Matrix4x4* __restrict res, size_t count)
+{
 	Matrix4x4 tmp;
 	for (size_t i = 0; i < count; ++i)
 	{
-		MultiplyMatrices4x4(base, a + i, &tmp);
-		MultiplyMatrices4x4(&tmp, b + i, res + i);
+		MultiplyMatrices4x4_Scalar(base, a + i, &tmp);
+		MultiplyMatrices4x4_Scalar(&tmp, b + i, res + i);
 	}
 }
 
@@ -1,4 +1,4 @@
-#include "Core\Math\Quaternion.h"
+#include "Core/Math/Quaternion.h"
 
 Quaternionf Slerp(const Quaternionf& q1, const Quaternionf& q2, float t)
 {
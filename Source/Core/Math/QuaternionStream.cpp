@@ -0,0 +1,244 @@
+#include <cstring>
+#include <cmath>
+#include <new>
+#include "Core/Math/QuaternionStream.h"
+#include "Core/Math/Matrix4x4.h"
+#include "Core/Math/Simd/MathKernels.h"
+#include "Core/Misc/Memory.h"
+#include "Core/Misc/Utility.h"
+
+QuaternionStream::QuaternionStream(size_t count) : m_data(nullptr), m_count(0), m_paddedCount(0), m_capacity(0)
+{
+	Resize(count);
+}
+
+QuaternionStream::QuaternionStream(const QuaternionStream& other) : m_data(nullptr), m_count(0), m_paddedCount(0), m_capacity(0)
+{
+	*this = other;
+}
+
+QuaternionStream::~QuaternionStream(void)
+{
+	AlignedFree(m_data);
+}
+
+QuaternionStream& QuaternionStream::operator=(const QuaternionStream& other)
+{
+	if (this == &other)
+		return *this;
+
+	Resize(other.m_count);
+	const size_t bytes = m_paddedCount * sizeof(float);
+	if (bytes != 0)
+	{
+		memcpy(GetX(), other.GetX(), bytes);
+		memcpy(GetY(), other.GetY(), bytes);
+		memcpy(GetZ(), other.GetZ(), bytes);
+		memcpy(GetW(), other.GetW(), bytes);
+	}
+	return *this;
+}
+
+void QuaternionStream::Resize(size_t count)
+{
+	const size_t paddedCount = AlignSize(count, kWidth);
+
+	if (paddedCount > m_capacity)
+	{
+		float* data = static_cast<float*>(AlignedMalloc(paddedCount * 4 * sizeof(float), kAlignment));
+		if (data == nullptr)
+			throw std::bad_alloc();
+		memset(data, 0, paddedCount * 4 * sizeof(float));
+		if (m_count != 0)
+		{
+			memcpy(data, GetX(), m_count * sizeof(float));
+			memcpy(data + paddedCount, GetY(), m_count * sizeof(float));
+			memcpy(data + paddedCount * 2, GetZ(), m_count * sizeof(float));
+			memcpy(data + paddedCount * 3, GetW(), m_count * sizeof(float));
+		}
+		AlignedFree(m_data);
+		m_data = data;
+		m_capacity = paddedCount;
+	}
+	else if (count > m_count)
+	{
+		memset(GetX() + m_count, 0, (paddedCount - m_count) * sizeof(float));
+		memset(GetY() + m_count, 0, (paddedCount - m_count) * sizeof(float));
+		memset(GetZ() + m_count, 0, (paddedCount - m_count) * sizeof(float));
+		memset(GetW() + m_count, 0, (paddedCount - m_count) * sizeof(float));
+	}
+
+	float* w = GetW();
+	for (size_t i = m_count; i < count; ++i)
+		w[i] = 1.0F;
+
+	m_count = count;
+	m_paddedCount = paddedCount;
+}
+
+void QuaternionStream::Load(const Quaternionf* input, size_t inStride, size_t count)
+{
+	Resize(count);
+
+	float* x = GetX();
+	float* y = GetY();
+	float* z = GetZ();
+	float* w = GetW();
+	for (size_t i = 0; i < count; ++i, input = Stride(input, inStride))
+	{
+		x[i] = input->x;
+		y[i] = input->y;
+		z[i] = input->z;
+		w[i] = input->w;
+	}
+}
+
+void QuaternionStream::Store(Quaternionf* output, size_t outStride) const
+{
+	const float* x = GetX();
+	const float* y = GetY();
+	const float* z = GetZ();
+	const float* w = GetW();
+	for (size_t i = 0; i < m_count; ++i, output = Stride(output, outStride))
+	{
+		output->x = x[i];
+		output->y = y[i];
+		output->z = z[i];
+		output->w = w[i];
+	}
+}
+
+void Slerp(const QuaternionStream& a, const QuaternionStream& b, float t, QuaternionStream& output)
+{
+	/* Assert(a.GetCount() == b.GetCount()); */
+	if (&output != &a && &output != &b)
+		output.Resize(a.GetCount());
+	gMathKernels.slerpQuaternionStream(a, b, &t, 0, output);
+}
+
+void Slerp(const QuaternionStream& a, const QuaternionStream& b, const float* t, QuaternionStream& output)
+{
+	/* Assert(a.GetCount() == b.GetCount()); */
+	if (&output != &a && &output != &b)
+		output.Resize(a.GetCount());
+	gMathKernels.slerpQuaternionStream(a, b, t, 1, output);
+}
+
+void NormalizeSafe(const QuaternionStream& input, QuaternionStream& output)
+{
+	if (&output != &input)
+		output.Resize(input.GetCount());
+	gMathKernels.normalizeQuaternionStream(input, output);
+}
+
+void SetTRS(const Vector3Stream& pos, const QuaternionStream& rot, const Vector3Stream& scale, Matrix4x4* output)
+{
+	/* Assert(pos.GetCount() == rot.GetCount() && scale.GetCount() == rot.GetCount()); */
+	gMathKernels.setTRSStream(&pos, rot, &scale, output);
+}
+
+void QuaternionToMatrix(const QuaternionStream& rot, Matrix4x4* output)
+{
+	gMathKernels.setTRSStream(nullptr, rot, nullptr, output);
+}
+
+/* Scalar reference kernels */
+
+namespace
+{
+	// 1/|q| for q, identity if |q| is near zero
+	inline void NormalizeSafe(float& x, float& y, float& z, float& w)
+	{
+		const float sqrMag = x * x + y * y + z * z + w * w;
+		const bool valid = sqrMag >= Vector3::epsilon * Vector3::epsilon;
+		const float invMag = valid ? 1.0F / sqrtf(sqrMag) : 0.0F;
+		x *= invMag;
+		y *= invMag;
+		z *= invMag;
+		w = valid ? w * invMag : 1.0F;
+	}
+}
+
+// nlerp with t remapped so the angular velocity is close to constant,
+// fit from "Approximating slerp", A. Kapoulkine
+void SlerpQuaternionStream_Scalar(const QuaternionStream& a, const QuaternionStream& b, const float* t, size_t tStep, QuaternionStream& output)
+{
+	const float* ax = a.GetX(); const float* ay = a.GetY(); const float* az = a.GetZ(); const float* aw = a.GetW();
+	const float* bx = b.GetX(); const float* by = b.GetY(); const float* bz = b.GetZ(); const float* bw = b.GetW();
+	float* ox = output.GetX(); float* oy = output.GetY(); float* oz = output.GetZ(); float* ow = output.GetW();
+
+	for (size_t i = 0, count = a.GetCount(); i < count; ++i)
+	{
+		const float ti = t[i * tStep];
+		const float cosAngle = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i] + aw[i] * bw[i];
+		const float d = fabsf(cosAngle);
+		const float k0 = 1.0904F + d * (-3.2452F + d * (3.55645F - d * 1.43519F));
+		const float k1 = 0.848013F + d * (-1.06021F + d * 0.215638F);
+		const float tc = ti - 0.5F;
+		const float k = k0 * tc * tc + k1;
+		const float ot = ti + ti * tc * (ti - 1.0F) * k;
+		const float lt = 1.0F - ot;
+		//shortest path, same as negating b when the dot is negative
+		const float rt = cosAngle < 0.0F ? -ot : ot;
+
+		float x = ax[i] * lt + bx[i] * rt;
+		float y = ay[i] * lt + by[i] * rt;
+		float z = az[i] * lt + bz[i] * rt;
+		float w = aw[i] * lt + bw[i] * rt;
+		NormalizeSafe(x, y, z, w);
+		ox[i] = x; oy[i] = y; oz[i] = z; ow[i] = w;
+	}
+}
+
+void NormalizeQuaternionStream_Scalar(const QuaternionStream& input, QuaternionStream& output)
+{
+	const float* ix = input.GetX(); const float* iy = input.GetY(); const float* iz = input.GetZ(); const float* iw = input.GetW();
+	float* ox = output.GetX(); float* oy = output.GetY(); float* oz = output.GetZ(); float* ow = output.GetW();
+
+	for (size_t i = 0, count = input.GetCount(); i < count; ++i)
+	{
+		float x = ix[i], y = iy[i], z = iz[i], w = iw[i];
+		NormalizeSafe(x, y, z, w);
+		ox[i] = x; oy[i] = y; oz[i] = z; ow[i] = w;
+	}
+}
+
+void SetTRSStream_Scalar(const Vector3Stream* pos, const QuaternionStream& rot, const Vector3Stream* scale, Matrix4x4* output)
+{
+	const float* qx = rot.GetX(); const float* qy = rot.GetY(); const float* qz = rot.GetZ(); const float* qw = rot.GetW();
+
+	for (size_t i = 0, count = rot.GetCount(); i < count; ++i)
+	{
+		float* m = output[i].m_data;
+
+		// same products as QuaternionToMatrix
+		const float x = qx[i] * 2.0F, y = qy[i] * 2.0F, z = qz[i] * 2.0F;
+		const float xx = qx[i] * x, yy = qy[i] * y, zz = qz[i] * z;
+		const float xy = qx[i] * y, xz = qx[i] * z, yz = qy[i] * z;
+		const float wx = qw[i] * x, wy = qw[i] * y, wz = qw[i] * z;
+
+		const float sx = scale ? scale->GetX()[i] : 1.0F;
+		const float sy = scale ? scale->GetY()[i] : 1.0F;
+		const float sz = scale ? scale->GetZ()[i] : 1.0F;
+
+		m[0] = (1.0F - (yy + zz)) * sx;
+		m[1] = (xy + wz) * sx;
+		m[2] = (xz - wy) * sx;
+		m[3] = 0.0F;
+
+		m[4] = (xy - wz) * sy;
+		m[5] = (1.0F - (xx + zz)) * sy;
+		m[6] = (yz + wx) * sy;
+		m[7] = 0.0F;
+
+		m[8] = (xz + wy) * sz;
+		m[9] = (yz - wx) * sz;
+		m[10] = (1.0F - (xx + yy)) * sz;
+		m[11] = 0.0F;
+
+		m[12] = pos ? pos->GetX()[i] : 0.0F;
+		m[13] = pos ? pos->GetY()[i] : 0.0F;
+		m[14] = pos ? pos->GetZ()[i] : 0.0F;
+		m[15] = 1.0F;
+	}
+}
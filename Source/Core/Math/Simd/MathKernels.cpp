@@ -0,0 +1,185 @@
+#include "Core/Math/Simd/MathKernels.h"
+#include "Core/Misc/CPUInfo.h"
+
+MathKernels gMathKernels =
+{
+	&MultiplyMatrices4x4_Scalar,
+	&MultiplyMatrixArray4x4_Scalar,
+	&MultiplyMatrixArrayWithBase4x4_Scalar,
+	&LoadVector3Stream_Scalar,
+	&StoreVector3Stream_Scalar,
+	&TransformPointsStream3x3_Scalar,
+	&TransformPointsStream3x4_Scalar,
+	&SlerpQuaternionStream_Scalar,
+	&NormalizeQuaternionStream_Scalar,
+	&SetTRSStream_Scalar,
+	&InvertMatrix4x4_Rigid_Scalar,
+	&InvertMatrix4x4_UniformScale_Scalar,
+	&InvertMatrix4x4_Affine_Scalar,
+	&InvertMatrixArray4x4Affine_Scalar,
+	&CullAABBStream_Scalar,
+	&CullSphereStream_Scalar,
+};
+
+namespace
+{
+	SimdLevel gSimdLevel = kSimdScalar;
+
+	bool IsSimdLevelSupported(SimdLevel level)
+	{
+		switch (level)
+		{
+		case kSimdScalar: return true;
+		case kSimdSSE2: return HasCPUFeature(kCPUFeatureSSE2);
+		case kSimdAVX: return HasCPUFeature(kCPUFeatureSSE2 | kCPUFeatureAVX);
+		case kSimdFMA: return HasCPUFeature(kCPUFeatureSSE2 | kCPUFeatureAVX | kCPUFeatureFMA);
+		case kSimdNEON: return HasCPUFeature(kCPUFeatureNEON);
+		default: return false;
+		}
+	}
+
+	MathKernels GetKernels(SimdLevel level)
+	{
+		MathKernels kernels =
+		{
+			&MultiplyMatrices4x4_Scalar,
+			&MultiplyMatrixArray4x4_Scalar,
+			&MultiplyMatrixArrayWithBase4x4_Scalar,
+			&LoadVector3Stream_Scalar,
+			&StoreVector3Stream_Scalar,
+			&TransformPointsStream3x3_Scalar,
+			&TransformPointsStream3x4_Scalar,
+			&SlerpQuaternionStream_Scalar,
+			&NormalizeQuaternionStream_Scalar,
+			&SetTRSStream_Scalar,
+			&InvertMatrix4x4_Rigid_Scalar,
+			&InvertMatrix4x4_UniformScale_Scalar,
+			&InvertMatrix4x4_Affine_Scalar,
+			&InvertMatrixArray4x4Affine_Scalar,
+			&CullAABBStream_Scalar,
+			&CullSphereStream_Scalar,
+		};
+
+#if SIMD_X86
+		//the AVX levels only replace the kernels that have a 256 bit version, the rest
+		//(AoS shuffles, SetTRS, the inverses) is 4 wide by nature and stays SSE2
+		if (level == kSimdSSE2 || level == kSimdAVX || level == kSimdFMA)
+		{
+			kernels.multiplyMatrices4x4 = &MultiplyMatrices4x4_SSE2;
+			kernels.multiplyMatrixArray4x4 = &MultiplyMatrixArray4x4_SSE2;
+			kernels.multiplyMatrixArrayWithBase4x4 = &MultiplyMatrixArrayWithBase4x4_SSE2;
+			kernels.loadVector3Stream = &LoadVector3Stream_SSE2;
+			kernels.storeVector3Stream = &StoreVector3Stream_SSE2;
+			kernels.transformPointsStream3x3 = &TransformPointsStream3x3_SSE2;
+			kernels.transformPointsStream3x4 = &TransformPointsStream3x4_SSE2;
+			kernels.slerpQuaternionStream = &SlerpQuaternionStream_SSE2;
+			kernels.normalizeQuaternionStream = &NormalizeQuaternionStream_SSE2;
+			kernels.setTRSStream = &SetTRSStream_SSE2;
+			kernels.invertMatrix4x4Rigid = &InvertMatrix4x4_Rigid_SSE2;
+			kernels.invertMatrix4x4UniformScale = &InvertMatrix4x4_UniformScale_SSE2;
+			kernels.invertMatrix4x4Affine = &InvertMatrix4x4_Affine_SSE2;
+			kernels.invertMatrixArray4x4Affine = &InvertMatrixArray4x4Affine_SSE2;
+			kernels.cullAABBStream = &CullAABBStream_SSE2;
+			kernels.cullSphereStream = &CullSphereStream_SSE2;
+		}
+
+		if (level == kSimdAVX)
+		{
+			kernels.multiplyMatrices4x4 = &MultiplyMatrices4x4_AVX;
+			kernels.multiplyMatrixArray4x4 = &MultiplyMatrixArray4x4_AVX;
+			kernels.multiplyMatrixArrayWithBase4x4 = &MultiplyMatrixArrayWithBase4x4_AVX;
+			kernels.transformPointsStream3x3 = &TransformPointsStream3x3_AVX;
+			kernels.transformPointsStream3x4 = &TransformPointsStream3x4_AVX;
+		}
+		else if (level == kSimdFMA)
+		{
+			kernels.multiplyMatrices4x4 = &MultiplyMatrices4x4_FMA;
+			kernels.multiplyMatrixArray4x4 = &MultiplyMatrixArray4x4_FMA;
+			kernels.multiplyMatrixArrayWithBase4x4 = &MultiplyMatrixArrayWithBase4x4_FMA;
+			kernels.transformPointsStream3x3 = &TransformPointsStream3x3_FMA;
+			kernels.transformPointsStream3x4 = &TransformPointsStream3x4_FMA;
+		}
+
+		//no FMA version of these
+		if (level == kSimdAVX || level == kSimdFMA)
+		{
+			kernels.slerpQuaternionStream = &SlerpQuaternionStream_AVX;
+			kernels.normalizeQuaternionStream = &NormalizeQuaternionStream_AVX;
+			kernels.cullAABBStream = &CullAABBStream_AVX;
+			kernels.cullSphereStream = &CullSphereStream_AVX;
+		}
+#endif
+#if SIMD_NEON
+		if (level == kSimdNEON)
+		{
+			kernels.multiplyMatrices4x4 = &MultiplyMatrices4x4_NEON;
+			kernels.multiplyMatrixArray4x4 = &MultiplyMatrixArray4x4_NEON;
+			kernels.multiplyMatrixArrayWithBase4x4 = &MultiplyMatrixArrayWithBase4x4_NEON;
+			kernels.loadVector3Stream = &LoadVector3Stream_NEON;
+			kernels.storeVector3Stream = &StoreVector3Stream_NEON;
+			kernels.transformPointsStream3x3 = &TransformPointsStream3x3_NEON;
+			kernels.transformPointsStream3x4 = &TransformPointsStream3x4_NEON;
+			kernels.slerpQuaternionStream = &SlerpQuaternionStream_NEON;
+			kernels.normalizeQuaternionStream = &NormalizeQuaternionStream_NEON;
+			kernels.setTRSStream = &SetTRSStream_NEON;
+			kernels.invertMatrix4x4Rigid = &InvertMatrix4x4_Rigid_NEON;
+			kernels.invertMatrix4x4UniformScale = &InvertMatrix4x4_UniformScale_NEON;
+			kernels.invertMatrix4x4Affine = &InvertMatrix4x4_Affine_NEON;
+			kernels.invertMatrixArray4x4Affine = &InvertMatrixArray4x4Affine_NEON;
+			kernels.cullAABBStream = &CullAABBStream_NEON;
+			kernels.cullSphereStream = &CullSphereStream_NEON;
+		}
+#endif
+		return kernels;
+	}
+
+	//pick the best kernels before main
+	const SimdLevel kStartupSimdLevel = SetSimdLevel(GetSupportedSimdLevel());
+}
+
+SimdLevel GetSupportedSimdLevel(void)
+{
+#if SIMD_X86
+	if (IsSimdLevelSupported(kSimdFMA))
+		return kSimdFMA;
+	if (IsSimdLevelSupported(kSimdAVX))
+		return kSimdAVX;
+	if (IsSimdLevelSupported(kSimdSSE2))
+		return kSimdSSE2;
+#elif SIMD_NEON
+	if (IsSimdLevelSupported(kSimdNEON))
+		return kSimdNEON;
+#endif
+	return kSimdScalar;
+}
+
+SimdLevel GetSimdLevel(void)
+{
+	return gSimdLevel;
+}
+
+SimdLevel SetSimdLevel(SimdLevel level)
+{
+#if !SIMD_X86
+	if (level == kSimdSSE2 || level == kSimdAVX || level == kSimdFMA)
+		level = kSimdScalar;
+#endif
+#if !SIMD_NEON
+	if (level == kSimdNEON)
+		level = kSimdScalar;
+#endif
+	if (!IsSimdLevelSupported(level))
+		level = kSimdScalar;
+
+	gMathKernels = GetKernels(level);
+	gSimdLevel = level;
+	return level;
+}
+
+const char* GetSimdLevelName(SimdLevel level)
+{
+	static const char* names[kSimdLevelCount] = { "Scalar", "SSE2", "AVX", "AVX+FMA", "NEON" };
+	if (level < 0 || level >= kSimdLevelCount)
+		return "Unknown";
+	return names[level];
+}
@@ -0,0 +1,439 @@
+#include "Core/Math/Simd/MathKernelsAVX.h"
+
+#if SIMD_X86
+
+#include <immintrin.h>
+#include "Core/Math/Simd/CullWriter.h"
+
+/*
+	AVX and AVX+FMA kernels
+	Two result columns are computed per 256 bit register: lhs columns are
+	duplicated into both lanes, the rhs column pair is splatted per lane.
+	Only called after CPUInfo reported AVX (and FMA for the _FMA versions).
+	No shared header besides MathKernelsAVX.h, see there.
+*/
+
+#define SPLAT_LANES(v, i) _mm256_shuffle_ps((v), (v), _MM_SHUFFLE(i, i, i, i))
+
+namespace
+{
+	//each column duplicated into both 128 bit lanes
+	struct LaneColumns
+	{
+		__m256 c0, c1, c2, c3;
+	};
+
+	//columns packed pairwise, {c0|c1} {c2|c3}
+	struct PairColumns
+	{
+		__m256 c01, c23;
+	};
+
+	SIMD_TARGET_AVX SIMD_FORCE_INLINE LaneColumns LoadLaneColumns(const float* m)
+	{
+		LaneColumns res;
+		res.c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 0));
+		res.c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4));
+		res.c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8));
+		res.c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12));
+		return res;
+	}
+
+	SIMD_TARGET_AVX SIMD_FORCE_INLINE LaneColumns ToLaneColumns(const PairColumns& m)
+	{
+		LaneColumns res;
+		res.c0 = _mm256_permute2f128_ps(m.c01, m.c01, 0x00);
+		res.c1 = _mm256_permute2f128_ps(m.c01, m.c01, 0x11);
+		res.c2 = _mm256_permute2f128_ps(m.c23, m.c23, 0x00);
+		res.c3 = _mm256_permute2f128_ps(m.c23, m.c23, 0x11);
+		return res;
+	}
+
+	SIMD_TARGET_AVX SIMD_FORCE_INLINE PairColumns LoadPairColumns(const float* m)
+	{
+		PairColumns res;
+		res.c01 = _mm256_loadu_ps(m + 0);
+		res.c23 = _mm256_loadu_ps(m + 8);
+		return res;
+	}
+
+	SIMD_TARGET_AVX SIMD_FORCE_INLINE void StorePairColumns(const PairColumns& m, float* out)
+	{
+		_mm256_storeu_ps(out + 0, m.c01);
+		_mm256_storeu_ps(out + 8, m.c23);
+	}
+
+	// lhs * {column pair}
+	SIMD_TARGET_AVX SIMD_FORCE_INLINE __m256 Combine_AVX(const LaneColumns& lhs, __m256 columns)
+	{
+		__m256 r0 = _mm256_mul_ps(lhs.c0, SPLAT_LANES(columns, 0));
+		__m256 r1 = _mm256_mul_ps(lhs.c1, SPLAT_LANES(columns, 1));
+		r0 = _mm256_add_ps(r0, _mm256_mul_ps(lhs.c2, SPLAT_LANES(columns, 2)));
+		r1 = _mm256_add_ps(r1, _mm256_mul_ps(lhs.c3, SPLAT_LANES(columns, 3)));
+		return _mm256_add_ps(r0, r1);
+	}
+
+	SIMD_TARGET_FMA SIMD_FORCE_INLINE __m256 Combine_FMA(const LaneColumns& lhs, __m256 columns)
+	{
+		__m256 r0 = _mm256_mul_ps(lhs.c0, SPLAT_LANES(columns, 0));
+		__m256 r1 = _mm256_mul_ps(lhs.c1, SPLAT_LANES(columns, 1));
+		r0 = _mm256_fmadd_ps(lhs.c2, SPLAT_LANES(columns, 2), r0);
+		r1 = _mm256_fmadd_ps(lhs.c3, SPLAT_LANES(columns, 3), r1);
+		return _mm256_add_ps(r0, r1);
+	}
+
+	SIMD_TARGET_AVX SIMD_FORCE_INLINE PairColumns Multiply_AVX(const LaneColumns& lhs, const PairColumns& rhs)
+	{
+		PairColumns res;
+		res.c01 = Combine_AVX(lhs, rhs.c01);
+		res.c23 = Combine_AVX(lhs, rhs.c23);
+		return res;
+	}
+
+	SIMD_TARGET_FMA SIMD_FORCE_INLINE PairColumns Multiply_FMA(const LaneColumns& lhs, const PairColumns& rhs)
+	{
+		PairColumns res;
+		res.c01 = Combine_FMA(lhs, rhs.c01);
+		res.c23 = Combine_FMA(lhs, rhs.c23);
+		return res;
+	}
+
+	//matrix index ahead of m
+	SIMD_TARGET_AVX SIMD_FORCE_INLINE void Prefetch(const float* m, size_t index)
+	{
+		_mm_prefetch(reinterpret_cast<const char*>(m + index * 16), _MM_HINT_T0);
+	}
+}
+
+/* AVX */
+
+SIMD_TARGET_AVX void AVXKernels::MultiplyMatrices4x4_AVX(const float* __restrict lhs, const float* __restrict rhs, float* __restrict res)
+{
+	StorePairColumns(Multiply_AVX(LoadLaneColumns(lhs), LoadPairColumns(rhs)), res);
+}
+
+SIMD_TARGET_AVX void AVXKernels::MultiplyMatrixArray4x4_AVX(const float* __restrict a, const float* __restrict b, float* __restrict res, size_t count)
+{
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		Prefetch(a, i + SIMD_PREFETCH_DISTANCE);
+		Prefetch(b, i + SIMD_PREFETCH_DISTANCE);
+
+		PairColumns r0 = Multiply_AVX(LoadLaneColumns(a + i * 16), LoadPairColumns(b + i * 16));
+		PairColumns r1 = Multiply_AVX(LoadLaneColumns(a + (i + 1) * 16), LoadPairColumns(b + (i + 1) * 16));
+		StorePairColumns(r0, res + i * 16);
+		StorePairColumns(r1, res + (i + 1) * 16);
+	}
+
+	for (; i < count; ++i)
+		StorePairColumns(Multiply_AVX(LoadLaneColumns(a + i * 16), LoadPairColumns(b + i * 16)), res + i * 16);
+}
+
+SIMD_TARGET_AVX void AVXKernels::MultiplyMatrixArrayWithBase4x4_AVX(const float* __restrict base,
+	const float* __restrict a, const float* __restrict b, float* __restrict res, size_t count)
+{
+	const LaneColumns baseColumns = LoadLaneColumns(base);
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		Prefetch(a, i + SIMD_PREFETCH_DISTANCE);
+		Prefetch(b, i + SIMD_PREFETCH_DISTANCE);
+
+		PairColumns t0 = Multiply_AVX(baseColumns, LoadPairColumns(a + i * 16));
+		PairColumns t1 = Multiply_AVX(baseColumns, LoadPairColumns(a + (i + 1) * 16));
+		StorePairColumns(Multiply_AVX(ToLaneColumns(t0), LoadPairColumns(b + i * 16)), res + i * 16);
+		StorePairColumns(Multiply_AVX(ToLaneColumns(t1), LoadPairColumns(b + (i + 1) * 16)), res + (i + 1) * 16);
+	}
+
+	for (; i < count; ++i)
+	{
+		PairColumns t = Multiply_AVX(baseColumns, LoadPairColumns(a + i * 16));
+		StorePairColumns(Multiply_AVX(ToLaneColumns(t), LoadPairColumns(b + i * 16)), res + i * 16);
+	}
+}
+
+/* AVX + FMA */
+
+SIMD_TARGET_FMA void AVXKernels::MultiplyMatrices4x4_FMA(const float* __restrict lhs, const float* __restrict rhs, float* __restrict res)
+{
+	StorePairColumns(Multiply_FMA(LoadLaneColumns(lhs), LoadPairColumns(rhs)), res);
+}
+
+SIMD_TARGET_FMA void AVXKernels::MultiplyMatrixArray4x4_FMA(const float* __restrict a, const float* __restrict b, float* __restrict res, size_t count)
+{
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		Prefetch(a, i + SIMD_PREFETCH_DISTANCE);
+		Prefetch(b, i + SIMD_PREFETCH_DISTANCE);
+
+		PairColumns r0 = Multiply_FMA(LoadLaneColumns(a + i * 16), LoadPairColumns(b + i * 16));
+		PairColumns r1 = Multiply_FMA(LoadLaneColumns(a + (i + 1) * 16), LoadPairColumns(b + (i + 1) * 16));
+		StorePairColumns(r0, res + i * 16);
+		StorePairColumns(r1, res + (i + 1) * 16);
+	}
+
+	for (; i < count; ++i)
+		StorePairColumns(Multiply_FMA(LoadLaneColumns(a + i * 16), LoadPairColumns(b + i * 16)), res + i * 16);
+}
+
+SIMD_TARGET_FMA void AVXKernels::MultiplyMatrixArrayWithBase4x4_FMA(const float* __restrict base,
+	const float* __restrict a, const float* __restrict b, float* __restrict res, size_t count)
+{
+	const LaneColumns baseColumns = LoadLaneColumns(base);
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		Prefetch(a, i + SIMD_PREFETCH_DISTANCE);
+		Prefetch(b, i + SIMD_PREFETCH_DISTANCE);
+
+		PairColumns t0 = Multiply_FMA(baseColumns, LoadPairColumns(a + i * 16));
+		PairColumns t1 = Multiply_FMA(baseColumns, LoadPairColumns(a + (i + 1) * 16));
+		StorePairColumns(Multiply_FMA(ToLaneColumns(t0), LoadPairColumns(b + i * 16)), res + i * 16);
+		StorePairColumns(Multiply_FMA(ToLaneColumns(t1), LoadPairColumns(b + (i + 1) * 16)), res + (i + 1) * 16);
+	}
+
+	for (; i < count; ++i)
+	{
+		PairColumns t = Multiply_FMA(baseColumns, LoadPairColumns(a + i * 16));
+		StorePairColumns(Multiply_FMA(ToLaneColumns(t), LoadPairColumns(b + i * 16)), res + i * 16);
+	}
+}
+
+/* Vector3Stream */
+
+namespace
+{
+	SIMD_TARGET_AVX SIMD_FORCE_INLINE __m256 MultiplyAdd_AVX(__m256 a, __m256 b, __m256 c)
+	{
+		return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+	}
+
+	SIMD_TARGET_FMA SIMD_FORCE_INLINE __m256 MultiplyAdd_FMA(__m256 a, __m256 b, __m256 c)
+	{
+		return _mm256_fmadd_ps(a, b, c);
+	}
+}
+
+//8 points per iteration, streams are padded to 8 floats
+#define TRANSFORM_POINTS_STREAM(MADD, TRANSLATE) \
+	const float* m = matrix; \
+	const __m256 m0 = _mm256_set1_ps(m[0]), m1 = _mm256_set1_ps(m[1]), m2 = _mm256_set1_ps(m[2]); \
+	const __m256 m4 = _mm256_set1_ps(m[4]), m5 = _mm256_set1_ps(m[5]), m6 = _mm256_set1_ps(m[6]); \
+	const __m256 m8 = _mm256_set1_ps(m[8]), m9 = _mm256_set1_ps(m[9]), m10 = _mm256_set1_ps(m[10]); \
+	const __m256 tx = _mm256_set1_ps((TRANSLATE) ? m[12] : 0.0F); \
+	const __m256 ty = _mm256_set1_ps((TRANSLATE) ? m[13] : 0.0F); \
+	const __m256 tz = _mm256_set1_ps((TRANSLATE) ? m[14] : 0.0F); \
+	const float* inX = input.x; \
+	const float* inY = input.y; \
+	const float* inZ = input.z; \
+	float* outX = output.x; \
+	float* outY = output.y; \
+	float* outZ = output.z; \
+	for (size_t i = 0; i < paddedCount; i += 8) \
+	{ \
+		const __m256 x = _mm256_load_ps(inX + i); \
+		const __m256 y = _mm256_load_ps(inY + i); \
+		const __m256 z = _mm256_load_ps(inZ + i); \
+		_mm256_store_ps(outX + i, MADD(m0, x, MADD(m4, y, MADD(m8, z, tx)))); \
+		_mm256_store_ps(outY + i, MADD(m1, x, MADD(m5, y, MADD(m9, z, ty)))); \
+		_mm256_store_ps(outZ + i, MADD(m2, x, MADD(m6, y, MADD(m10, z, tz)))); \
+	}
+
+SIMD_TARGET_AVX void AVXKernels::TransformPointsStream_AVX(const float* matrix, bool translate, const StreamIn& input, const StreamOut& output, size_t paddedCount)
+{
+	TRANSFORM_POINTS_STREAM(MultiplyAdd_AVX, translate)
+}
+
+SIMD_TARGET_FMA void AVXKernels::TransformPointsStream_FMA(const float* matrix, bool translate, const StreamIn& input, const StreamOut& output, size_t paddedCount)
+{
+	TRANSFORM_POINTS_STREAM(MultiplyAdd_FMA, translate)
+}
+
+#undef TRANSFORM_POINTS_STREAM
+
+/* QuaternionStream, same math as the SSE2 versions 8 lanes wide */
+
+namespace
+{
+	SIMD_TARGET_AVX SIMD_FORCE_INLINE __m256 InvSqrt_AVX(__m256 v)
+	{
+		const __m256 r = _mm256_rsqrt_ps(v);
+		const __m256 rvr = _mm256_mul_ps(_mm256_mul_ps(v, r), r);
+		return _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5F), r), _mm256_sub_ps(_mm256_set1_ps(3.0F), rvr));
+	}
+
+	SIMD_TARGET_AVX SIMD_FORCE_INLINE void NormalizeSafe_AVX(__m256& x, __m256& y, __m256& z, __m256& w, __m256 sqrEpsilon)
+	{
+		const __m256 sqrMag = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_add_ps(_mm256_mul_ps(z, z), _mm256_mul_ps(w, w)));
+		const __m256 valid = _mm256_cmp_ps(sqrMag, sqrEpsilon, _CMP_GE_OQ);
+		const __m256 invMag = _mm256_and_ps(InvSqrt_AVX(sqrMag), valid);
+		x = _mm256_mul_ps(x, invMag);
+		y = _mm256_mul_ps(y, invMag);
+		z = _mm256_mul_ps(z, invMag);
+		w = _mm256_blendv_ps(_mm256_set1_ps(1.0F), _mm256_mul_ps(w, invMag), valid);
+	}
+
+	SIMD_TARGET_AVX SIMD_FORCE_INLINE __m256 LoadWeights_AVX(const float* t, size_t tStep, size_t i, size_t count)
+	{
+		if (tStep == 0)
+			return _mm256_set1_ps(*t);
+		if (i + 8 <= count)
+			return _mm256_loadu_ps(t + i);
+
+		float tail[8] = { 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F };
+		for (size_t k = i; k < count; ++k)
+			tail[k - i] = t[k];
+		return _mm256_loadu_ps(tail);
+	}
+}
+
+SIMD_TARGET_AVX void AVXKernels::SlerpQuaternionStream_AVX(const StreamIn& a, const StreamIn& b, const float* t, size_t tStep, const StreamOut& output, size_t count, size_t paddedCount, float epsilon)
+{
+	const __m256 sqrEpsilon = _mm256_set1_ps(epsilon * epsilon);
+	const __m256 signMask = _mm256_set1_ps(-0.0F);
+	const __m256 one = _mm256_set1_ps(1.0F);
+	const __m256 half = _mm256_set1_ps(0.5F);
+
+	for (size_t i = 0; i < paddedCount; i += 8)
+	{
+		const __m256 ax = _mm256_load_ps(a.x + i), ay = _mm256_load_ps(a.y + i), az = _mm256_load_ps(a.z + i), aw = _mm256_load_ps(a.w + i);
+		const __m256 bx = _mm256_load_ps(b.x + i), by = _mm256_load_ps(b.y + i), bz = _mm256_load_ps(b.z + i), bw = _mm256_load_ps(b.w + i);
+		const __m256 ti = LoadWeights_AVX(t, tStep, i, count);
+
+		const __m256 cosAngle = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax, bx), _mm256_mul_ps(ay, by)), _mm256_add_ps(_mm256_mul_ps(az, bz), _mm256_mul_ps(aw, bw)));
+		const __m256 d = _mm256_andnot_ps(signMask, cosAngle);
+
+		__m256 k0 = _mm256_sub_ps(_mm256_set1_ps(3.55645F), _mm256_mul_ps(d, _mm256_set1_ps(1.43519F)));
+		k0 = _mm256_add_ps(_mm256_set1_ps(-3.2452F), _mm256_mul_ps(d, k0));
+		k0 = _mm256_add_ps(_mm256_set1_ps(1.0904F), _mm256_mul_ps(d, k0));
+		__m256 k1 = _mm256_add_ps(_mm256_set1_ps(-1.06021F), _mm256_mul_ps(d, _mm256_set1_ps(0.215638F)));
+		k1 = _mm256_add_ps(_mm256_set1_ps(0.848013F), _mm256_mul_ps(d, k1));
+
+		const __m256 tc = _mm256_sub_ps(ti, half);
+		const __m256 k = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(k0, tc), tc), k1);
+		const __m256 ot = _mm256_add_ps(ti, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(ti, tc), _mm256_sub_ps(ti, one)), k));
+		const __m256 lt = _mm256_sub_ps(one, ot);
+		const __m256 rt = _mm256_xor_ps(ot, _mm256_and_ps(cosAngle, signMask));
+
+		__m256 x = _mm256_add_ps(_mm256_mul_ps(ax, lt), _mm256_mul_ps(bx, rt));
+		__m256 y = _mm256_add_ps(_mm256_mul_ps(ay, lt), _mm256_mul_ps(by, rt));
+		__m256 z = _mm256_add_ps(_mm256_mul_ps(az, lt), _mm256_mul_ps(bz, rt));
+		__m256 w = _mm256_add_ps(_mm256_mul_ps(aw, lt), _mm256_mul_ps(bw, rt));
+		NormalizeSafe_AVX(x, y, z, w, sqrEpsilon);
+
+		_mm256_store_ps(output.x + i, x);
+		_mm256_store_ps(output.y + i, y);
+		_mm256_store_ps(output.z + i, z);
+		_mm256_store_ps(output.w + i, w);
+	}
+}
+
+SIMD_TARGET_AVX void AVXKernels::NormalizeQuaternionStream_AVX(const StreamIn& input, const StreamOut& output, size_t paddedCount, float epsilon)
+{
+	const __m256 sqrEpsilon = _mm256_set1_ps(epsilon * epsilon);
+
+	for (size_t i = 0; i < paddedCount; i += 8)
+	{
+		__m256 x = _mm256_load_ps(input.x + i);
+		__m256 y = _mm256_load_ps(input.y + i);
+		__m256 z = _mm256_load_ps(input.z + i);
+		__m256 w = _mm256_load_ps(input.w + i);
+		NormalizeSafe_AVX(x, y, z, w, sqrEpsilon);
+		_mm256_store_ps(output.x + i, x);
+		_mm256_store_ps(output.y + i, y);
+		_mm256_store_ps(output.z + i, z);
+		_mm256_store_ps(output.w + i, w);
+	}
+}
+
+/* Culling, see the SSE2 versions */
+
+namespace
+{
+	struct CullPlanes_AVX
+	{
+		__m256 nx[AVXKernels::kPlaneCount], ny[AVXKernels::kPlaneCount], nz[AVXKernels::kPlaneCount], d[AVXKernels::kPlaneCount];
+		__m256 ax[AVXKernels::kPlaneCount], ay[AVXKernels::kPlaneCount], az[AVXKernels::kPlaneCount];
+	};
+
+	SIMD_TARGET_AVX SIMD_FORCE_INLINE void LoadCullPlanes_AVX(const float* planes, CullPlanes_AVX& p)
+	{
+		const __m256 signMask = _mm256_set1_ps(-0.0F);
+		for (int k = 0; k < AVXKernels::kPlaneCount; ++k)
+		{
+			p.nx[k] = _mm256_set1_ps(planes[k * 4 + 0]);
+			p.ny[k] = _mm256_set1_ps(planes[k * 4 + 1]);
+			p.nz[k] = _mm256_set1_ps(planes[k * 4 + 2]);
+			p.d[k] = _mm256_set1_ps(planes[k * 4 + 3]);
+			p.ax[k] = _mm256_andnot_ps(signMask, p.nx[k]);
+			p.ay[k] = _mm256_andnot_ps(signMask, p.ny[k]);
+			p.az[k] = _mm256_andnot_ps(signMask, p.nz[k]);
+		}
+	}
+
+	SIMD_TARGET_AVX SIMD_FORCE_INLINE __m256 LoadRadii_AVX(const float* radii, size_t i, size_t count)
+	{
+		if (i + 8 <= count)
+			return _mm256_loadu_ps(radii + i);
+
+		float tail[8] = { 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F };
+		for (size_t k = i; k < count; ++k)
+			tail[k - i] = radii[k];
+		return _mm256_loadu_ps(tail);
+	}
+}
+
+SIMD_TARGET_AVX size_t AVXKernels::CullAABBStream_AVX(const float* planes, const StreamIn& centers, const StreamIn& extents, size_t count, uint32_t* mask, uint32_t* indices)
+{
+	CullPlanes_AVX p;
+	LoadCullPlanes_AVX(planes, p);
+	const __m256 zero = _mm256_setzero_ps();
+
+	CullWriter writer(mask, indices);
+	for (size_t i = 0; i < count; i += 8)
+	{
+		const __m256 cx = _mm256_load_ps(centers.x + i), cy = _mm256_load_ps(centers.y + i), cz = _mm256_load_ps(centers.z + i);
+		const __m256 ex = _mm256_load_ps(extents.x + i), ey = _mm256_load_ps(extents.y + i), ez = _mm256_load_ps(extents.z + i);
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (int k = 0; k < kPlaneCount; ++k)
+		{
+			const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p.nx[k], cx), _mm256_mul_ps(p.ny[k], cy)), _mm256_add_ps(_mm256_mul_ps(p.nz[k], cz), p.d[k]));
+			const __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p.ax[k], ex), _mm256_mul_ps(p.ay[k], ey)), _mm256_mul_ps(p.az[k], ez));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+		}
+
+		writer.Write(_mm256_movemask_ps(inside) & CullWriter::LaneMask(i, count, 8), i, 8);
+	}
+	return writer.Finish();
+}
+
+SIMD_TARGET_AVX size_t AVXKernels::CullSphereStream_AVX(const float* planes, const StreamIn& centers, const float* radii, size_t count, uint32_t* mask, uint32_t* indices)
+{
+	CullPlanes_AVX p;
+	LoadCullPlanes_AVX(planes, p);
+	const __m256 zero = _mm256_setzero_ps();
+
+	CullWriter writer(mask, indices);
+	for (size_t i = 0; i < count; i += 8)
+	{
+		const __m256 cx = _mm256_load_ps(centers.x + i), cy = _mm256_load_ps(centers.y + i), cz = _mm256_load_ps(centers.z + i);
+		const __m256 r = LoadRadii_AVX(radii, i, count);
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (int k = 0; k < kPlaneCount; ++k)
+		{
+			const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p.nx[k], cx), _mm256_mul_ps(p.ny[k], cy)), _mm256_add_ps(_mm256_mul_ps(p.nz[k], cz), p.d[k]));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, r), zero, _CMP_GE_OQ));
+		}
+
+		writer.Write(_mm256_movemask_ps(inside) & CullWriter::LaneMask(i, count, 8), i, 8);
+	}
+	return writer.Finish();
+}
+
+#undef SPLAT_LANES
+
+#endif
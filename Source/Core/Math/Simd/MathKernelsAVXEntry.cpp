@@ -0,0 +1,122 @@
+#include "Core/Math/Simd/MathKernels.h"
+
+#if SIMD_X86
+
+#include "Core/Math/Simd/MathKernelsAVX.h"
+#include "Core/Math/Matrix4x4.h"
+#include "Core/Math/Vector3Stream.h"
+#include "Core/Math/QuaternionStream.h"
+#include "Core/Math/Frustum.h"
+
+/*
+	_AVX / _FMA entries of MathKernels.h
+	Built like any other file, it only hands plain arrays to MathKernelsAVX.cpp.
+*/
+
+//matrix arrays are handed over as float arrays
+static_assert(sizeof(Matrix4x4) == 16 * sizeof(float), "AVX kernels expect packed 4x4 float matrices");
+static_assert(sizeof(Vector4) == 4 * sizeof(float), "AVX kernels expect planes as float quads");
+static_assert(Frustum::kPlaneCount == AVXKernels::kPlaneCount, "AVX kernels expect 6 frustum planes");
+
+namespace
+{
+	AVXKernels::StreamIn GetStreamIn(const Vector3Stream& stream)
+	{
+		AVXKernels::StreamIn res = { stream.GetX(), stream.GetY(), stream.GetZ(), nullptr };
+		return res;
+	}
+
+	AVXKernels::StreamOut GetStreamOut(Vector3Stream& stream)
+	{
+		AVXKernels::StreamOut res = { stream.GetX(), stream.GetY(), stream.GetZ(), nullptr };
+		return res;
+	}
+
+	AVXKernels::StreamIn GetStreamIn(const QuaternionStream& stream)
+	{
+		AVXKernels::StreamIn res = { stream.GetX(), stream.GetY(), stream.GetZ(), stream.GetW() };
+		return res;
+	}
+
+	AVXKernels::StreamOut GetStreamOut(QuaternionStream& stream)
+	{
+		AVXKernels::StreamOut res = { stream.GetX(), stream.GetY(), stream.GetZ(), stream.GetW() };
+		return res;
+	}
+}
+
+/* AVX */
+
+void MultiplyMatrices4x4_AVX(const Matrix4x4* __restrict lhs, const Matrix4x4* __restrict rhs, Matrix4x4* __restrict res)
+{
+	AVXKernels::MultiplyMatrices4x4_AVX(lhs->m_data, rhs->m_data, res->m_data);
+}
+
+void MultiplyMatrixArray4x4_AVX(const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB, Matrix4x4* __restrict arrayRes, size_t count)
+{
+	AVXKernels::MultiplyMatrixArray4x4_AVX(reinterpret_cast<const float*>(arrayA), reinterpret_cast<const float*>(arrayB), reinterpret_cast<float*>(arrayRes), count);
+}
+
+void MultiplyMatrixArrayWithBase4x4_AVX(const Matrix4x4* __restrict base, const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB, Matrix4x4* __restrict arrayRes, size_t count)
+{
+	AVXKernels::MultiplyMatrixArrayWithBase4x4_AVX(base->m_data, reinterpret_cast<const float*>(arrayA), reinterpret_cast<const float*>(arrayB), reinterpret_cast<float*>(arrayRes), count);
+}
+
+void TransformPointsStream3x3_AVX(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output)
+{
+	AVXKernels::TransformPointsStream_AVX(matrix.m_data, false, GetStreamIn(input), GetStreamOut(output), input.GetPaddedCount());
+}
+
+void TransformPointsStream3x4_AVX(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output)
+{
+	AVXKernels::TransformPointsStream_AVX(matrix.m_data, true, GetStreamIn(input), GetStreamOut(output), input.GetPaddedCount());
+}
+
+void SlerpQuaternionStream_AVX(const QuaternionStream& a, const QuaternionStream& b, const float* t, size_t tStep, QuaternionStream& output)
+{
+	AVXKernels::SlerpQuaternionStream_AVX(GetStreamIn(a), GetStreamIn(b), t, tStep, GetStreamOut(output), a.GetCount(), a.GetPaddedCount(), Vector3::epsilon);
+}
+
+void NormalizeQuaternionStream_AVX(const QuaternionStream& input, QuaternionStream& output)
+{
+	AVXKernels::NormalizeQuaternionStream_AVX(GetStreamIn(input), GetStreamOut(output), input.GetPaddedCount(), Vector3::epsilon);
+}
+
+size_t CullAABBStream_AVX(const Vector4* planes, const Vector3Stream& centers, const Vector3Stream& extents, uint32_t* mask, uint32_t* indices)
+{
+	return AVXKernels::CullAABBStream_AVX(&planes->X, GetStreamIn(centers), GetStreamIn(extents), centers.GetCount(), mask, indices);
+}
+
+size_t CullSphereStream_AVX(const Vector4* planes, const Vector3Stream& centers, const float* radii, uint32_t* mask, uint32_t* indices)
+{
+	return AVXKernels::CullSphereStream_AVX(&planes->X, GetStreamIn(centers), radii, centers.GetCount(), mask, indices);
+}
+
+/* AVX + FMA */
+
+void MultiplyMatrices4x4_FMA(const Matrix4x4* __restrict lhs, const Matrix4x4* __restrict rhs, Matrix4x4* __restrict res)
+{
+	AVXKernels::MultiplyMatrices4x4_FMA(lhs->m_data, rhs->m_data, res->m_data);
+}
+
+void MultiplyMatrixArray4x4_FMA(const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB, Matrix4x4* __restrict arrayRes, size_t count)
+{
+	AVXKernels::MultiplyMatrixArray4x4_FMA(reinterpret_cast<const float*>(arrayA), reinterpret_cast<const float*>(arrayB), reinterpret_cast<float*>(arrayRes), count);
+}
+
+void MultiplyMatrixArrayWithBase4x4_FMA(const Matrix4x4* __restrict base, const Matrix4x4* __restrict arrayA, const Matrix4x4* __restrict arrayB, Matrix4x4* __restrict arrayRes, size_t count)
+{
+	AVXKernels::MultiplyMatrixArrayWithBase4x4_FMA(base->m_data, reinterpret_cast<const float*>(arrayA), reinterpret_cast<const float*>(arrayB), reinterpret_cast<float*>(arrayRes), count);
+}
+
+void TransformPointsStream3x3_FMA(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output)
+{
+	AVXKernels::TransformPointsStream_FMA(matrix.m_data, false, GetStreamIn(input), GetStreamOut(output), input.GetPaddedCount());
+}
+
+void TransformPointsStream3x4_FMA(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output)
+{
+	AVXKernels::TransformPointsStream_FMA(matrix.m_data, true, GetStreamIn(input), GetStreamOut(output), input.GetPaddedCount());
+}
+
+#endif
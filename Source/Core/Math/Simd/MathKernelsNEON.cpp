@@ -0,0 +1,662 @@
+#include "Core/Math/Simd/MathKernels.h"
+
+#if SIMD_NEON
+
+#include <arm_neon.h>
+#include "Core/Math/Matrix4x4.h"
+#include "Core/Math/Vector3Stream.h"
+#include "Core/Math/QuaternionStream.h"
+#include "Core/Math/Frustum.h"
+#include "Core/Math/Simd/CullWriter.h"
+
+/*
+	NEON kernels, ARMv7 with NEON and AArch64
+	Lane multiply-accumulate keeps the rhs column in one register, no splats needed
+*/
+
+namespace
+{
+	struct Columns
+	{
+		float32x4_t c0, c1, c2, c3;
+	};
+
+	SIMD_FORCE_INLINE Columns LoadColumns(const float* m)
+	{
+		Columns res;
+		res.c0 = vld1q_f32(m + 0);
+		res.c1 = vld1q_f32(m + 4);
+		res.c2 = vld1q_f32(m + 8);
+		res.c3 = vld1q_f32(m + 12);
+		return res;
+	}
+
+	SIMD_FORCE_INLINE void StoreColumns(const Columns& m, float* out)
+	{
+		vst1q_f32(out + 0, m.c0);
+		vst1q_f32(out + 4, m.c1);
+		vst1q_f32(out + 8, m.c2);
+		vst1q_f32(out + 12, m.c3);
+	}
+
+	// lhs * column
+	SIMD_FORCE_INLINE float32x4_t Combine(const Columns& lhs, float32x4_t column)
+	{
+		const float32x2_t low = vget_low_f32(column);
+		const float32x2_t high = vget_high_f32(column);
+		float32x4_t r0 = vmulq_lane_f32(lhs.c0, low, 0);
+		float32x4_t r1 = vmulq_lane_f32(lhs.c1, low, 1);
+		r0 = vmlaq_lane_f32(r0, lhs.c2, high, 0);
+		r1 = vmlaq_lane_f32(r1, lhs.c3, high, 1);
+		return vaddq_f32(r0, r1);
+	}
+
+	SIMD_FORCE_INLINE Columns Multiply(const Columns& lhs, const Columns& rhs)
+	{
+		Columns res;
+		res.c0 = Combine(lhs, rhs.c0);
+		res.c1 = Combine(lhs, rhs.c1);
+		res.c2 = Combine(lhs, rhs.c2);
+		res.c3 = Combine(lhs, rhs.c3);
+		return res;
+	}
+
+	SIMD_FORCE_INLINE void Prefetch(const Matrix4x4* m)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(m);
+#endif
+	}
+}
+
+void MultiplyMatrices4x4_NEON(const Matrix4x4* __restrict lhs, const Matrix4x4* __restrict rhs, Matrix4x4* __restrict res)
+{
+	StoreColumns(Multiply(LoadColumns(lhs->m_data), LoadColumns(rhs->m_data)), res->m_data);
+}
+
+void MultiplyMatrixArray4x4_NEON(const Matrix4x4* __restrict a, const Matrix4x4* __restrict b, Matrix4x4* __restrict res, size_t count)
+{
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		Prefetch(a + i + SIMD_PREFETCH_DISTANCE);
+		Prefetch(b + i + SIMD_PREFETCH_DISTANCE);
+
+		Columns r0 = Multiply(LoadColumns(a[i].m_data), LoadColumns(b[i].m_data));
+		Columns r1 = Multiply(LoadColumns(a[i + 1].m_data), LoadColumns(b[i + 1].m_data));
+		StoreColumns(r0, res[i].m_data);
+		StoreColumns(r1, res[i + 1].m_data);
+	}
+
+	for (; i < count; ++i)
+		StoreColumns(Multiply(LoadColumns(a[i].m_data), LoadColumns(b[i].m_data)), res[i].m_data);
+}
+
+void MultiplyMatrixArrayWithBase4x4_NEON(const Matrix4x4* __restrict base,
+	const Matrix4x4* __restrict a, const Matrix4x4* __restrict b, Matrix4x4* __restrict res, size_t count)
+{
+	const Columns baseColumns = LoadColumns(base->m_data);
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		Prefetch(a + i + SIMD_PREFETCH_DISTANCE);
+		Prefetch(b + i + SIMD_PREFETCH_DISTANCE);
+
+		Columns t0 = Multiply(baseColumns, LoadColumns(a[i].m_data));
+		Columns t1 = Multiply(baseColumns, LoadColumns(a[i + 1].m_data));
+		StoreColumns(Multiply(t0, LoadColumns(b[i].m_data)), res[i].m_data);
+		StoreColumns(Multiply(t1, LoadColumns(b[i + 1].m_data)), res[i + 1].m_data);
+	}
+
+	for (; i < count; ++i)
+	{
+		Columns t = Multiply(baseColumns, LoadColumns(a[i].m_data));
+		StoreColumns(Multiply(t, LoadColumns(b[i].m_data)), res[i].m_data);
+	}
+}
+
+/* Vector3Stream */
+
+void LoadVector3Stream_NEON(const Vector3* input, float* x, float* y, float* z, size_t count)
+{
+	//an empty stream may have no array at all
+	if (count == 0)
+		return;
+
+	const float* src = input->GetPtr();
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4, src += 12)
+	{
+		//vld3 de-interleaves x y z in one go
+		const float32x4x3_t xyz = vld3q_f32(src);
+		vst1q_f32(x + i, xyz.val[0]);
+		vst1q_f32(y + i, xyz.val[1]);
+		vst1q_f32(z + i, xyz.val[2]);
+	}
+
+	for (; i < count; ++i)
+	{
+		x[i] = input[i].X;
+		y[i] = input[i].Y;
+		z[i] = input[i].Z;
+	}
+}
+
+void StoreVector3Stream_NEON(const float* x, const float* y, const float* z, Vector3* output, size_t count)
+{
+	if (count == 0)
+		return;
+
+	float* dst = output->GetPtr();
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4, dst += 12)
+	{
+		float32x4x3_t xyz;
+		xyz.val[0] = vld1q_f32(x + i);
+		xyz.val[1] = vld1q_f32(y + i);
+		xyz.val[2] = vld1q_f32(z + i);
+		vst3q_f32(dst, xyz);
+	}
+
+	for (; i < count; ++i)
+	{
+		output[i].X = x[i];
+		output[i].Y = y[i];
+		output[i].Z = z[i];
+	}
+}
+
+namespace
+{
+	template<bool kTranslate>
+	SIMD_FORCE_INLINE void TransformPointsStream(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output)
+	{
+		const float* m = matrix.m_data;
+		const float32x4_t c0 = vld1q_f32(m + 0);
+		const float32x4_t c1 = vld1q_f32(m + 4);
+		const float32x4_t c2 = vld1q_f32(m + 8);
+		const float32x4_t tx = vdupq_n_f32(kTranslate ? m[12] : 0.0F);
+		const float32x4_t ty = vdupq_n_f32(kTranslate ? m[13] : 0.0F);
+		const float32x4_t tz = vdupq_n_f32(kTranslate ? m[14] : 0.0F);
+
+		const float* inX = input.GetX();
+		const float* inY = input.GetY();
+		const float* inZ = input.GetZ();
+		float* outX = output.GetX();
+		float* outY = output.GetY();
+		float* outZ = output.GetZ();
+
+		for (size_t i = 0, count = input.GetPaddedCount(); i < count; i += 4)
+		{
+			const float32x4_t x = vld1q_f32(inX + i);
+			const float32x4_t y = vld1q_f32(inY + i);
+			const float32x4_t z = vld1q_f32(inZ + i);
+
+			float32x4_t rx = vmlaq_lane_f32(tx, x, vget_low_f32(c0), 0);
+			float32x4_t ry = vmlaq_lane_f32(ty, x, vget_low_f32(c0), 1);
+			float32x4_t rz = vmlaq_lane_f32(tz, x, vget_high_f32(c0), 0);
+			rx = vmlaq_lane_f32(rx, y, vget_low_f32(c1), 0);
+			ry = vmlaq_lane_f32(ry, y, vget_low_f32(c1), 1);
+			rz = vmlaq_lane_f32(rz, y, vget_high_f32(c1), 0);
+			rx = vmlaq_lane_f32(rx, z, vget_low_f32(c2), 0);
+			ry = vmlaq_lane_f32(ry, z, vget_low_f32(c2), 1);
+			rz = vmlaq_lane_f32(rz, z, vget_high_f32(c2), 0);
+
+			vst1q_f32(outX + i, rx);
+			vst1q_f32(outY + i, ry);
+			vst1q_f32(outZ + i, rz);
+		}
+	}
+}
+
+void TransformPointsStream3x3_NEON(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output)
+{
+	TransformPointsStream<false>(matrix, input, output);
+}
+
+void TransformPointsStream3x4_NEON(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output)
+{
+	TransformPointsStream<true>(matrix, input, output);
+}
+
+/* QuaternionStream */
+
+namespace
+{
+	// 1/sqrt, estimate plus two Newton-Raphson steps
+	SIMD_FORCE_INLINE float32x4_t InvSqrt(float32x4_t v)
+	{
+		float32x4_t r = vrsqrteq_f32(v);
+		r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(v, r), r));
+		r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(v, r), r));
+		return r;
+	}
+
+	SIMD_FORCE_INLINE void NormalizeSafe(float32x4_t& x, float32x4_t& y, float32x4_t& z, float32x4_t& w, float32x4_t sqrEpsilon)
+	{
+		float32x4_t sqrMag = vmulq_f32(x, x);
+		sqrMag = vmlaq_f32(sqrMag, y, y);
+		sqrMag = vmlaq_f32(sqrMag, z, z);
+		sqrMag = vmlaq_f32(sqrMag, w, w);
+		const uint32x4_t valid = vcgeq_f32(sqrMag, sqrEpsilon);
+		const float32x4_t invMag = vbslq_f32(valid, InvSqrt(sqrMag), vdupq_n_f32(0.0F));
+		x = vmulq_f32(x, invMag);
+		y = vmulq_f32(y, invMag);
+		z = vmulq_f32(z, invMag);
+		w = vbslq_f32(valid, vmulq_f32(w, invMag), vdupq_n_f32(1.0F));
+	}
+
+	SIMD_FORCE_INLINE float32x4_t LoadWeights(const float* t, size_t tStep, size_t i, size_t count)
+	{
+		if (tStep == 0)
+			return vdupq_n_f32(*t);
+		if (i + 4 <= count)
+			return vld1q_f32(t + i);
+
+		float tail[4] = { 0.0F, 0.0F, 0.0F, 0.0F };
+		for (size_t k = i; k < count; ++k)
+			tail[k - i] = t[k];
+		return vld1q_f32(tail);
+	}
+
+	SIMD_FORCE_INLINE void Transpose(float32x4_t v[4])
+	{
+		const float32x4x2_t t01 = vtrnq_f32(v[0], v[1]);
+		const float32x4x2_t t23 = vtrnq_f32(v[2], v[3]);
+		v[0] = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+		v[1] = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+		v[2] = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+		v[3] = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+	}
+
+	//see the SSE2 StoreMatrices
+	SIMD_FORCE_INLINE void StoreMatrices(float32x4_t columns[4][4], Matrix4x4* output, size_t n)
+	{
+		for (int c = 0; c < 4; ++c)
+			Transpose(columns[c]);
+
+		for (size_t j = 0; j < n; ++j)
+		{
+			vst1q_f32(output[j].m_data + 0, columns[0][j]);
+			vst1q_f32(output[j].m_data + 4, columns[1][j]);
+			vst1q_f32(output[j].m_data + 8, columns[2][j]);
+			vst1q_f32(output[j].m_data + 12, columns[3][j]);
+		}
+	}
+}
+
+void SlerpQuaternionStream_NEON(const QuaternionStream& a, const QuaternionStream& b, const float* t, size_t tStep, QuaternionStream& output)
+{
+	const float32x4_t sqrEpsilon = vdupq_n_f32(Vector3::epsilon * Vector3::epsilon);
+	const uint32x4_t signMask = vdupq_n_u32(0x80000000U);
+	const float32x4_t one = vdupq_n_f32(1.0F);
+	const float32x4_t half = vdupq_n_f32(0.5F);
+
+	const size_t count = a.GetCount();
+	for (size_t i = 0, paddedCount = a.GetPaddedCount(); i < paddedCount; i += 4)
+	{
+		const float32x4_t ax = vld1q_f32(a.GetX() + i), ay = vld1q_f32(a.GetY() + i), az = vld1q_f32(a.GetZ() + i), aw = vld1q_f32(a.GetW() + i);
+		const float32x4_t bx = vld1q_f32(b.GetX() + i), by = vld1q_f32(b.GetY() + i), bz = vld1q_f32(b.GetZ() + i), bw = vld1q_f32(b.GetW() + i);
+		const float32x4_t ti = LoadWeights(t, tStep, i, count);
+
+		float32x4_t cosAngle = vmulq_f32(ax, bx);
+		cosAngle = vmlaq_f32(cosAngle, ay, by);
+		cosAngle = vmlaq_f32(cosAngle, az, bz);
+		cosAngle = vmlaq_f32(cosAngle, aw, bw);
+		const float32x4_t d = vabsq_f32(cosAngle);
+
+		float32x4_t k0 = vmlsq_f32(vdupq_n_f32(3.55645F), d, vdupq_n_f32(1.43519F));
+		k0 = vmlaq_f32(vdupq_n_f32(-3.2452F), d, k0);
+		k0 = vmlaq_f32(vdupq_n_f32(1.0904F), d, k0);
+		float32x4_t k1 = vmlaq_f32(vdupq_n_f32(-1.06021F), d, vdupq_n_f32(0.215638F));
+		k1 = vmlaq_f32(vdupq_n_f32(0.848013F), d, k1);
+
+		const float32x4_t tc = vsubq_f32(ti, half);
+		const float32x4_t k = vmlaq_f32(k1, vmulq_f32(k0, tc), tc);
+		const float32x4_t ot = vmlaq_f32(ti, vmulq_f32(vmulq_f32(ti, tc), vsubq_f32(ti, one)), k);
+		const float32x4_t lt = vsubq_f32(one, ot);
+		const float32x4_t rt = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(ot), vandq_u32(vreinterpretq_u32_f32(cosAngle), signMask)));
+
+		float32x4_t x = vmlaq_f32(vmulq_f32(ax, lt), bx, rt);
+		float32x4_t y = vmlaq_f32(vmulq_f32(ay, lt), by, rt);
+		float32x4_t z = vmlaq_f32(vmulq_f32(az, lt), bz, rt);
+		float32x4_t w = vmlaq_f32(vmulq_f32(aw, lt), bw, rt);
+		NormalizeSafe(x, y, z, w, sqrEpsilon);
+
+		vst1q_f32(output.GetX() + i, x);
+		vst1q_f32(output.GetY() + i, y);
+		vst1q_f32(output.GetZ() + i, z);
+		vst1q_f32(output.GetW() + i, w);
+	}
+}
+
+void NormalizeQuaternionStream_NEON(const QuaternionStream& input, QuaternionStream& output)
+{
+	const float32x4_t sqrEpsilon = vdupq_n_f32(Vector3::epsilon * Vector3::epsilon);
+
+	for (size_t i = 0, paddedCount = input.GetPaddedCount(); i < paddedCount; i += 4)
+	{
+		float32x4_t x = vld1q_f32(input.GetX() + i);
+		float32x4_t y = vld1q_f32(input.GetY() + i);
+		float32x4_t z = vld1q_f32(input.GetZ() + i);
+		float32x4_t w = vld1q_f32(input.GetW() + i);
+		NormalizeSafe(x, y, z, w, sqrEpsilon);
+		vst1q_f32(output.GetX() + i, x);
+		vst1q_f32(output.GetY() + i, y);
+		vst1q_f32(output.GetZ() + i, z);
+		vst1q_f32(output.GetW() + i, w);
+	}
+}
+
+void SetTRSStream_NEON(const Vector3Stream* pos, const QuaternionStream& rot, const Vector3Stream* scale, Matrix4x4* output)
+{
+	const float32x4_t zero = vdupq_n_f32(0.0F);
+	const float32x4_t one = vdupq_n_f32(1.0F);
+
+	for (size_t i = 0, count = rot.GetCount(); i < count; i += 4)
+	{
+		const float32x4_t qx = vld1q_f32(rot.GetX() + i), qy = vld1q_f32(rot.GetY() + i);
+		const float32x4_t qz = vld1q_f32(rot.GetZ() + i), qw = vld1q_f32(rot.GetW() + i);
+
+		const float32x4_t x = vaddq_f32(qx, qx), y = vaddq_f32(qy, qy), z = vaddq_f32(qz, qz);
+		const float32x4_t xx = vmulq_f32(qx, x), yy = vmulq_f32(qy, y), zz = vmulq_f32(qz, z);
+		const float32x4_t xy = vmulq_f32(qx, y), xz = vmulq_f32(qx, z), yz = vmulq_f32(qy, z);
+		const float32x4_t wx = vmulq_f32(qw, x), wy = vmulq_f32(qw, y), wz = vmulq_f32(qw, z);
+
+		const float32x4_t sx = scale ? vld1q_f32(scale->GetX() + i) : one;
+		const float32x4_t sy = scale ? vld1q_f32(scale->GetY() + i) : one;
+		const float32x4_t sz = scale ? vld1q_f32(scale->GetZ() + i) : one;
+
+		float32x4_t columns[4][4];
+		columns[0][0] = vmulq_f32(vsubq_f32(one, vaddq_f32(yy, zz)), sx);
+		columns[0][1] = vmulq_f32(vaddq_f32(xy, wz), sx);
+		columns[0][2] = vmulq_f32(vsubq_f32(xz, wy), sx);
+		columns[0][3] = zero;
+
+		columns[1][0] = vmulq_f32(vsubq_f32(xy, wz), sy);
+		columns[1][1] = vmulq_f32(vsubq_f32(one, vaddq_f32(xx, zz)), sy);
+		columns[1][2] = vmulq_f32(vaddq_f32(yz, wx), sy);
+		columns[1][3] = zero;
+
+		columns[2][0] = vmulq_f32(vaddq_f32(xz, wy), sz);
+		columns[2][1] = vmulq_f32(vsubq_f32(yz, wx), sz);
+		columns[2][2] = vmulq_f32(vsubq_f32(one, vaddq_f32(xx, yy)), sz);
+		columns[2][3] = zero;
+
+		columns[3][0] = pos ? vld1q_f32(pos->GetX() + i) : zero;
+		columns[3][1] = pos ? vld1q_f32(pos->GetY() + i) : zero;
+		columns[3][2] = pos ? vld1q_f32(pos->GetZ() + i) : zero;
+		columns[3][3] = one;
+
+		StoreMatrices(columns, output + i, count - i < 4 ? count - i : 4);
+	}
+}
+
+/* Affine inverses, see the SSE2 versions */
+
+namespace
+{
+	SIMD_FORCE_INLINE void Transpose3x3(float32x4_t& c0, float32x4_t& c1, float32x4_t& c2)
+	{
+		float32x4_t v[4] = { c0, c1, c2, vdupq_n_f32(0.0F) };
+		Transpose(v);
+		c0 = v[0];
+		c1 = v[1];
+		c2 = v[2];
+	}
+
+	SIMD_FORCE_INLINE float32x4_t InverseTranslation(float32x4_t c0, float32x4_t c1, float32x4_t c2, float32x4_t t)
+	{
+		float32x4_t r = vmulq_lane_f32(c0, vget_low_f32(t), 0);
+		r = vmlaq_lane_f32(r, c1, vget_low_f32(t), 1);
+		r = vmlaq_lane_f32(r, c2, vget_high_f32(t), 0);
+		const float32x4_t e3 = vsetq_lane_f32(1.0F, vdupq_n_f32(0.0F), 3);
+		return vsubq_f32(e3, r);
+	}
+
+	// y z x w
+	SIMD_FORCE_INLINE float32x4_t RotateYZX(float32x4_t v)
+	{
+		const float32x4_t yzwx = vextq_f32(v, v, 1);
+		return vsetq_lane_f32(vgetq_lane_f32(v, 3), vsetq_lane_f32(vgetq_lane_f32(v, 0), yzwx, 2), 3);
+	}
+
+	SIMD_FORCE_INLINE float32x4_t Cross(float32x4_t a, float32x4_t b)
+	{
+		// a x b = (a * b.yzx - a.yzx * b).yzx
+		const float32x4_t c = vmlsq_f32(vmulq_f32(a, RotateYZX(b)), RotateYZX(a), b);
+		return RotateYZX(c);
+	}
+
+	SIMD_FORCE_INLINE void InvertScaledTranspose(const float* m, float* out, float invSqrScale)
+	{
+		float32x4_t c0 = vmulq_n_f32(vld1q_f32(m + 0), invSqrScale);
+		float32x4_t c1 = vmulq_n_f32(vld1q_f32(m + 4), invSqrScale);
+		float32x4_t c2 = vmulq_n_f32(vld1q_f32(m + 8), invSqrScale);
+		const float32x4_t t = vld1q_f32(m + 12);
+		Transpose3x3(c0, c1, c2);
+
+		vst1q_f32(out + 0, c0);
+		vst1q_f32(out + 4, c1);
+		vst1q_f32(out + 8, c2);
+		vst1q_f32(out + 12, InverseTranslation(c0, c1, c2, t));
+	}
+}
+
+void InvertMatrix4x4_Rigid_NEON(const float* m, float* out)
+{
+	InvertScaledTranspose(m, out, 1.0F);
+}
+
+void InvertMatrix4x4_UniformScale_NEON(const float* m, float* out)
+{
+	InvertScaledTranspose(m, out, 1.0F / (m[0] * m[0] + m[1] * m[1] + m[2] * m[2]));
+}
+
+bool InvertMatrix4x4_Affine_NEON(const float* m, float* out)
+{
+	const float32x4_t a = vld1q_f32(m + 0);
+	const float32x4_t b = vld1q_f32(m + 4);
+	const float32x4_t c = vld1q_f32(m + 8);
+	const float32x4_t t = vld1q_f32(m + 12);
+
+	float32x4_t r0 = Cross(b, c);
+	float32x4_t r1 = Cross(c, a);
+	float32x4_t r2 = Cross(a, b);
+
+	const float32x4_t d = vmulq_f32(a, r0);
+	const float det = vgetq_lane_f32(d, 0) + vgetq_lane_f32(d, 1) + vgetq_lane_f32(d, 2);
+	if (det * det < 1e-25F)
+	{
+		const float32x4_t zero = vdupq_n_f32(0.0F);
+		vst1q_f32(out + 0, zero);
+		vst1q_f32(out + 4, zero);
+		vst1q_f32(out + 8, zero);
+		vst1q_f32(out + 12, zero);
+		return false;
+	}
+
+	const float invDet = 1.0F / det;
+	r0 = vmulq_n_f32(r0, invDet);
+	r1 = vmulq_n_f32(r1, invDet);
+	r2 = vmulq_n_f32(r2, invDet);
+	Transpose3x3(r0, r1, r2);
+
+	vst1q_f32(out + 0, r0);
+	vst1q_f32(out + 4, r1);
+	vst1q_f32(out + 8, r2);
+	vst1q_f32(out + 12, InverseTranslation(r0, r1, r2, t));
+	return true;
+}
+
+bool InvertMatrixArray4x4Affine_NEON(const Matrix4x4* a, Matrix4x4* res, size_t count)
+{
+	const float32x4_t zero = vdupq_n_f32(0.0F);
+	const float32x4_t one = vdupq_n_f32(1.0F);
+	const float32x4_t minSqrDet = vdupq_n_f32(1e-25F);
+	bool invertible = true;
+
+	for (size_t i = 0; i < count; i += 4)
+	{
+		const size_t n = count - i < 4 ? count - i : 4;
+
+		Matrix4x4 tail[4];
+		const Matrix4x4* src = a + i;
+		if (n < 4)
+		{
+			for (size_t j = 0; j < 4; ++j)
+				CopyMatrix4x4(j < n ? src[j].m_data : Matrix4x4::identity.m_data, tail[j].m_data);
+			src = tail;
+		}
+
+		float32x4_t m[4][4];
+		for (int c = 0; c < 4; ++c)
+		{
+			for (int j = 0; j < 4; ++j)
+				m[c][j] = vld1q_f32(src[j].m_data + c * 4);
+			Transpose(m[c]);
+		}
+
+		const float32x4_t ax = m[0][0], ay = m[0][1], az = m[0][2];
+		const float32x4_t bx = m[1][0], by = m[1][1], bz = m[1][2];
+		const float32x4_t cx = m[2][0], cy = m[2][1], cz = m[2][2];
+		const float32x4_t tx = m[3][0], ty = m[3][1], tz = m[3][2];
+
+		const float32x4_t r00 = vmlsq_f32(vmulq_f32(by, cz), bz, cy);
+		const float32x4_t r01 = vmlsq_f32(vmulq_f32(bz, cx), bx, cz);
+		const float32x4_t r02 = vmlsq_f32(vmulq_f32(bx, cy), by, cx);
+		const float32x4_t r10 = vmlsq_f32(vmulq_f32(cy, az), cz, ay);
+		const float32x4_t r11 = vmlsq_f32(vmulq_f32(cz, ax), cx, az);
+		const float32x4_t r12 = vmlsq_f32(vmulq_f32(cx, ay), cy, ax);
+		const float32x4_t r20 = vmlsq_f32(vmulq_f32(ay, bz), az, by);
+		const float32x4_t r21 = vmlsq_f32(vmulq_f32(az, bx), ax, bz);
+		const float32x4_t r22 = vmlsq_f32(vmulq_f32(ax, by), ay, bx);
+
+		const float32x4_t det = vmlaq_f32(vmlaq_f32(vmulq_f32(ax, r00), ay, r01), az, r02);
+		const uint32x4_t valid = vcgeq_f32(vmulq_f32(det, det), minSqrDet);
+		uint32_t validLanes[4];
+		vst1q_u32(validLanes, valid);
+		for (size_t j = 0; j < n; ++j)
+			invertible &= validLanes[j] != 0;
+
+		//reciprocal estimate plus two Newton-Raphson steps
+		float32x4_t invDet = vrecpeq_f32(det);
+		invDet = vmulq_f32(invDet, vrecpsq_f32(det, invDet));
+		invDet = vmulq_f32(invDet, vrecpsq_f32(det, invDet));
+		invDet = vbslq_f32(valid, invDet, zero);
+
+		float32x4_t o[4][4];
+		o[0][0] = vmulq_f32(r00, invDet); o[0][1] = vmulq_f32(r10, invDet); o[0][2] = vmulq_f32(r20, invDet); o[0][3] = zero;
+		o[1][0] = vmulq_f32(r01, invDet); o[1][1] = vmulq_f32(r11, invDet); o[1][2] = vmulq_f32(r21, invDet); o[1][3] = zero;
+		o[2][0] = vmulq_f32(r02, invDet); o[2][1] = vmulq_f32(r12, invDet); o[2][2] = vmulq_f32(r22, invDet); o[2][3] = zero;
+		for (int k = 0; k < 3; ++k)
+			o[3][k] = vnegq_f32(vmlaq_f32(vmlaq_f32(vmulq_f32(o[0][k], tx), o[1][k], ty), o[2][k], tz));
+		o[3][3] = vbslq_f32(valid, one, zero);
+
+		StoreMatrices(o, res + i, n);
+	}
+	return invertible;
+}
+
+/* Culling, see the SSE2 versions */
+
+namespace
+{
+	struct CullPlanes
+	{
+		float32x4_t nx[Frustum::kPlaneCount], ny[Frustum::kPlaneCount], nz[Frustum::kPlaneCount], d[Frustum::kPlaneCount];
+		float32x4_t ax[Frustum::kPlaneCount], ay[Frustum::kPlaneCount], az[Frustum::kPlaneCount];
+
+		explicit CullPlanes(const Vector4* planes)
+		{
+			for (int p = 0; p < Frustum::kPlaneCount; ++p)
+			{
+				nx[p] = vdupq_n_f32(planes[p].X);
+				ny[p] = vdupq_n_f32(planes[p].Y);
+				nz[p] = vdupq_n_f32(planes[p].Z);
+				d[p] = vdupq_n_f32(planes[p].W);
+				ax[p] = vabsq_f32(nx[p]);
+				ay[p] = vabsq_f32(ny[p]);
+				az[p] = vabsq_f32(nz[p]);
+			}
+		}
+	};
+
+	SIMD_FORCE_INLINE float32x4_t LoadRadii(const float* radii, size_t i, size_t count)
+	{
+		if (i + 4 <= count)
+			return vld1q_f32(radii + i);
+
+		float tail[4] = { 0.0F, 0.0F, 0.0F, 0.0F };
+		for (size_t k = i; k < count; ++k)
+			tail[k - i] = radii[k];
+		return vld1q_f32(tail);
+	}
+
+	//NEON has no movemask
+	SIMD_FORCE_INLINE uint32_t MoveMask(uint32x4_t v)
+	{
+		static const uint32_t kLaneBits[4] = { 1, 2, 4, 8 };
+		const uint32x4_t bits = vandq_u32(v, vld1q_u32(kLaneBits));
+		const uint32x2_t sum = vpadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+		return vget_lane_u32(vpadd_u32(sum, sum), 0);
+	}
+}
+
+size_t CullAABBStream_NEON(const Vector4* planes, const Vector3Stream& centers, const Vector3Stream& extents, uint32_t* mask, uint32_t* indices)
+{
+	const CullPlanes p(planes);
+	const float32x4_t zero = vdupq_n_f32(0.0F);
+	const size_t count = centers.GetCount();
+
+	CullWriter writer(mask, indices);
+	for (size_t i = 0; i < count; i += 4)
+	{
+		const float32x4_t cx = vld1q_f32(centers.GetX() + i), cy = vld1q_f32(centers.GetY() + i), cz = vld1q_f32(centers.GetZ() + i);
+		const float32x4_t ex = vld1q_f32(extents.GetX() + i), ey = vld1q_f32(extents.GetY() + i), ez = vld1q_f32(extents.GetZ() + i);
+
+		uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFU);
+		for (int k = 0; k < Frustum::kPlaneCount; ++k)
+		{
+			float32x4_t sum = vmlaq_f32(p.d[k], p.nx[k], cx);
+			sum = vmlaq_f32(sum, p.ny[k], cy);
+			sum = vmlaq_f32(sum, p.nz[k], cz);
+			sum = vmlaq_f32(sum, p.ax[k], ex);
+			sum = vmlaq_f32(sum, p.ay[k], ey);
+			sum = vmlaq_f32(sum, p.az[k], ez);
+			inside = vandq_u32(inside, vcgeq_f32(sum, zero));
+		}
+
+		writer.Write(MoveMask(inside) & CullWriter::LaneMask(i, count, 4), i, 4);
+	}
+	return writer.Finish();
+}
+
+size_t CullSphereStream_NEON(const Vector4* planes, const Vector3Stream& centers, const float* radii, uint32_t* mask, uint32_t* indices)
+{
+	const CullPlanes p(planes);
+	const float32x4_t zero = vdupq_n_f32(0.0F);
+	const size_t count = centers.GetCount();
+
+	CullWriter writer(mask, indices);
+	for (size_t i = 0; i < count; i += 4)
+	{
+		const float32x4_t cx = vld1q_f32(centers.GetX() + i), cy = vld1q_f32(centers.GetY() + i), cz = vld1q_f32(centers.GetZ() + i);
+		const float32x4_t r = LoadRadii(radii, i, count);
+
+		uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFU);
+		for (int k = 0; k < Frustum::kPlaneCount; ++k)
+		{
+			float32x4_t sum = vaddq_f32(p.d[k], r);
+			sum = vmlaq_f32(sum, p.nx[k], cx);
+			sum = vmlaq_f32(sum, p.ny[k], cy);
+			sum = vmlaq_f32(sum, p.nz[k], cz);
+			inside = vandq_u32(inside, vcgeq_f32(sum, zero));
+		}
+
+		writer.Write(MoveMask(inside) & CullWriter::LaneMask(i, count, 4), i, 4);
+	}
+	return writer.Finish();
+}
+
+#endif
@@ -0,0 +1,657 @@
+#include "Core/Math/Simd/MathKernels.h"
+
+#if SIMD_X86
+
+#include <emmintrin.h>
+#include "Core/Math/Matrix4x4.h"
+#include "Core/Math/Vector3Stream.h"
+#include "Core/Math/QuaternionStream.h"
+#include "Core/Math/Frustum.h"
+#include "Core/Math/Simd/CullWriter.h"
+
+/*
+	SSE2 kernels, baseline for every x86 CPU we run on
+	Matrices are column major and not guaranteed to be 16 byte aligned
+*/
+
+#define SPLAT(v, i) _mm_shuffle_ps((v), (v), _MM_SHUFFLE(i, i, i, i))
+
+namespace
+{
+	struct Columns
+	{
+		__m128 c0, c1, c2, c3;
+	};
+
+	SIMD_FORCE_INLINE Columns LoadColumns(const float* m)
+	{
+		Columns res;
+		res.c0 = _mm_loadu_ps(m + 0);
+		res.c1 = _mm_loadu_ps(m + 4);
+		res.c2 = _mm_loadu_ps(m + 8);
+		res.c3 = _mm_loadu_ps(m + 12);
+		return res;
+	}
+
+	SIMD_FORCE_INLINE void StoreColumns(const Columns& m, float* out)
+	{
+		_mm_storeu_ps(out + 0, m.c0);
+		_mm_storeu_ps(out + 4, m.c1);
+		_mm_storeu_ps(out + 8, m.c2);
+		_mm_storeu_ps(out + 12, m.c3);
+	}
+
+	// lhs * column
+	SIMD_FORCE_INLINE __m128 Combine(const Columns& lhs, __m128 column)
+	{
+		__m128 r0 = _mm_mul_ps(lhs.c0, SPLAT(column, 0));
+		__m128 r1 = _mm_mul_ps(lhs.c1, SPLAT(column, 1));
+		r0 = _mm_add_ps(r0, _mm_mul_ps(lhs.c2, SPLAT(column, 2)));
+		r1 = _mm_add_ps(r1, _mm_mul_ps(lhs.c3, SPLAT(column, 3)));
+		return _mm_add_ps(r0, r1);
+	}
+
+	SIMD_FORCE_INLINE Columns Multiply(const Columns& lhs, const Columns& rhs)
+	{
+		Columns res;
+		res.c0 = Combine(lhs, rhs.c0);
+		res.c1 = Combine(lhs, rhs.c1);
+		res.c2 = Combine(lhs, rhs.c2);
+		res.c3 = Combine(lhs, rhs.c3);
+		return res;
+	}
+
+	SIMD_FORCE_INLINE void Prefetch(const Matrix4x4* m)
+	{
+		_mm_prefetch(reinterpret_cast<const char*>(m), _MM_HINT_T0);
+	}
+}
+
+void MultiplyMatrices4x4_SSE2(const Matrix4x4* __restrict lhs, const Matrix4x4* __restrict rhs, Matrix4x4* __restrict res)
+{
+	StoreColumns(Multiply(LoadColumns(lhs->m_data), LoadColumns(rhs->m_data)), res->m_data);
+}
+
+void MultiplyMatrixArray4x4_SSE2(const Matrix4x4* __restrict a, const Matrix4x4* __restrict b, Matrix4x4* __restrict res, size_t count)
+{
+	size_t i = 0;
+
+	//two independent products per iteration to hide the add latency
+	for (; i + 2 <= count; i += 2)
+	{
+		Prefetch(a + i + SIMD_PREFETCH_DISTANCE);
+		Prefetch(b + i + SIMD_PREFETCH_DISTANCE);
+
+		Columns a0 = LoadColumns(a[i].m_data);
+		Columns a1 = LoadColumns(a[i + 1].m_data);
+		Columns r0 = Multiply(a0, LoadColumns(b[i].m_data));
+		Columns r1 = Multiply(a1, LoadColumns(b[i + 1].m_data));
+		StoreColumns(r0, res[i].m_data);
+		StoreColumns(r1, res[i + 1].m_data);
+	}
+
+	for (; i < count; ++i)
+		StoreColumns(Multiply(LoadColumns(a[i].m_data), LoadColumns(b[i].m_data)), res[i].m_data);
+}
+
+void MultiplyMatrixArrayWithBase4x4_SSE2(const Matrix4x4* __restrict base,
+	const Matrix4x4* __restrict a, const Matrix4x4* __restrict b, Matrix4x4* __restrict res, size_t count)
+{
+	//base stays in registers, BASE * A[i] never goes to memory
+	const Columns baseColumns = LoadColumns(base->m_data);
+	size_t i = 0;
+
+	for (; i + 2 <= count; i += 2)
+	{
+		Prefetch(a + i + SIMD_PREFETCH_DISTANCE);
+		Prefetch(b + i + SIMD_PREFETCH_DISTANCE);
+
+		Columns t0 = Multiply(baseColumns, LoadColumns(a[i].m_data));
+		Columns t1 = Multiply(baseColumns, LoadColumns(a[i + 1].m_data));
+		StoreColumns(Multiply(t0, LoadColumns(b[i].m_data)), res[i].m_data);
+		StoreColumns(Multiply(t1, LoadColumns(b[i + 1].m_data)), res[i + 1].m_data);
+	}
+
+	for (; i < count; ++i)
+	{
+		Columns t = Multiply(baseColumns, LoadColumns(a[i].m_data));
+		StoreColumns(Multiply(t, LoadColumns(b[i].m_data)), res[i].m_data);
+	}
+}
+
+/* Vector3Stream */
+
+// a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+void LoadVector3Stream_SSE2(const Vector3* input, float* x, float* y, float* z, size_t count)
+{
+	//an empty stream may have no array at all
+	if (count == 0)
+		return;
+
+	const float* src = input->GetPtr();
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4, src += 12)
+	{
+		const __m128 a = _mm_loadu_ps(src + 0);
+		const __m128 b = _mm_loadu_ps(src + 4);
+		const __m128 c = _mm_loadu_ps(src + 8);
+
+		const __m128 x03 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0));		//x0 x0 x1 x1
+		const __m128 x23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));		//x2 x2 x3 x3
+		const __m128 y01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));		//y0 y0 y1 y1
+		const __m128 y23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));		//y2 y2 y3 y3
+		const __m128 z01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));		//z0 z0 z1 z1
+		const __m128 z23 = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));		//z2 z2 z3 z3
+
+		_mm_storeu_ps(x + i, _mm_shuffle_ps(x03, x23, _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(y + i, _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(z + i, _mm_shuffle_ps(z01, z23, _MM_SHUFFLE(2, 0, 2, 0)));
+	}
+
+	for (; i < count; ++i)
+	{
+		x[i] = input[i].X;
+		y[i] = input[i].Y;
+		z[i] = input[i].Z;
+	}
+}
+
+void StoreVector3Stream_SSE2(const float* x, const float* y, const float* z, Vector3* output, size_t count)
+{
+	if (count == 0)
+		return;
+
+	float* dst = output->GetPtr();
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4, dst += 12)
+	{
+		const __m128 vx = _mm_loadu_ps(x + i);
+		const __m128 vy = _mm_loadu_ps(y + i);
+		const __m128 vz = _mm_loadu_ps(z + i);
+
+		const __m128 x0y0 = _mm_shuffle_ps(vx, vy, _MM_SHUFFLE(0, 0, 0, 0));	//x0 x0 y0 y0
+		const __m128 z0x1 = _mm_shuffle_ps(vz, vx, _MM_SHUFFLE(1, 1, 0, 0));	//z0 z0 x1 x1
+		const __m128 y1z1 = _mm_shuffle_ps(vy, vz, _MM_SHUFFLE(1, 1, 1, 1));	//y1 y1 z1 z1
+		const __m128 x2y2 = _mm_shuffle_ps(vx, vy, _MM_SHUFFLE(2, 2, 2, 2));	//x2 x2 y2 y2
+		const __m128 z2x3 = _mm_shuffle_ps(vz, vx, _MM_SHUFFLE(3, 3, 2, 2));	//z2 z2 x3 x3
+		const __m128 y3z3 = _mm_shuffle_ps(vy, vz, _MM_SHUFFLE(3, 3, 3, 3));	//y3 y3 z3 z3
+
+		_mm_storeu_ps(dst + 0, _mm_shuffle_ps(x0y0, z0x1, _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(dst + 4, _mm_shuffle_ps(y1z1, x2y2, _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(dst + 8, _mm_shuffle_ps(z2x3, y3z3, _MM_SHUFFLE(2, 0, 2, 0)));
+	}
+
+	for (; i < count; ++i)
+	{
+		output[i].X = x[i];
+		output[i].Y = y[i];
+		output[i].Z = z[i];
+	}
+}
+
+namespace
+{
+	template<bool kTranslate>
+	SIMD_FORCE_INLINE void TransformPointsStream(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output)
+	{
+		const float* m = matrix.m_data;
+		const __m128 m0 = _mm_set1_ps(m[0]), m1 = _mm_set1_ps(m[1]), m2 = _mm_set1_ps(m[2]);
+		const __m128 m4 = _mm_set1_ps(m[4]), m5 = _mm_set1_ps(m[5]), m6 = _mm_set1_ps(m[6]);
+		const __m128 m8 = _mm_set1_ps(m[8]), m9 = _mm_set1_ps(m[9]), m10 = _mm_set1_ps(m[10]);
+		const __m128 tx = _mm_set1_ps(kTranslate ? m[12] : 0.0F);
+		const __m128 ty = _mm_set1_ps(kTranslate ? m[13] : 0.0F);
+		const __m128 tz = _mm_set1_ps(kTranslate ? m[14] : 0.0F);
+
+		const float* inX = input.GetX();
+		const float* inY = input.GetY();
+		const float* inZ = input.GetZ();
+		float* outX = output.GetX();
+		float* outY = output.GetY();
+		float* outZ = output.GetZ();
+
+		for (size_t i = 0, count = input.GetPaddedCount(); i < count; i += 4)
+		{
+			const __m128 x = _mm_load_ps(inX + i);
+			const __m128 y = _mm_load_ps(inY + i);
+			const __m128 z = _mm_load_ps(inZ + i);
+
+			__m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m4, y)), _mm_add_ps(_mm_mul_ps(m8, z), tx));
+			__m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, x), _mm_mul_ps(m5, y)), _mm_add_ps(_mm_mul_ps(m9, z), ty));
+			__m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m2, x), _mm_mul_ps(m6, y)), _mm_add_ps(_mm_mul_ps(m10, z), tz));
+
+			_mm_store_ps(outX + i, rx);
+			_mm_store_ps(outY + i, ry);
+			_mm_store_ps(outZ + i, rz);
+		}
+	}
+}
+
+void TransformPointsStream3x3_SSE2(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output)
+{
+	TransformPointsStream<false>(matrix, input, output);
+}
+
+void TransformPointsStream3x4_SSE2(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output)
+{
+	TransformPointsStream<true>(matrix, input, output);
+}
+
+/* QuaternionStream */
+
+namespace
+{
+	SIMD_FORCE_INLINE __m128 Abs(__m128 v)
+	{
+		return _mm_andnot_ps(_mm_set1_ps(-0.0F), v);
+	}
+
+	// 1/sqrt, estimate plus one Newton-Raphson step
+	SIMD_FORCE_INLINE __m128 InvSqrt(__m128 v)
+	{
+		const __m128 r = _mm_rsqrt_ps(v);
+		const __m128 rvr = _mm_mul_ps(_mm_mul_ps(v, r), r);
+		return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5F), r), _mm_sub_ps(_mm_set1_ps(3.0F), rvr));
+	}
+
+	//identity where |q| is near zero
+	SIMD_FORCE_INLINE void NormalizeSafe(__m128& x, __m128& y, __m128& z, __m128& w, __m128 sqrEpsilon)
+	{
+		const __m128 sqrMag = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+		const __m128 valid = _mm_cmpge_ps(sqrMag, sqrEpsilon);
+		const __m128 invMag = _mm_and_ps(InvSqrt(sqrMag), valid);
+		x = _mm_mul_ps(x, invMag);
+		y = _mm_mul_ps(y, invMag);
+		z = _mm_mul_ps(z, invMag);
+		//-0 * invMag keeps the sign, mask w before merging in the 1
+		w = _mm_or_ps(_mm_and_ps(_mm_mul_ps(w, invMag), valid), _mm_andnot_ps(valid, _mm_set1_ps(1.0F)));
+	}
+
+	//t for elements [i, i + 4), zero past count
+	SIMD_FORCE_INLINE __m128 LoadWeights(const float* t, size_t tStep, size_t i, size_t count)
+	{
+		if (tStep == 0)
+			return _mm_set1_ps(*t);
+		if (i + 4 <= count)
+			return _mm_loadu_ps(t + i);
+
+		float tail[4] = { 0.0F, 0.0F, 0.0F, 0.0F };
+		for (size_t k = i; k < count; ++k)
+			tail[k - i] = t[k];
+		return _mm_loadu_ps(tail);
+	}
+
+	//columns[c][e] holds element e of column c for 4 matrices. Transposed in
+	//place to columns[c][j] = column c of matrix j, only the first n are written
+	SIMD_FORCE_INLINE void StoreMatrices(__m128 columns[4][4], Matrix4x4* output, size_t n)
+	{
+		for (int c = 0; c < 4; ++c)
+			_MM_TRANSPOSE4_PS(columns[c][0], columns[c][1], columns[c][2], columns[c][3]);
+
+		for (size_t j = 0; j < n; ++j)
+		{
+			_mm_storeu_ps(output[j].m_data + 0, columns[0][j]);
+			_mm_storeu_ps(output[j].m_data + 4, columns[1][j]);
+			_mm_storeu_ps(output[j].m_data + 8, columns[2][j]);
+			_mm_storeu_ps(output[j].m_data + 12, columns[3][j]);
+		}
+	}
+}
+
+void SlerpQuaternionStream_SSE2(const QuaternionStream& a, const QuaternionStream& b, const float* t, size_t tStep, QuaternionStream& output)
+{
+	const __m128 sqrEpsilon = _mm_set1_ps(Vector3::epsilon * Vector3::epsilon);
+	const __m128 signMask = _mm_set1_ps(-0.0F);
+	const __m128 one = _mm_set1_ps(1.0F);
+	const __m128 half = _mm_set1_ps(0.5F);
+
+	const size_t count = a.GetCount();
+	for (size_t i = 0, paddedCount = a.GetPaddedCount(); i < paddedCount; i += 4)
+	{
+		const __m128 ax = _mm_load_ps(a.GetX() + i), ay = _mm_load_ps(a.GetY() + i), az = _mm_load_ps(a.GetZ() + i), aw = _mm_load_ps(a.GetW() + i);
+		const __m128 bx = _mm_load_ps(b.GetX() + i), by = _mm_load_ps(b.GetY() + i), bz = _mm_load_ps(b.GetZ() + i), bw = _mm_load_ps(b.GetW() + i);
+		const __m128 ti = LoadWeights(t, tStep, i, count);
+
+		const __m128 cosAngle = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+		const __m128 d = Abs(cosAngle);
+
+		//see SlerpQuaternionStream_Scalar
+		__m128 k0 = _mm_sub_ps(_mm_set1_ps(3.55645F), _mm_mul_ps(d, _mm_set1_ps(1.43519F)));
+		k0 = _mm_add_ps(_mm_set1_ps(-3.2452F), _mm_mul_ps(d, k0));
+		k0 = _mm_add_ps(_mm_set1_ps(1.0904F), _mm_mul_ps(d, k0));
+		__m128 k1 = _mm_add_ps(_mm_set1_ps(-1.06021F), _mm_mul_ps(d, _mm_set1_ps(0.215638F)));
+		k1 = _mm_add_ps(_mm_set1_ps(0.848013F), _mm_mul_ps(d, k1));
+
+		const __m128 tc = _mm_sub_ps(ti, half);
+		const __m128 k = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(k0, tc), tc), k1);
+		const __m128 ot = _mm_add_ps(ti, _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(ti, tc), _mm_sub_ps(ti, one)), k));
+		const __m128 lt = _mm_sub_ps(one, ot);
+		const __m128 rt = _mm_xor_ps(ot, _mm_and_ps(cosAngle, signMask));
+
+		__m128 x = _mm_add_ps(_mm_mul_ps(ax, lt), _mm_mul_ps(bx, rt));
+		__m128 y = _mm_add_ps(_mm_mul_ps(ay, lt), _mm_mul_ps(by, rt));
+		__m128 z = _mm_add_ps(_mm_mul_ps(az, lt), _mm_mul_ps(bz, rt));
+		__m128 w = _mm_add_ps(_mm_mul_ps(aw, lt), _mm_mul_ps(bw, rt));
+		NormalizeSafe(x, y, z, w, sqrEpsilon);
+
+		_mm_store_ps(output.GetX() + i, x);
+		_mm_store_ps(output.GetY() + i, y);
+		_mm_store_ps(output.GetZ() + i, z);
+		_mm_store_ps(output.GetW() + i, w);
+	}
+}
+
+void NormalizeQuaternionStream_SSE2(const QuaternionStream& input, QuaternionStream& output)
+{
+	const __m128 sqrEpsilon = _mm_set1_ps(Vector3::epsilon * Vector3::epsilon);
+
+	for (size_t i = 0, paddedCount = input.GetPaddedCount(); i < paddedCount; i += 4)
+	{
+		__m128 x = _mm_load_ps(input.GetX() + i);
+		__m128 y = _mm_load_ps(input.GetY() + i);
+		__m128 z = _mm_load_ps(input.GetZ() + i);
+		__m128 w = _mm_load_ps(input.GetW() + i);
+		NormalizeSafe(x, y, z, w, sqrEpsilon);
+		_mm_store_ps(output.GetX() + i, x);
+		_mm_store_ps(output.GetY() + i, y);
+		_mm_store_ps(output.GetZ() + i, z);
+		_mm_store_ps(output.GetW() + i, w);
+	}
+}
+
+void SetTRSStream_SSE2(const Vector3Stream* pos, const QuaternionStream& rot, const Vector3Stream* scale, Matrix4x4* output)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0F);
+
+	for (size_t i = 0, count = rot.GetCount(); i < count; i += 4)
+	{
+		const __m128 qx = _mm_load_ps(rot.GetX() + i), qy = _mm_load_ps(rot.GetY() + i);
+		const __m128 qz = _mm_load_ps(rot.GetZ() + i), qw = _mm_load_ps(rot.GetW() + i);
+
+		// same products as QuaternionToMatrix
+		const __m128 x = _mm_add_ps(qx, qx), y = _mm_add_ps(qy, qy), z = _mm_add_ps(qz, qz);
+		const __m128 xx = _mm_mul_ps(qx, x), yy = _mm_mul_ps(qy, y), zz = _mm_mul_ps(qz, z);
+		const __m128 xy = _mm_mul_ps(qx, y), xz = _mm_mul_ps(qx, z), yz = _mm_mul_ps(qy, z);
+		const __m128 wx = _mm_mul_ps(qw, x), wy = _mm_mul_ps(qw, y), wz = _mm_mul_ps(qw, z);
+
+		const __m128 sx = scale ? _mm_load_ps(scale->GetX() + i) : one;
+		const __m128 sy = scale ? _mm_load_ps(scale->GetY() + i) : one;
+		const __m128 sz = scale ? _mm_load_ps(scale->GetZ() + i) : one;
+
+		__m128 columns[4][4];
+		columns[0][0] = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx);
+		columns[0][1] = _mm_mul_ps(_mm_add_ps(xy, wz), sx);
+		columns[0][2] = _mm_mul_ps(_mm_sub_ps(xz, wy), sx);
+		columns[0][3] = zero;
+
+		columns[1][0] = _mm_mul_ps(_mm_sub_ps(xy, wz), sy);
+		columns[1][1] = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy);
+		columns[1][2] = _mm_mul_ps(_mm_add_ps(yz, wx), sy);
+		columns[1][3] = zero;
+
+		columns[2][0] = _mm_mul_ps(_mm_add_ps(xz, wy), sz);
+		columns[2][1] = _mm_mul_ps(_mm_sub_ps(yz, wx), sz);
+		columns[2][2] = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz);
+		columns[2][3] = zero;
+
+		columns[3][0] = pos ? _mm_load_ps(pos->GetX() + i) : zero;
+		columns[3][1] = pos ? _mm_load_ps(pos->GetY() + i) : zero;
+		columns[3][2] = pos ? _mm_load_ps(pos->GetZ() + i) : zero;
+		columns[3][3] = one;
+
+		StoreMatrices(columns, output + i, count - i < 4 ? count - i : 4);
+	}
+}
+
+/* Affine inverses */
+
+namespace
+{
+	//columns of the upper 3x3 -> its rows, w lanes zero
+	SIMD_FORCE_INLINE void Transpose3x3(__m128& c0, __m128& c1, __m128& c2)
+	{
+		__m128 c3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+	}
+
+	// (0, 0, 0, 1) - (c0 * t.x + c1 * t.y + c2 * t.z)
+	SIMD_FORCE_INLINE __m128 InverseTranslation(__m128 c0, __m128 c1, __m128 c2, __m128 t)
+	{
+		__m128 r = _mm_mul_ps(c0, SPLAT(t, 0));
+		r = _mm_add_ps(r, _mm_mul_ps(c1, SPLAT(t, 1)));
+		r = _mm_add_ps(r, _mm_mul_ps(c2, SPLAT(t, 2)));
+		return _mm_sub_ps(_mm_set_ps(1.0F, 0.0F, 0.0F, 0.0F), r);
+	}
+
+	SIMD_FORCE_INLINE __m128 Cross(__m128 a, __m128 b)
+	{
+		const __m128 ayzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 azxy = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+		const __m128 byzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 bzxy = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+		return _mm_sub_ps(_mm_mul_ps(ayzx, bzxy), _mm_mul_ps(azxy, byzx));
+	}
+
+	SIMD_FORCE_INLINE void InvertScaledTranspose(const float* m, float* out, __m128 invSqrScale)
+	{
+		__m128 c0 = _mm_mul_ps(_mm_loadu_ps(m + 0), invSqrScale);
+		__m128 c1 = _mm_mul_ps(_mm_loadu_ps(m + 4), invSqrScale);
+		__m128 c2 = _mm_mul_ps(_mm_loadu_ps(m + 8), invSqrScale);
+		const __m128 t = _mm_loadu_ps(m + 12);
+		Transpose3x3(c0, c1, c2);
+
+		_mm_storeu_ps(out + 0, c0);
+		_mm_storeu_ps(out + 4, c1);
+		_mm_storeu_ps(out + 8, c2);
+		_mm_storeu_ps(out + 12, InverseTranslation(c0, c1, c2, t));
+	}
+}
+
+void InvertMatrix4x4_Rigid_SSE2(const float* m, float* out)
+{
+	InvertScaledTranspose(m, out, _mm_set1_ps(1.0F));
+}
+
+void InvertMatrix4x4_UniformScale_SSE2(const float* m, float* out)
+{
+	InvertScaledTranspose(m, out, _mm_set1_ps(1.0F / (m[0] * m[0] + m[1] * m[1] + m[2] * m[2])));
+}
+
+bool InvertMatrix4x4_Affine_SSE2(const float* m, float* out)
+{
+	const __m128 a = _mm_loadu_ps(m + 0);
+	const __m128 b = _mm_loadu_ps(m + 4);
+	const __m128 c = _mm_loadu_ps(m + 8);
+	const __m128 t = _mm_loadu_ps(m + 12);
+
+	//rows of the inverse before dividing by the determinant, w lanes are zero
+	__m128 r0 = Cross(b, c);
+	__m128 r1 = Cross(c, a);
+	__m128 r2 = Cross(a, b);
+
+	const __m128 d = _mm_mul_ps(a, r0);
+	const float det = _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(d, SPLAT(d, 1)), SPLAT(d, 2)));
+	if (det * det < 1e-25F)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		_mm_storeu_ps(out + 0, zero);
+		_mm_storeu_ps(out + 4, zero);
+		_mm_storeu_ps(out + 8, zero);
+		_mm_storeu_ps(out + 12, zero);
+		return false;
+	}
+
+	const __m128 invDet = _mm_set1_ps(1.0F / det);
+	r0 = _mm_mul_ps(r0, invDet);
+	r1 = _mm_mul_ps(r1, invDet);
+	r2 = _mm_mul_ps(r2, invDet);
+	Transpose3x3(r0, r1, r2);
+
+	_mm_storeu_ps(out + 0, r0);
+	_mm_storeu_ps(out + 4, r1);
+	_mm_storeu_ps(out + 8, r2);
+	_mm_storeu_ps(out + 12, InverseTranslation(r0, r1, r2, t));
+	return true;
+}
+
+// 4 matrices per iteration in SoA form, lane j of every register belongs to matrix j
+bool InvertMatrixArray4x4Affine_SSE2(const Matrix4x4* a, Matrix4x4* res, size_t count)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0F);
+	const __m128 minSqrDet = _mm_set1_ps(1e-25F);
+	bool invertible = true;
+
+	for (size_t i = 0; i < count; i += 4)
+	{
+		const size_t n = count - i < 4 ? count - i : 4;
+
+		//the tail is padded with identities
+		Matrix4x4 tail[4];
+		const Matrix4x4* src = a + i;
+		if (n < 4)
+		{
+			for (size_t j = 0; j < 4; ++j)
+				CopyMatrix4x4(j < n ? src[j].m_data : Matrix4x4::identity.m_data, tail[j].m_data);
+			src = tail;
+		}
+
+		__m128 m[4][4];
+		for (int c = 0; c < 4; ++c)
+		{
+			m[c][0] = _mm_loadu_ps(src[0].m_data + c * 4);
+			m[c][1] = _mm_loadu_ps(src[1].m_data + c * 4);
+			m[c][2] = _mm_loadu_ps(src[2].m_data + c * 4);
+			m[c][3] = _mm_loadu_ps(src[3].m_data + c * 4);
+			_MM_TRANSPOSE4_PS(m[c][0], m[c][1], m[c][2], m[c][3]);
+		}
+
+		const __m128 ax = m[0][0], ay = m[0][1], az = m[0][2];
+		const __m128 bx = m[1][0], by = m[1][1], bz = m[1][2];
+		const __m128 cx = m[2][0], cy = m[2][1], cz = m[2][2];
+		const __m128 tx = m[3][0], ty = m[3][1], tz = m[3][2];
+
+		//see InvertMatrix4x4_Affine_Scalar
+		const __m128 r00 = _mm_sub_ps(_mm_mul_ps(by, cz), _mm_mul_ps(bz, cy));
+		const __m128 r01 = _mm_sub_ps(_mm_mul_ps(bz, cx), _mm_mul_ps(bx, cz));
+		const __m128 r02 = _mm_sub_ps(_mm_mul_ps(bx, cy), _mm_mul_ps(by, cx));
+		const __m128 r10 = _mm_sub_ps(_mm_mul_ps(cy, az), _mm_mul_ps(cz, ay));
+		const __m128 r11 = _mm_sub_ps(_mm_mul_ps(cz, ax), _mm_mul_ps(cx, az));
+		const __m128 r12 = _mm_sub_ps(_mm_mul_ps(cx, ay), _mm_mul_ps(cy, ax));
+		const __m128 r20 = _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by));
+		const __m128 r21 = _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz));
+		const __m128 r22 = _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx));
+
+		const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, r00), _mm_mul_ps(ay, r01)), _mm_mul_ps(az, r02));
+		const __m128 valid = _mm_cmpge_ps(_mm_mul_ps(det, det), minSqrDet);
+		invertible &= (_mm_movemask_ps(valid) & ((1 << n) - 1)) == (1 << n) - 1;
+
+		//singular lanes end up all zero, like the scalar version
+		const __m128 invDet = _mm_and_ps(_mm_div_ps(one, det), valid);
+
+		__m128 o[4][4];
+		o[0][0] = _mm_mul_ps(r00, invDet); o[0][1] = _mm_mul_ps(r10, invDet); o[0][2] = _mm_mul_ps(r20, invDet); o[0][3] = zero;
+		o[1][0] = _mm_mul_ps(r01, invDet); o[1][1] = _mm_mul_ps(r11, invDet); o[1][2] = _mm_mul_ps(r21, invDet); o[1][3] = zero;
+		o[2][0] = _mm_mul_ps(r02, invDet); o[2][1] = _mm_mul_ps(r12, invDet); o[2][2] = _mm_mul_ps(r22, invDet); o[2][3] = zero;
+		for (int k = 0; k < 3; ++k)
+		{
+			const __m128 p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(o[0][k], tx), _mm_mul_ps(o[1][k], ty)), _mm_mul_ps(o[2][k], tz));
+			o[3][k] = _mm_sub_ps(zero, p);
+		}
+		o[3][3] = _mm_and_ps(one, valid);
+
+		StoreMatrices(o, res + i, n);
+	}
+	return invertible;
+}
+
+/* Culling */
+
+namespace
+{
+	//plane components splatted once per call
+	struct CullPlanes
+	{
+		__m128 nx[Frustum::kPlaneCount], ny[Frustum::kPlaneCount], nz[Frustum::kPlaneCount], d[Frustum::kPlaneCount];
+		__m128 ax[Frustum::kPlaneCount], ay[Frustum::kPlaneCount], az[Frustum::kPlaneCount];
+
+		explicit CullPlanes(const Vector4* planes)
+		{
+			for (int p = 0; p < Frustum::kPlaneCount; ++p)
+			{
+				nx[p] = _mm_set1_ps(planes[p].X);
+				ny[p] = _mm_set1_ps(planes[p].Y);
+				nz[p] = _mm_set1_ps(planes[p].Z);
+				d[p] = _mm_set1_ps(planes[p].W);
+				ax[p] = _mm_set1_ps(fabsf(planes[p].X));
+				ay[p] = _mm_set1_ps(fabsf(planes[p].Y));
+				az[p] = _mm_set1_ps(fabsf(planes[p].Z));
+			}
+		}
+	};
+
+	SIMD_FORCE_INLINE __m128 LoadRadii(const float* radii, size_t i, size_t count)
+	{
+		if (i + 4 <= count)
+			return _mm_loadu_ps(radii + i);
+
+		float tail[4] = { 0.0F, 0.0F, 0.0F, 0.0F };
+		for (size_t k = i; k < count; ++k)
+			tail[k - i] = radii[k];
+		return _mm_loadu_ps(tail);
+	}
+}
+
+size_t CullAABBStream_SSE2(const Vector4* planes, const Vector3Stream& centers, const Vector3Stream& extents, uint32_t* mask, uint32_t* indices)
+{
+	const CullPlanes p(planes);
+	const __m128 zero = _mm_setzero_ps();
+	const size_t count = centers.GetCount();
+
+	CullWriter writer(mask, indices);
+	for (size_t i = 0; i < count; i += 4)
+	{
+		const __m128 cx = _mm_load_ps(centers.GetX() + i), cy = _mm_load_ps(centers.GetY() + i), cz = _mm_load_ps(centers.GetZ() + i);
+		const __m128 ex = _mm_load_ps(extents.GetX() + i), ey = _mm_load_ps(extents.GetY() + i), ez = _mm_load_ps(extents.GetZ() + i);
+
+		// distance + projected extents >= 0 on every plane
+		__m128 inside = _mm_cmpeq_ps(zero, zero);
+		for (int k = 0; k < Frustum::kPlaneCount; ++k)
+		{
+			const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p.nx[k], cx), _mm_mul_ps(p.ny[k], cy)), _mm_add_ps(_mm_mul_ps(p.nz[k], cz), p.d[k]));
+			const __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p.ax[k], ex), _mm_mul_ps(p.ay[k], ey)), _mm_mul_ps(p.az[k], ez));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+		}
+
+		writer.Write(_mm_movemask_ps(inside) & CullWriter::LaneMask(i, count, 4), i, 4);
+	}
+	return writer.Finish();
+}
+
+size_t CullSphereStream_SSE2(const Vector4* planes, const Vector3Stream& centers, const float* radii, uint32_t* mask, uint32_t* indices)
+{
+	const CullPlanes p(planes);
+	const __m128 zero = _mm_setzero_ps();
+	const size_t count = centers.GetCount();
+
+	CullWriter writer(mask, indices);
+	for (size_t i = 0; i < count; i += 4)
+	{
+		const __m128 cx = _mm_load_ps(centers.GetX() + i), cy = _mm_load_ps(centers.GetY() + i), cz = _mm_load_ps(centers.GetZ() + i);
+		const __m128 r = LoadRadii(radii, i, count);
+
+		__m128 inside = _mm_cmpeq_ps(zero, zero);
+		for (int k = 0; k < Frustum::kPlaneCount; ++k)
+		{
+			const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p.nx[k], cx), _mm_mul_ps(p.ny[k], cy)), _mm_add_ps(_mm_mul_ps(p.nz[k], cz), p.d[k]));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, r), zero));
+		}
+
+		writer.Write(_mm_movemask_ps(inside) & CullWriter::LaneMask(i, count, 4), i, 4);
+	}
+	return writer.Finish();
+}
+
+#undef SPLAT
+
+#endif
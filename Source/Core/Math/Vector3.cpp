@@ -1,6 +1,6 @@
-#include "Core\Math\Vector3.h"
-#include "Core\Math\Matrix3x3.h"
-
+#include <limits>
+#include "Core/Math/Vector3.h"
+#include "Core/Math/Matrix3x3.h"
 
 const float     Vector3::epsilon = 0.00001F;
 const float     Vector3::infinity = std::numeric_limits<float>::infinity();
@@ -17,135 +17,9 @@ Vector3 Vector3::Scale(const Vector3& lhs, const Vector3& rhs)
 	return Vector3(lhs.X * rhs.X, lhs.Y * rhs.Y, lhs.Z * rhs.Z);
 }
 
-inline float Vector3::Dot(const Vector3 & lhs, const Vector3 & rhs)
-{
-	return lhs.X * rhs.X + lhs.Y * rhs.Y + lhs.Z * rhs.Z;
-}
-
-inline float Vector3::Volume(const Vector3 & inV)
-{
-	return inV.X * inV.Y * inV.Z;
-}
-
-inline Vector3 Vector3::Inverse(const Vector3 & inVec)
-{
-	return Vector3(1.0F / inVec.X, 1.0F / inVec.Y, 1.0F / inVec.Z);
-}
-
-inline float Vector3::SqrLength(const Vector3 & inV)
-{
-	return Dot(inV, inV);
-}
-
-inline float Vector3::Length(const Vector3 & inV)
-{
-	return sqrt(Dot(inV, inV));
-}
-
-inline float Vector3::Angle(const Vector3 & lhs, const Vector3 & rhs)
-{
-	return ::acos(std::min(1.0f, std::max(-1.0f, Dot(lhs, rhs) / (Length(lhs) * Length(rhs)))));
-}
-
-inline Vector3 Vector3::Normalize(const Vector3 & inV)
-{
-	return inV / Length(inV);
-}
-
-inline Vector3 Vector3::NormalizeSafe(const Vector3 & inV, const Vector3 & defaultV)
-{
-	float mag = Length(inV);
-	if (mag > Vector3::epsilon)
-		return inV / mag;
-	else
-		return defaultV;
-}
-
 // - Handles zero vector correclty
-inline Vector3 Vector3::NormalizeFast(const Vector3 & inV)
-{
-	float m = SqrLength(inV);
-	// GCC version of __frsqrte:
-	//  static inline double __frsqrte (double x) {
-	//      double y;
-	//      asm ( "frsqrte %0, %1" : /*OUT*/ "=f" (y) : /*IN*/ "f" (x) );
-	//      return y;
-	//  }
-	return inV * FastInvSqrt(m);
-}
-
 // - low precision normalize
 // - nan for zero vector
-inline Vector3 Vector3::NormalizeFastest(const Vector3 & inV)
-{
-	float m = SqrLength(inV);
-	// GCC version of __frsqrte:
-	//  static inline double __frsqrte (double x) {
-	//      double y;
-	//      asm ( "frsqrte %0, %1" : /*OUT*/ "=f" (y) : /*IN*/ "f" (x) );
-	//      return y;
-	//  }
-	return inV * FastestInvSqrt(m);
-}
-
-inline Vector3 Vector3::Cross(const Vector3 & lhs, const Vector3 & rhs)
-{
-	return Vector3(
-		lhs.Y * rhs.Z - lhs.Z * rhs.Y,
-		lhs.Z * rhs.X - lhs.X * rhs.Z,
-		lhs.X * rhs.Y - lhs.Y * rhs.X);
-}
-
-inline Vector3 Vector3::ReflectVector(const Vector3 & inDirection, const Vector3 & inNormal)
-{
-	return -2.0F * Dot(inNormal, inDirection) * inNormal + inDirection;
-}
-
-inline Vector3 Vector3::Lerp(const Vector3 & from, const Vector3 & to, float t)
-{
-	return to * t + from * (1.0F - t);
-}
-
-inline Vector3 Vector3::Min(const Vector3 & lhs, const Vector3 & rhs)
-{
-	return Vector3(std::min(lhs.X, rhs.X), std::min(lhs.Y, rhs.Y), std::min(lhs.Z, rhs.Z));
-}
-
-inline Vector3 Vector3::Max(const Vector3 & lhs, const Vector3 & rhs)
-{
-	return Vector3(std::max(lhs.X, rhs.X), std::max(lhs.Y, rhs.Y), std::max(lhs.Z, rhs.Z));
-}
-
-inline Vector3 Vector3::Project(const Vector3 & v1, const Vector3 & v2)
-{
-	return v2 * Dot(v1, v2) / Dot(v2, v2);
-}
-
-inline Vector3 Vector3::Abs(const Vector3 & v)
-{
-	return Vector3(abs(v.X), abs(v.Y), abs(v.Z));
-}
-
-inline bool Vector3::IsFinite(const Vector3 & f)
-{
-	return isfinite(f.X) & isfinite(f.Y) & isfinite(f.Z);
-}
-
-inline Vector3 Vector3::Round(const Vector3 & a, float factor)
-{
-	return Vector3(roundf(a.X / factor) * factor, roundf(a.Y / factor) * factor, roundf(a.Z / factor) * factor);
-}
-
-inline bool Vector3::CompareApproximately(const Vector3 & inV0, const Vector3 & inV1, const float inMaxDist)
-{
-	return SqrLength(inV1 - inV0) <= inMaxDist * inMaxDist;
-}
-
-inline bool Vector3::IsNormalized(const Vector3 & vec, float epsilon)
-{
-	return ::CompareApproximately(SqrLength(vec), 1.0f, epsilon);
-}
-
 void Vector3::OrthoNormalizeFast(Vector3* inU, Vector3* inV, Vector3* inW)
 {
 	// compute u0
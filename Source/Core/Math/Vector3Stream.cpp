@@ -0,0 +1,184 @@
+#include <cstring>
+#include <new>
+#include "Core/Math/Vector3Stream.h"
+#include "Core/Math/Matrix4x4.h"
+#include "Core/Math/Simd/MathKernels.h"
+#include "Core/Misc/Memory.h"
+#include "Core/Misc/Utility.h"
+
+Vector3Stream::Vector3Stream(size_t count) : m_data(nullptr), m_count(0), m_paddedCount(0), m_capacity(0)
+{
+	Resize(count);
+}
+
+Vector3Stream::Vector3Stream(const Vector3Stream& other) : m_data(nullptr), m_count(0), m_paddedCount(0), m_capacity(0)
+{
+	*this = other;
+}
+
+Vector3Stream::~Vector3Stream(void)
+{
+	AlignedFree(m_data);
+}
+
+Vector3Stream& Vector3Stream::operator=(const Vector3Stream& other)
+{
+	if (this == &other)
+		return *this;
+
+	Resize(other.m_count);
+	const size_t bytes = m_paddedCount * sizeof(float);
+	if (bytes != 0)
+	{
+		memcpy(GetX(), other.GetX(), bytes);
+		memcpy(GetY(), other.GetY(), bytes);
+		memcpy(GetZ(), other.GetZ(), bytes);
+	}
+	return *this;
+}
+
+void Vector3Stream::Resize(size_t count)
+{
+	const size_t paddedCount = AlignSize(count, kWidth);
+
+	if (paddedCount > m_capacity)
+	{
+		float* data = static_cast<float*>(AlignedMalloc(paddedCount * 3 * sizeof(float), kAlignment));
+		if (data == nullptr)
+			throw std::bad_alloc();
+		memset(data, 0, paddedCount * 3 * sizeof(float));
+		if (m_count != 0)
+		{
+			memcpy(data, GetX(), m_count * sizeof(float));
+			memcpy(data + paddedCount, GetY(), m_count * sizeof(float));
+			memcpy(data + paddedCount * 2, GetZ(), m_count * sizeof(float));
+		}
+		AlignedFree(m_data);
+		m_data = data;
+		m_capacity = paddedCount;
+	}
+	else if (count > m_count)
+	{
+		//grown inside the allocation, old tail may hold stale or scratch values
+		memset(GetX() + m_count, 0, (paddedCount - m_count) * sizeof(float));
+		memset(GetY() + m_count, 0, (paddedCount - m_count) * sizeof(float));
+		memset(GetZ() + m_count, 0, (paddedCount - m_count) * sizeof(float));
+	}
+
+	m_count = count;
+	m_paddedCount = paddedCount;
+}
+
+void Vector3Stream::Load(const Vector3* input, size_t inStride, size_t count)
+{
+	Resize(count);
+
+	if (inStride == sizeof(Vector3))
+	{
+		gMathKernels.loadVector3Stream(input, GetX(), GetY(), GetZ(), count);
+		return;
+	}
+
+	float* x = GetX();
+	float* y = GetY();
+	float* z = GetZ();
+	for (size_t i = 0; i < count; ++i, input = Stride(input, inStride))
+	{
+		x[i] = input->X;
+		y[i] = input->Y;
+		z[i] = input->Z;
+	}
+}
+
+void Vector3Stream::Store(Vector3* output, size_t outStride) const
+{
+	if (outStride == sizeof(Vector3))
+	{
+		gMathKernels.storeVector3Stream(GetX(), GetY(), GetZ(), output, m_count);
+		return;
+	}
+
+	const float* x = GetX();
+	const float* y = GetY();
+	const float* z = GetZ();
+	for (size_t i = 0; i < m_count; ++i, output = Stride(output, outStride))
+	{
+		output->X = x[i];
+		output->Y = y[i];
+		output->Z = z[i];
+	}
+}
+
+void TransformPoints3x3(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output)
+{
+	if (&input != &output)
+		output.Resize(input.GetCount());
+	gMathKernels.transformPointsStream3x3(matrix, input, output);
+}
+
+void TransformPoints3x4(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output)
+{
+	if (&input != &output)
+		output.Resize(input.GetCount());
+	gMathKernels.transformPointsStream3x4(matrix, input, output);
+}
+
+/* Scalar reference kernels */
+
+void LoadVector3Stream_Scalar(const Vector3* input, float* x, float* y, float* z, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		x[i] = input[i].X;
+		y[i] = input[i].Y;
+		z[i] = input[i].Z;
+	}
+}
+
+void StoreVector3Stream_Scalar(const float* x, const float* y, const float* z, Vector3* output, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		output[i].X = x[i];
+		output[i].Y = y[i];
+		output[i].Z = z[i];
+	}
+}
+
+void TransformPointsStream3x3_Scalar(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output)
+{
+	const float* m = matrix.m_data;
+	const float* inX = input.GetX();
+	const float* inY = input.GetY();
+	const float* inZ = input.GetZ();
+	float* outX = output.GetX();
+	float* outY = output.GetY();
+	float* outZ = output.GetZ();
+
+	for (size_t i = 0, count = input.GetCount(); i < count; ++i)
+	{
+		const float x = inX[i], y = inY[i], z = inZ[i];
+		outX[i] = m[0] * x + m[4] * y + m[8] * z;
+		outY[i] = m[1] * x + m[5] * y + m[9] * z;
+		outZ[i] = m[2] * x + m[6] * y + m[10] * z;
+	}
+}
+
+void TransformPointsStream3x4_Scalar(const Matrix4x4& matrix, const Vector3Stream& input, Vector3Stream& output)
+{
+	const float* m = matrix.m_data;
+	const float* inX = input.GetX();
+	const float* inY = input.GetY();
+	const float* inZ = input.GetZ();
+	float* outX = output.GetX();
+	float* outY = output.GetY();
+	float* outZ = output.GetZ();
+
+	for (size_t i = 0, count = input.GetCount(); i < count; ++i)
+	{
+		const float x = inX[i], y = inY[i], z = inZ[i];
+		outX[i] = m[0] * x + m[4] * y + m[8] * z + m[12];
+		outY[i] = m[1] * x + m[5] * y + m[9] * z + m[13];
+		outZ[i] = m[2] * x + m[6] * y + m[10] * z + m[14];
+	}
+}
@@ -0,0 +1,86 @@
+#include "Core/Misc/CPUInfo.h"
+#include "Core/Math/Simd/SimdConfig.h"
+
+#if SIMD_X86
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+namespace
+{
+#if SIMD_X86
+	void CPUID(int leaf, int subLeaf, unsigned int regs[4])
+	{
+#if defined(_MSC_VER)
+		__cpuidex(reinterpret_cast<int*>(regs), leaf, subLeaf);
+#else
+		__cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+	}
+
+	//XCR0, which register states the OS saves on context switch
+	unsigned long long XGetBV(void)
+	{
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		unsigned int eax, edx;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+	}
+#endif
+
+	CPUFeature DetectCPUFeatures(void)
+	{
+		CPUFeature features = kCPUFeatureNone;
+
+#if SIMD_X86
+		unsigned int regs[4] = {};
+		CPUID(0, 0, regs);
+		const unsigned int maxLeaf = regs[0];
+		if (maxLeaf < 1)
+			return features;
+
+		CPUID(1, 0, regs);
+		const unsigned int ecx = regs[2];
+		const unsigned int edx = regs[3];
+
+		if (edx & (1u << 26))
+			features |= kCPUFeatureSSE2;
+		if (ecx & (1u << 19))
+			features |= kCPUFeatureSSE41;
+
+		//AVX needs both the CPU bit and the OS saving YMM (OSXSAVE + XCR0 bits 1,2)
+		const bool osxsave = (ecx & (1u << 27)) != 0;
+		const bool ymmSaved = osxsave && (XGetBV() & 0x6) == 0x6;
+		if (ymmSaved && (ecx & (1u << 28)))
+		{
+			features |= kCPUFeatureAVX;
+			if (ecx & (1u << 12))
+				features |= kCPUFeatureFMA;
+
+			if (maxLeaf >= 7)
+			{
+				CPUID(7, 0, regs);
+				if (regs[1] & (1u << 5))
+					features |= kCPUFeatureAVX2;
+			}
+		}
+#elif SIMD_NEON
+		//NEON is mandatory on every target we compile a NEON path for
+		features |= kCPUFeatureNEON;
+#endif
+
+		return features;
+	}
+}
+
+CPUFeature GetCPUFeatures(void)
+{
+	static const CPUFeature features = DetectCPUFeatures();
+	return features;
+}
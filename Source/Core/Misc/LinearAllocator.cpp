@@ -0,0 +1,116 @@
+#include <atomic>
+#include <algorithm>
+
+#include "Core\Misc\LinearAllocator.h"
+#include "Core\Misc\Memory.h"
+
+namespace
+{
+	//a whole cache line for the block, pages for its growth
+	const size_t kBlockAlignment = 64;
+	const size_t kGrowAlignment = 4096;
+
+	thread_local LinearAllocator sScratchStack(ScratchScope::kStackSize, "Scratch");
+	std::atomic<size_t> sScratchHighWater(0);
+}
+
+/* LinearAllocator */
+
+LinearAllocator::LinearAllocator(size_t capacity, const char * name)
+	: m_name(name), m_block(nullptr), m_capacity(capacity), m_offset(0), m_overflowBytes(0), m_overflowTotal(0), m_peak(0), m_highWater(0)
+{
+}
+
+LinearAllocator::~LinearAllocator(void)
+{
+	Reset();
+	AlignedFree(m_block);
+}
+
+void * LinearAllocator::Allocate(size_t size, size_t alignment)
+{
+	if (m_block == nullptr && m_capacity > 0)
+		m_block = static_cast<char*>(AlignedMalloc(m_capacity, kBlockAlignment));
+
+	void* result;
+	const size_t offset = AlignSize(m_offset, alignment);
+	if (m_block != nullptr && offset + size <= m_capacity)
+	{
+		result = m_block + offset;
+		m_offset = offset + size;
+	}
+	else
+	{
+		result = AlignedMalloc(std::max<size_t>(size, 1), std::max(alignment, sizeof(void*)));
+		m_overflow.push_back(result);
+		//with the padding it would need in the block
+		m_overflowBytes += size + alignment;
+		++m_overflowTotal;
+	}
+
+	m_peak = std::max(m_peak, GetUsed());
+	m_highWater = std::max(m_highWater, m_peak);
+	return result;
+}
+
+void LinearAllocator::Reset(void)
+{
+	for (size_t i = 0; i < m_overflow.size(); ++i)
+		AlignedFree(m_overflow[i]);
+	m_overflow.clear();
+	m_overflowBytes = 0;
+	m_offset = 0;
+
+	//the block is made again at the next Allocate, big enough for this round
+	if (m_peak > m_capacity)
+	{
+		AlignedFree(m_block);
+		m_block = nullptr;
+		m_capacity = AlignSize(m_peak, kGrowAlignment);
+	}
+	m_peak = 0;
+}
+
+LinearAllocator::Marker LinearAllocator::GetMarker(void) const
+{
+	Marker marker = { m_offset, m_overflow.size(), m_overflowBytes };
+	return marker;
+}
+
+void LinearAllocator::Rewind(const Marker & marker)
+{
+	//back to empty, the block may grow
+	if (marker.m_offset == 0 && marker.m_overflowCount == 0)
+	{
+		Reset();
+		return;
+	}
+
+	for (size_t i = marker.m_overflowCount; i < m_overflow.size(); ++i)
+		AlignedFree(m_overflow[i]);
+	m_overflow.resize(marker.m_overflowCount);
+	m_overflowBytes = marker.m_overflowBytes;
+	m_offset = marker.m_offset;
+}
+
+/* ScratchScope */
+
+ScratchScope::ScratchScope(void) : m_allocator(sScratchStack), m_marker(sScratchStack.GetMarker())
+{
+}
+
+ScratchScope::~ScratchScope(void)
+{
+	m_allocator.Rewind(m_marker);
+
+	const size_t highWater = m_allocator.GetHighWater();
+	size_t current = sScratchHighWater.load(std::memory_order_relaxed);
+	while (highWater > current && !sScratchHighWater.compare_exchange_weak(current, highWater, std::memory_order_relaxed))
+	{
+	}
+}
+
+size_t ScratchScope::GetHighWater(void)
+{
+	return sScratchHighWater.load(std::memory_order_relaxed);
+}
@@ -1,3 +1,6 @@
+#include <direct.h>
+#include <errno.h>
+
 #include "Core\Resource\File.h"
 
 int Resource::ReadTextFile(String fileName, String& fileContent)
@@ -6,7 +9,7 @@ int Resource::ReadTextFile(String fileName, String& fileContent)
 	errno_t result = fopen_s(&fp, fileName.c_str(), "r");
 	if (result)
 	{
-		Debug::Error(StringUtil::format("Can not read file {0}", fileName));
+		Debug::Error("Can not read file {0}", fileName);
 		return -1;
 	}
 
@@ -26,4 +29,43 @@ int Resource::ReadTextFile(String fileName, String& fileContent)
 	delete[] source;
 
 	return len;
+}
+
+int Resource::ReadBinaryFile(String fileName, std::vector<char>& fileContent)
+{
+	FILE *fp = nullptr;
+	errno_t result = fopen_s(&fp, fileName.c_str(), "rb");
+	if (result)
+		return -1;
+
+	fseek(fp, 0, SEEK_END);
+	int len = ftell(fp);
+	rewind(fp);
+	fileContent.resize(len);
+	if (len > 0)
+		len = static_cast<int>(fread(fileContent.data(), 1, len, fp));
+	fileContent.resize(len);
+	fclose(fp);
+
+	return len;
+}
+
+bool Resource::WriteBinaryFile(String fileName, const void* data, size_t size)
+{
+	FILE *fp = nullptr;
+	errno_t result = fopen_s(&fp, fileName.c_str(), "wb");
+	if (result)
+	{
+		Debug::Error("Can not write file {0}", fileName);
+		return false;
+	}
+
+	size_t written = fwrite(data, 1, size, fp);
+	fclose(fp);
+	return written == size;
+}
+
+bool Resource::MakeDirectory(String directory)
+{
+	return _mkdir(directory.c_str()) == 0 || errno == EEXIST;
 }
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include "Core\EngineLoop.h"
 #include "Core\Log\LogManager.h"
 #include "Core\Graphics\GraphicManager.h"
+#include "Core\Job\JobSystem.h"
+#include "Core\Log\Debug.h"
+#include "Core\Misc\LinearAllocator.h"
 
 template<class T>
 void WankelEngine<T>::OnInit()
@@ -12,6 +15,10 @@ void WankelEngine<T>::OnInit()
 	//Platform Independent Init
 	LogManager::Init();
 	m_logManager = LogManager::Instance();
+	OnLogInit();
+
+	//workers on every other hardware thread, this one is thread 0
+	JobSystem::Init();
 
 	GraphicManager::Init();
 	m_graphicManager = GraphicManager::Instance();
@@ -24,8 +31,11 @@ void WankelEngine<T>::OnDestroy()
 	m_engineLoop->Destroy();
 	
 	//Platform Indentdent Destroy
-	LogManager::Destroy();
+	//graphics first, the device logs its destroy, from the render thread too
 	GraphicManager::Destroy();
+	JobSystem::Destroy();
+	Debug::Log("Scratch Stack High Water : {0} Bytes, Stack Size : {1} KB", ScratchScope::GetHighWater(), ScratchScope::kStackSize >> 10);
+	LogManager::Destroy();
 }
 
 template<class T>
@@ -26,6 +26,7 @@ public:
 		Debug::Log("Wankel Init");
 		
 		Shader *shader = new Shader("./Asset/Shader/SimpleMesh");
+		GraphicManager::Instance()->PrepareShader(*shader);
 		m_mat = new Material(*shader);
 
 		m_mesh = new Mesh(Mesh::MeshType::Cube);
@@ -2,6 +2,8 @@
 #include "Platform\Win32\WindowsConsoleLogHandler.h"
 #include "Core\Log\LogManager.h"
 #include "Core\Graphics\OpenGLES\ESDevice.h"
+#include "Core\Graphics\Null\NullGfxDevice.h"
+#include "Core\Graphics\Software\SoftwareGfxDevice.h"
 #include "Platform\Win32\WindowsCommon.h"
 
 #include "../Source/Core/WankelEngine.cpp"
@@ -10,15 +12,25 @@ void WindowsWankelEngine::OnInit(void)
 {
 	WankelEngine::OnInit();
 
-	//Log Handle
-	m_logManager->SetLogHandler(new WindowsConsoleLogHandler());
-
-	//GfxDevice Set Mali OpenGL ES
-	m_graphicManager->SetGfxDevice(new ESDevice(gHWND));
+	//GfxDevice Set Mali OpenGL ES, -nullgfx runs without a GPU, -softgfx rasterizes on the CPU
+	//frames are drawn on this thread, -renderthread plays them one behind on a thread of their own
+	const bool renderThread = strstr(GetCommandLineA(), "-renderthread") != nullptr;
+	if (strstr(GetCommandLineA(), "-nullgfx") != nullptr)
+		m_graphicManager->SetGfxDevice(new NullGfxDevice(), renderThread);
+	else if (strstr(GetCommandLineA(), "-softgfx") != nullptr)
+		m_graphicManager->SetGfxDevice(new SoftwareGfxDevice(800, 800), renderThread);
+	else
+		m_graphicManager->SetGfxDevice(new ESDevice(gHWND), renderThread);
 
 	NotifyEngineInitSuccess
 }
 
+void WindowsWankelEngine::OnLogInit(void)
+{
+	//Log Handle, GraphicManager init already logs
+	m_logManager->SetLogHandler(new WindowsConsoleLogHandler());
+}
+
 void WindowsWankelEngine::OnDestroy(void)
 {
 	//Do self destroy